@@ -9,12 +9,12 @@ urg_t urg;
 long *length_data = NULL;
 int length_data_size;
 int i;
-// \~japanese f[^ X-Y Wnɕϊĕ\
+// \~japanese 距離データを X-Y 座標系に変換して表示する
 // \~english Converts data to X-Y coordinates and displays it
 
 length_data_size = urg_get_distance(&urg, length_data, NULL);
 for (i = 0; i < length_data_size; ++i) {
-    // \~japanese ̋f[^̃WApx߁AX, Y ̍WlvZ
+    // \~japanese その距離データのラジアン角度を求め、X, Y の座標値を計算する
     // \~english Gets the angle in radians for range data, and convert to X-Y coordinates
     double radian;
     long length;
@@ -12,18 +12,18 @@ int skip_step;
 int scan_times;
 int skip_scan;
 int ret;
-// \~japanese vp[^̐ݒ
+// \~japanese 計測パラメータの設定
 // \~english Configures measurement parameters
 
-// \~japanese ZTɑ΂ĐڑsB
-// \~japanese ڑsƁAvp[^̐ݒ͏
+// \~japanese センサに対して接続を行う。
+// \~japanese 接続を行うと、計測パラメータの設定は初期化される
 // \~english Connects to the sensor
 // \~english Upon connection, measurement parameters are initialized (default values)
 ret = urg_open(&urg, URG_SERIAL, connect_device, connect_baudrate);
 // \todo check error code
 
-// \~japanese v͈͂w肷
-// \~japanese ZTʕ 90 [deg] ͈͂̃f[^擾sAXebvԈsȂ
+// \~japanese 計測範囲を指定する
+// \~japanese センサ正面方向の 90 [deg] 範囲のデータ取得を行い、ステップ間引きを行わない例
 // \~english Defines the measurement scope (start, end steps)
 // \~english Defines a measurement scope of 90 [deg] at the front of the sensor, and no step grouping in this example
 first_step = urg_rad2step(&urg, -45);
@@ -32,8 +32,8 @@ skip_step = 0;
 ret = urg_set_scanning_parameter(&urg, first_step, last_step, skip_step);
 // \todo check error code
 
-// \~japanese v񐔂ƌv̊Ԉw肵āAvJn
-// \~japanese 123 ̌vwAXL̊ԈsȂ
+// \~japanese 計測回数と計測の間引きを指定して、計測を開始する
+// \~japanese 123 回の計測を指示し、スキャンの間引きを行わない例
 // \~english Defines the number of scans
 // \~english 123 scans are requested, and no scan skipping in this example
 scan_times = 123;
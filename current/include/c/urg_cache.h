@@ -0,0 +1,195 @@
+#ifndef URG_CACHE_H
+#define URG_CACHE_H
+
+/*!
+  \file
+  \~japanese
+  \brief 接続情報のキャッシュ
+
+  デバイスごとに、前回接続できたボーレート、センサのシリアル番号と PP のパラメータを記録する。再接続のときに、ボーレートの探索と PP の問い合わせを省くために使う。
+
+  \~english
+  \brief Cache of connection information
+
+  Records, per device, the last working baudrate, the serial id of the sensor and the PP parameters. Used on a reconnect to skip the baudrate probing and the PP query.
+  \~
+
+  $Id$
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    URG_CACHE_MAX_ENTRIES = 16, //!< \~japanese 記録するデバイスの最大数  \~english Maximum number of devices recorded
+    URG_CACHE_DEVICE_SIZE = 64, //!< \~japanese デバイス名の最大長  \~english Maximum length of a device name
+    URG_CACHE_SERIAL_ID_SIZE = 32, //!< \~japanese シリアル番号の最大長  \~english Maximum length of a serial id
+};
+
+
+//! \~japanese 1 つのデバイスの接続情報  \~english Connection information of one device
+typedef struct
+{
+    char device[URG_CACHE_DEVICE_SIZE]; //!< \~japanese デバイス名、または IP アドレス  \~english Device name or IP address
+    char serial_id[URG_CACHE_SERIAL_ID_SIZE]; //!< \~japanese センサのシリアル番号  \~english Serial id of the sensor
+    long baudrate;              //!< \~japanese 前回接続できたボーレート [bps]。0 のときは不明  \~english Last working baudrate [bps], 0 if unknown
+
+    int min_distance;           //!< \~japanese PP の DMIN  \~english DMIN of PP
+    int max_distance;           //!< \~japanese PP の DMAX  \~english DMAX of PP
+    int area_resolution;        //!< \~japanese PP の ARES  \~english ARES of PP
+    int first_data_index;       //!< \~japanese PP の AMIN  \~english AMIN of PP
+    int last_data_index;        //!< \~japanese PP の AMAX  \~english AMAX of PP
+    int front_data_index;       //!< \~japanese PP の AFRT  \~english AFRT of PP
+    long scan_usec;             //!< \~japanese PP の SCAN から求めた走査周期 [usec]  \~english Scan period from SCAN of PP [usec]
+} urg_cache_entry_t;
+
+
+//! \~japanese 接続情報のキャッシュ  \~english Cache of connection information
+typedef struct
+{
+    urg_cache_entry_t entries[URG_CACHE_MAX_ENTRIES]; //!< \~japanese 接続情報  \~english Connection information
+    int entry_count;            //!< \~japanese 接続情報の個数  \~english Number of entries
+} urg_cache_t;
+
+
+/*!
+  \~japanese
+  \brief 初期化
+
+  \param[out] cache 接続情報のキャッシュ
+
+  \~english
+  \brief Initialization
+
+  \param[out] cache Cache of connection information
+*/
+extern void urg_cache_initialize(urg_cache_t *cache);
+
+
+/*!
+  \~japanese
+  \brief デバイスの接続情報を探す
+
+  \param[in] cache 接続情報のキャッシュ
+  \param[in] device デバイス名、または IP アドレス
+
+  \return 接続情報。記録されていないときは NULL
+
+  \~english
+  \brief Looks for the connection information of a device
+
+  \param[in] cache Cache of connection information
+  \param[in] device Device name or IP address
+
+  \return Connection information, or NULL if not recorded
+*/
+extern urg_cache_entry_t *urg_cache_find(urg_cache_t *cache,
+                                         const char *device);
+
+
+/*!
+  \~japanese
+  \brief デバイスの接続情報を取得し、無ければ追加する
+
+  追加した接続情報は、デバイス名以外が空になる。記録数が #URG_CACHE_MAX_ENTRIES に達しているときは、最も古く追加した接続情報を取り除く。
+
+  \param[in,out] cache 接続情報のキャッシュ
+  \param[in] device デバイス名、または IP アドレス
+
+  \return 接続情報。device が長過ぎるときは NULL
+
+  \~english
+  \brief Gets the connection information of a device, adding it if missing
+
+  An added entry is empty except for the device name. If #URG_CACHE_MAX_ENTRIES entries are recorded, the entry added first is removed.
+
+  \param[in,out] cache Cache of connection information
+  \param[in] device Device name or IP address
+
+  \return Connection information, or NULL if device is too long
+*/
+extern urg_cache_entry_t *urg_cache_entry(urg_cache_t *cache,
+                                          const char *device);
+
+
+/*!
+  \~japanese
+  \brief 接続情報の値が有効かを返す
+
+  走査周期が正、DMAX が DMIN より大きい、AMIN から AMAX の範囲に AFRT を含む、ARES が正、ボーレートが 0 以上のときに有効とする。
+
+  \param[in] entry 接続情報
+
+  \retval 1 有効
+  \retval 0 無効
+
+  \~english
+  \brief Returns whether the values of an entry are valid
+
+  An entry is valid if the scan period is positive, DMAX is larger than DMIN, AFRT is within AMIN to AMAX, ARES is positive and the baudrate is 0 or more.
+
+  \param[in] entry Connection information
+
+  \retval 1 Valid
+  \retval 0 Invalid
+*/
+extern int urg_cache_is_valid(const urg_cache_entry_t *entry);
+
+
+/*!
+  \~japanese
+  \brief ファイルからの読み込み
+
+  urg_cache_save() で保存したファイルを読み込み、cache の内容を置き換える。形式が合わない行と、urg_cache_is_valid() が無効とする行は読み飛ばす。
+
+  \param[out] cache 接続情報のキャッシュ
+  \param[in] file_name ファイル名
+
+  \retval >=0 読み込んだ接続情報の個数
+  \retval <0 エラー (ファイルを開けない)
+
+  \~english
+  \brief Loads from a file
+
+  Reads a file saved with urg_cache_save() and replaces the contents of cache. Lines in another format and lines that urg_cache_is_valid() rejects are skipped.
+
+  \param[out] cache Cache of connection information
+  \param[in] file_name File name
+
+  \retval >=0 Number of entries read
+  \retval <0 Error (the file cannot be opened)
+*/
+extern int urg_cache_load(urg_cache_t *cache, const char *file_name);
+
+
+/*!
+  \~japanese
+  \brief ファイルへの保存
+
+  接続情報を 1 行に 1 つずつ、タブ区切りのテキストで保存する。
+
+  \param[in] cache 接続情報のキャッシュ
+  \param[in] file_name ファイル名
+
+  \retval >=0 保存した接続情報の個数
+  \retval <0 エラー (ファイルを開けない)
+
+  \~english
+  \brief Saves to a file
+
+  Saves one entry per line, as tab separated text.
+
+  \param[in] cache Cache of connection information
+  \param[in] file_name File name
+
+  \retval >=0 Number of entries saved
+  \retval <0 Error (the file cannot be opened)
+*/
+extern int urg_cache_save(const urg_cache_t *cache, const char *file_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !URG_CACHE_H */
@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief ʐM̏
+  \brief 通信の処理
   \~english
   \brief Process communications
   \~
@@ -23,64 +23,135 @@ extern "C" {
 
 /*!
   \~japanese
-  \brief 萔`
+  \brief 定数定義
   \~english
   \brief Defines constants
 */
 enum {
-    URG_CONNECTION_TIMEOUT = -1, //!< \~japanese ^CAEgƂ̖߂l  \~english Return value in case of timeout
+    URG_CONNECTION_TIMEOUT = -1, //!< \~japanese タイムアウトが発生したときの戻り値  \~english Return value in case of timeout
+    URG_CONNECTION_OVERFLOW = -2, //!< \~japanese 受信バッファに収まらないときの戻り値  \~english Return value when the data does not fit in the receive buffer
+
+    URG_CONNECTION_MIN_BUFFER_SHIFT = 8, //!< \~japanese 接続オプションで指定できる受信バッファのサイズの最小値 (2 の乗数)  \~english Minimum receive buffer size of the connection options, as power of 2
+    URG_CONNECTION_MAX_BUFFER_SHIFT = 24, //!< \~japanese 接続オプションで指定できる受信バッファのサイズの最大値 (2 の乗数)  \~english Maximum receive buffer size of the connection options, as power of 2
 };
 
 
 /*!
   \~japanese
-  \brief ʐM^Cv
+  \brief 通信タイプ
   \~english
   \brief Connection type
 */
 typedef enum {
-    URG_SERIAL,                 //!< \~japanese VA, USB ڑ  \~english Serial/USB connection
-    URG_ETHERNET,               //!< \~japanese C[T[lbgڑ  \~english Ethernet connection
+    URG_SERIAL,                 //!< \~japanese シリアル, USB 接続  \~english Serial/USB connection
+    URG_ETHERNET,               //!< \~japanese イーサーネット接続  \~english Ethernet connection
+    URG_USER_TRANSPORT,         //!< \~japanese 接続オプションで指定した通信手段  \~english Transport given in the connection options
 } urg_connection_type_t;
 
 
+struct urg_connection_option;
+
+
+/*!
+  \~japanese
+  \brief 通信手段
+
+  通信手段ごとの処理を呼び出すための関数テーブル。context には接続ごとの状態を格納した領域が渡される。
+
+  write, read, readline は必須とする。open, close, set_baudrate は NULL のとき何もせずに成功したものとして扱う。buffer, fill は connection_peek_frame(), connection_peek() で受信バッファを直接参照するために使われ、NULL のときそれらの関数はエラーを返す。
+
+  \~english
+  \brief Transport
+
+  Table of functions called for each transport. context points to the per-connection state.
+
+  write, read and readline are mandatory. If open, close or set_baudrate is NULL, nothing is done and success is assumed. buffer and fill are used by connection_peek_frame() and connection_peek() to refer to the receive buffer directly; if they are NULL, those functions return an error.
+*/
+typedef struct
+{
+    //! \~japanese 接続を開く  \~english Opens the connection
+    int (*open)(void *context, const char *device, long baudrate_or_port,
+                const struct urg_connection_option *option);
+
+    //! \~japanese 接続を閉じる  \~english Closes the connection
+    void (*close)(void *context);
+
+    //! \~japanese ボーレートを設定する  \~english Configures the baudrate
+    int (*set_baudrate)(void *context, long baudrate);
+
+    //! \~japanese データを送信する  \~english Sends data
+    int (*write)(void *context, const char *data, int size);
+
+    //! \~japanese データを受信する  \~english Receives data
+    int (*read)(void *context, char *data, int max_size, int timeout);
+
+    //! \~japanese 改行までのデータを受信する  \~english Receives data until end-of-line
+    int (*readline)(void *context, char *data, int max_size, int timeout);
+
+    //! \~japanese 受信バッファを返す  \~english Returns the receive buffer
+    ring_buffer_t *(*buffer)(void *context);
+
+    //! \~japanese 受信バッファに size バイト以上が格納されるまで受信する  \~english Receives until the receive buffer stores at least size bytes
+    int (*fill)(void *context, int size, int timeout);
+} urg_transport_t;
+
+
 /*!
   \~japanese
-  \brief ʐM\[X
+  \brief 通信リソース
   \~english
   \brief Connection resources
 */
 typedef struct
 {
-    urg_connection_type_t type; //!< \~japanese ڑ^Cv  \~english Type of connection
-    urg_serial_t serial;        //!< \~japanese VAڑ \~english Serial connection
-    urg_tcpclient_t tcpclient;  //!< \~japanese C[T[lbgڑ \~english Ethernet connection
+    urg_connection_type_t type; //!< \~japanese 接続タイプ  \~english Type of connection
+    urg_serial_t serial;        //!< \~japanese シリアル接続 \~english Serial connection
+    urg_tcpclient_t tcpclient;  //!< \~japanese イーサーネット接続 \~english Ethernet connection
+    const urg_transport_t *transport; //!< \~japanese 使用中の通信手段  \~english Transport in use
+    void *context;              //!< \~japanese 通信手段に渡す接続ごとの状態  \~english Per-connection state given to the transport
 } urg_connection_t;
 
 
 /*!
   \~japanese
-  \brief ڑ
+  \brief 接続オプション
+  \~english
+  \brief Connection options
+*/
+typedef struct urg_connection_option
+{
+    char *buffer;               //!< \~japanese 受信バッファ。NULL のときは接続リソース内のバッファを使う  \~english Receive buffer. If NULL, the buffer inside the connection resource is used
+    int buffer_shift_length;    //!< \~japanese 受信バッファのサイズ (2 の乗数)。#URG_CONNECTION_MIN_BUFFER_SHIFT 以上 #URG_CONNECTION_MAX_BUFFER_SHIFT 以下  \~english Receive buffer size as power of 2, from #URG_CONNECTION_MIN_BUFFER_SHIFT to #URG_CONNECTION_MAX_BUFFER_SHIFT
+    urg_tcpclient_option_t tcpclient; //!< \~japanese イーサーネット接続のソケットオプション  \~english Socket options of the Ethernet connection
+    const urg_transport_t *transport; //!< \~japanese URG_USER_TRANSPORT で使う通信手段  \~english Transport used with URG_USER_TRANSPORT
+    void *transport_context;    //!< \~japanese transport に渡す接続ごとの状態  \~english Per-connection state given to transport
+} urg_connection_option_t;
+
+
+/*!
+  \~japanese
+  \brief 接続
 
-  w肳ꂽfoCXɐڑB
+  指定されたデバイスに接続する。
 
-  \param[in,out] connection ʐM\[X
-  \param[in] connection_type ڑ^Cv
-  \param[in] device ڑ
-  \param[in] baudrate_or_port {[[g / |[gԍ
+  \param[in,out] connection 通信リソース
+  \param[in] connection_type 接続タイプ
+  \param[in] device 接続名
+  \param[in] baudrate_or_port ボーレート / ポート番号
 
-  \retval 0 
-  \retval <0 G[
+  \retval 0 正常
+  \retval <0 エラー
 
-  connection_type ɂ
+  connection_type には
 
-  - URG_SERIAL ... VAʐM
-  - URG_ETHERNET .. C[T[lbgʐM
+  - URG_SERIAL ... シリアル通信
+  - URG_ETHERNET .. イーサーネット通信
+  - URG_USER_TRANSPORT .. 接続オプションで指定した通信手段 (connection_open_with_option() のみ)
 
-  w肷B
+  を指定する。
 
-  device, baudrate_or_port ̎w connection_type ɂwłlقȂB
-  Ⴆ΁AVAʐM̏ꍇ͈ȉ̂悤ɂȂB
+  device, baudrate_or_port の指定は connection_type により指定できる値が異なる。
+  例えば、シリアル通信の場合は以下のようになる。
 
   \~english
   \brief Connection
@@ -99,6 +170,7 @@ typedef struct
 
   - URG_SERIAL ... Serial connection
   - URG_ETHERNET .. Ethernet connection
+  - URG_USER_TRANSPORT .. Transport given in the connection options (connection_open_with_option() only)
 
   device and baudrate_or_port arguments are defined according to connection_type
   For example, in case of serial connection:
@@ -131,11 +203,75 @@ extern int connection_open(urg_connection_t *connection,
 
 /*!
   \~japanese
-  \brief ؒf
+  \brief 接続オプションの初期化
 
-  foCXƂ̐ڑؒfB
+  接続リソース内のバッファを使い、ソケットオプションはシステムの既定値のままとし、通信手段は指定しない設定で初期化する。
+
+  \param[out] option 接続オプション
 
-  \param[in,out] connection ʐM\[X
+  \~english
+  \brief Initializes the connection options
+
+  Initializes the options so that the buffer inside the connection resource is used, the socket options are left to the system defaults and no user transport is set.
+
+  \param[out] option Connection options
+*/
+extern void connection_option_initialize(urg_connection_option_t *option);
+
+
+/*!
+  \~japanese
+  \brief オプションを指定しての接続
+
+  connection_open() に加え、受信バッファなどの接続オプションを指定できる。option に NULL を指定したときは connection_open() と同じ動作となる。
+
+  \param[in,out] connection 通信リソース
+  \param[in] connection_type 接続タイプ
+  \param[in] device 接続名
+  \param[in] baudrate_or_port ボーレート / ポート番号
+  \param[in] option 接続オプション
+
+  \retval 0 正常
+  \retval <0 エラー
+
+  option->buffer は接続を閉じるまで呼び出し側で保持すること。option->tcpclient は URG_ETHERNET のときのみ使われ、システムが受け付けないソケットオプションを指定したときはエラーを返す。
+
+  URG_USER_TRANSPORT のときは option->transport の関数が option->transport_context を引数にして呼び出される。device, baudrate_or_port, option はそのまま option->transport->open に渡される。
+
+  \~english
+  \brief Connection with options
+
+  In addition to connection_open(), connection options such as the receive buffer can be specified. If option is NULL, works the same as connection_open().
+
+  \param[in,out] connection Connection resource
+  \param[in] connection_type Connection type
+  \param[in] device Device name
+  \param[in] baudrate_or_port Baudrate or port number
+  \param[in] option Connection options
+
+  \retval 0 Success
+  \retval <0 Error
+
+  option->buffer must be kept by the caller until the connection is closed. option->tcpclient is used only with URG_ETHERNET; an error is returned if the system refuses one of the socket options.
+
+  With URG_USER_TRANSPORT the functions of option->transport are called with option->transport_context. device, baudrate_or_port and option are passed as is to option->transport->open.
+  \~
+  \see connection_open(), connection_option_initialize()
+*/
+extern int connection_open_with_option(urg_connection_t *connection,
+                                       urg_connection_type_t connection_type,
+                                       const char *device,
+                                       long baudrate_or_port,
+                                       const urg_connection_option_t *option);
+
+
+/*!
+  \~japanese
+  \brief 切断
+
+  デバイスとの接続を切断する。
+
+  \param[in,out] connection 通信リソース
   \~english
   \brief Disconnection
 
@@ -153,7 +289,7 @@ extern void connection_close(urg_connection_t *connection);
 
 /*!
   \~japanese
-  \brief {[[gݒ肷
+  \brief ボーレートを設定する
   \~english
   \brief Configures the baudrate
 */
@@ -162,16 +298,16 @@ extern int connection_set_baudrate(urg_connection_t *connection, long baudrate);
 
 /*!
   \~japanese
-  \brief M
+  \brief 送信
 
-  f[^𑗐MB
+  データを送信する。
 
-  \param[in,out] connection ʐM\[X
-  \param[in] data Mf[^
-  \param[in] size MoCg
+  \param[in,out] connection 通信リソース
+  \param[in] data 送信データ
+  \param[in] size 送信バイト数
 
-  \retval >=0 Mf[^
-  \retval <0 G[
+  \retval >=0 送信データ数
+  \retval <0 エラー
 
   \~english
   \brief Send
@@ -198,21 +334,21 @@ extern int connection_write(urg_connection_t *connection,
 
 /*!
   \~japanese
-  \brief M
+  \brief 受信
 
-  f[^MB
+  データを受信する。
 
-  \param[in,out] connection ʐM\[X
-  \param[in] data Mf[^i[obt@
-  \param[in] max_size Mf[^i[łoCg
-  \param[in] timeout ^CAEg [msec]
+  \param[in,out] connection 通信リソース
+  \param[in] data 受信データを格納するバッファ
+  \param[in] max_size 受信データを格納できるバイト数
+  \param[in] timeout タイムアウト時間 [msec]
 
-  \retval >=0 Mf[^
-  \retval <0 G[
+  \retval >=0 受信データ数
+  \retval <0 エラー
 
-  timeout ɕ̒lw肵ꍇA^CAEg͔ȂB
+  timeout に負の値を指定した場合、タイムアウトは発生しない。
 
-  1 MȂƂ #URG_CONNECTION_TIMEOUT ԂB
+  1 文字も受信しなかったときは #URG_CONNECTION_TIMEOUT を返す。
 
   \~english
   \brief Receive
@@ -249,23 +385,23 @@ extern int connection_read(urg_connection_t *connection,
 
 /*!
   \~japanese
-  \brief s܂ł̎M
+  \brief 改行文字までの受信
 
-  s܂ł̃f[^MB
+  改行文字までのデータを受信する。
 
-  \param[in,out] connection ʐM\[X
-  \param[in] data Mf[^i[obt@
-  \param[in] max_size Mf[^i[łoCg
-  \param[in] timeout ^CAEg [msec]
+  \param[in,out] connection 通信リソース
+  \param[in] data 受信データを格納するバッファ
+  \param[in] max_size 受信データを格納できるバイト数
+  \param[in] timeout タイムアウト時間 [msec]
 
-  \retval >=0 Mf[^
-  \retval <0 G[
+  \retval >=0 受信データ数
+  \retval <0 エラー
 
-  data ɂ́A'\\0' I[ꂽ max_size zȂoCgi[B ܂AMł镶̃oCǵAő max_size - 1 ƂȂB
+  data には、'\\0' 終端された文字列が max_size を越えないバイト数だけ格納される。 つまり、受信できる文字のバイト数は、最大で max_size - 1 となる。
 
-  s '\\r' ܂ '\\n' ƂB
+  改行文字は '\\r' または '\\n' とする。
 
-  Mŏ̕s̏ꍇ́A0 ԂA1 MȂƂ #URG_CONNECTION_TIMEOUT ԂB
+  受信した最初の文字が改行の場合は、0 を返し、1 文字も受信しなかったときは #URG_CONNECTION_TIMEOUT を返す。
 
   \~english
   \brief Receive until end-of-line
@@ -294,6 +430,145 @@ extern int connection_read(urg_connection_t *connection,
 extern int connection_readline(urg_connection_t *connection,
                                char *data, int max_size, int timeout);
 
+
+/*!
+  \~japanese
+  \brief 空行までの受信
+
+  空行 (LF LF) で終端される応答全体を受信し、受信バッファ内の連続した領域として返す。データはコピーされず、受信バッファから取り除かれない。参照し終えたら connection_consume() で取り除くこと。
+
+  \param[in,out] connection 通信リソース
+  \param[out] frame 応答の先頭
+  \param[in] timeout タイムアウト時間 [msec]
+
+  \retval >0 終端の空行を含む応答のバイト数
+  \retval <0 エラー
+
+  1 つの応答が受信バッファに収まらないときは #URG_CONNECTION_OVERFLOW を返し、応答を受信しきれなかったときは #URG_CONNECTION_TIMEOUT を返す。
+
+  \~english
+  \brief Receive until an empty line
+
+  Receives a whole response terminated by an empty line (LF LF) and returns it as a contiguous region of the receive buffer. Data is neither copied nor removed from the receive buffer; remove it with connection_consume() when done.
+
+  \param[in,out] connection Connection resource
+  \param[out] frame Start of the response
+  \param[in] timeout Timeout [msec]
+
+  \retval >0 Number of bytes of the response including the terminating empty line
+  \retval <0 Error
+
+  If a response does not fit in the receive buffer #URG_CONNECTION_OVERFLOW is returned, if the whole response is not received #URG_CONNECTION_TIMEOUT is returned.
+  \~
+  \see connection_consume()
+*/
+extern int connection_peek_frame(urg_connection_t *connection,
+                                 char **frame, int timeout);
+
+
+/*!
+  \~japanese
+  \brief 指定行数の受信
+
+  受信バッファの先頭から line_count 行を受信し、受信バッファ内の連続した領域として返す。データはコピーされず、受信バッファから取り除かれない。
+
+  \param[in,out] connection 通信リソース
+  \param[out] data 先頭の行
+  \param[in] line_count 行数
+  \param[in] timeout タイムアウト時間 [msec]
+
+  \retval >0 line_count 行目の LF までのバイト数
+  \retval <0 エラー
+
+  \~english
+  \brief Receive a number of lines
+
+  Receives line_count lines from the start of the receive buffer and returns them as a contiguous region of the receive buffer. Data is neither copied nor removed from the receive buffer.
+
+  \param[in,out] connection Connection resource
+  \param[out] data First line
+  \param[in] line_count Number of lines
+  \param[in] timeout Timeout [msec]
+
+  \retval >0 Number of bytes up to the LF of the line_count-th line
+  \retval <0 Error
+  \~
+  \see connection_consume()
+*/
+extern int connection_peek_lines(urg_connection_t *connection,
+                                 char **data, int line_count, int timeout);
+
+
+/*!
+  \~japanese
+  \brief 指定バイト数の受信
+
+  size バイトのデータを受信し、受信バッファ内の連続した領域として返す。データはコピーされず、受信バッファから取り除かれない。参照し終えたら connection_consume() で取り除くこと。
+
+  \param[in,out] connection 通信リソース
+  \param[out] data 受信データの先頭
+  \param[in] size 受信するバイト数
+  \param[in] timeout タイムアウト時間 [msec]
+
+  \retval >0 受信したバイト数 (size)
+  \retval <0 エラー
+
+  size が受信バッファより大きいときは #URG_CONNECTION_OVERFLOW を返し、size バイトを受信しきれなかったときは #URG_CONNECTION_TIMEOUT を返す。
+
+  \~english
+  \brief Receive a given number of bytes
+
+  Receives size bytes and returns them as a contiguous region of the receive buffer. Data is neither copied nor removed from the receive buffer; remove it with connection_consume() when done.
+
+  \param[in,out] connection Connection resource
+  \param[out] data Start of the received data
+  \param[in] size Number of bytes to receive
+  \param[in] timeout Timeout [msec]
+
+  \retval >0 Number of received bytes (size)
+  \retval <0 Error
+
+  If size is larger than the receive buffer #URG_CONNECTION_OVERFLOW is returned, if size bytes are not received #URG_CONNECTION_TIMEOUT is returned.
+  \~
+  \see connection_consume()
+*/
+extern int connection_peek(urg_connection_t *connection,
+                           char **data, int size, int timeout);
+
+
+/*!
+  \~japanese
+  \brief 受信データの破棄
+
+  connection_peek_frame(), connection_peek() で参照したデータを size バイトだけ受信バッファから取り除く。
+
+  \param[in,out] connection 通信リソース
+  \param[in] size 取り除くバイト数
+
+  \~english
+  \brief Discards received data
+
+  Removes size bytes of the data referred with connection_peek_frame() or connection_peek() from the receive buffer.
+
+  \param[in,out] connection Connection resource
+  \param[in] size Number of bytes to remove
+*/
+extern void connection_consume(urg_connection_t *connection, int size);
+
+
+/*!
+  \~japanese
+  \brief 単調増加する時刻
+
+  \return 時刻 [msec]。差を求めて経過時間を計るために使う
+
+  \~english
+  \brief Monotonic time
+
+  \return Time [msec], used to measure elapsed times by difference
+*/
+extern long connection_ticks(void);
+
 #ifdef __cplusplus
 }
 #endif
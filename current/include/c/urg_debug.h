@@ -8,7 +8,7 @@
   \author Satofumi KAMIMURA
 
   \~japanese
-  \attention gKv͂܂B
+  \attention 使う必要はありません。
 
   \~english
   \attention It is not necessary to use these functions.
@@ -25,7 +25,7 @@ extern "C" {
 
     /*!
      \~japanese
-     \brief ZTɃf[^𒼐ڑM
+     \brief センサにデータを直接送信する
      \~english
      \brief Directly send raw data to the sensor
     */
@@ -34,7 +34,7 @@ extern "C" {
 
     /*!
      \~japanese
-     \brief ZTf[^𒼐ڎM
+     \brief センサからデータを直接受信する
      \~english
      \brief Directly get raw data from the sensor
     */
@@ -43,7 +43,7 @@ extern "C" {
 
     /*!
      \~japanese
-     \brief ZTs܂ł̃f[^𒼐ڎM
+     \brief センサから改行までのデータを直接受信する
      \~english
      \brief Directly get raw data from the sensor until end-of-line
      */
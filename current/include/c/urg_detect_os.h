@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief OS ̌o
+  \brief OS の検出
   \~english
   \brief Detects the current OS
   \~
@@ -24,7 +24,7 @@
 #define URG_LINUX_OS
 
 #else
-// \~japanese ołȂƂAMac ɂĂ܂
+// \~japanese 検出できないときを、Mac 扱いにしてしまう
 // \~english If cannot detect the OS, assumes it is a Mac
 #define URG_MAC_OS
 #endif
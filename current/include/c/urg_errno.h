@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief URG CũG[`
+  \brief URG ライブラリのエラー定義
   \~english
   \brief Definition of error codes of URG library
   \~
@@ -33,6 +33,7 @@ enum {
     URG_ETHERNET_OPEN_ERROR = (URG_COMMON_ERROR_LAST -1) -3,
     URG_SCANNING_PARAMETER_ERROR = (URG_COMMON_ERROR_LAST -1) -4,
     URG_DATA_SIZE_PARAMETER_ERROR = (URG_COMMON_ERROR_LAST -1) -5,
+    URG_FRAMING_ERROR = (URG_COMMON_ERROR_LAST -1) -6,
 };
 
 #endif /* !URG_ERRNO_H */
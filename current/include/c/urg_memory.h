@@ -0,0 +1,123 @@
+#ifndef URG_MEMORY_H
+#define URG_MEMORY_H
+
+/*!
+  \file
+  \~japanese
+  \brief メモリ上の通信手段
+
+  センサの応答をメモリから供給する通信手段。記録した応答を再生して、受信データの解析を通信速度に依存せずに評価するために使う。
+
+  \~english
+  \brief In-memory transport
+
+  Transport that supplies the sensor responses from memory. Used to replay recorded responses and evaluate the parsing of received data independently of the link speed.
+  \~
+
+  $Id$
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "urg_connection.h"
+
+
+/*!
+  \~japanese
+  \brief メモリ上の通信手段の状態
+
+  on_write はコマンドが送信されるたびに、on_read は受信データが不足したときに user_data を引数にして呼び出される。どちらも memory_receive() でセンサの応答を受信データに加えることができ、NULL のときは呼び出されない。on_read はデータが加えられるか、受信のタイムアウト時間が経過するまで繰り返し呼び出される。
+
+  \~english
+  \brief State of the in-memory transport
+
+  on_write is called on each sent command, and on_read when more received data is needed, both with user_data. Both can add the sensor responses to the received data with memory_receive(); they are not called if NULL. on_read is called repeatedly until data is added or the receive timeout elapses.
+*/
+typedef struct
+{
+    ring_buffer_t ring;         //!< \~japanese リングバッファ  \~english Ring buffer structure
+    char buffer[RING_BUFFER_SIZE]; //!< \~japanese バッファ領域  \~english Data buffer
+    void (*on_write)(void *user_data, const char *data, int size); //!< \~japanese コマンド送信時の処理  \~english Called on each sent command
+    void (*on_read)(void *user_data); //!< \~japanese 受信データが不足したときの処理  \~english Called when more received data is needed
+    void *user_data;            //!< \~japanese on_write, on_read に渡すデータ  \~english Data given to on_write and on_read
+} urg_memory_t;
+
+
+/*!
+  \~japanese
+  \brief 初期化
+
+  受信データを空にし、on_write, on_read, user_data を NULL にする。
+
+  \param[out] memory メモリ上の通信手段の状態
+
+  \~english
+  \brief Initialization
+
+  Empties the received data and sets on_write, on_read and user_data to NULL.
+
+  \param[out] memory State of the in-memory transport
+*/
+extern void memory_initialize(urg_memory_t *memory);
+
+
+/*!
+  \~japanese
+  \brief 受信データの追加
+
+  data をセンサから受信したデータとして受信バッファに加える。
+
+  \param[in,out] memory メモリ上の通信手段の状態
+  \param[in] data 追加するデータ
+  \param[in] size 追加するバイト数
+
+  \return 受信バッファに加えたバイト数。受信バッファに空きが無いときは size より小さくなる
+
+  \~english
+  \brief Adds received data
+
+  Adds data to the receive buffer as if it were received from the sensor.
+
+  \param[in,out] memory State of the in-memory transport
+  \param[in] data Data to add
+  \param[in] size Number of bytes to add
+
+  \return Number of bytes added to the receive buffer, smaller than size if the receive buffer is full
+*/
+extern int memory_receive(urg_memory_t *memory, const char *data, int size);
+
+
+/*!
+  \~japanese
+  \brief メモリ上の通信手段
+
+  urg_connection_option_t の transport に指定し、transport_context には urg_memory_t のアドレスを指定する。open は受信データを空にし、option->buffer があればそれを受信バッファとして使う。
+
+  \~english
+  \brief In-memory transport
+
+  Set it as transport of urg_connection_option_t, with the address of an urg_memory_t as transport_context. open empties the received data and uses option->buffer as receive buffer if given.
+  \~
+  Example
+  \code
+  urg_memory_t memory;
+  urg_connection_option_t option;
+
+  memory_initialize(&memory);
+  memory.on_write = respond;
+  memory.user_data = &recorded;
+
+  connection_option_initialize(&option);
+  option.transport = &memory_transport;
+  option.transport_context = &memory;
+  urg_open_with_option(&urg, URG_USER_TRANSPORT, "memory", 115200, &option); \endcode
+*/
+extern const urg_transport_t memory_transport;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !URG_MEMORY_H */
@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief Oobt@
+  \brief リングバッファ
   \~english
   \brief Ring buffer functions
   \~
@@ -14,23 +14,45 @@
 */
 
 
-//! \~japanese Oobt@̊Ǘ  \~english Control structure of the ring buffer
+//! \~japanese リングバッファの管理情報  \~english Control structure of the ring buffer
 typedef struct
 {
-    char *buffer;                 //!< \~japanese obt@ւ̃|C^  \~english Pointer to the data buffer
-    int buffer_size;              //!< \~japanese obt@TCY  \~english Buffer size
-    int first;                    //!< \~japanese obt@̐擪ʒu  \~english Index of the first entry of the buffer
-    int last;                     //!< \~japanese obt@̍ŏIʒu  \~english Index of the last entry of the buffer
+    char *buffer;                 //!< \~japanese バッファへのポインタ  \~english Pointer to the data buffer
+    int buffer_size;              //!< \~japanese バッファサイズ  \~english Buffer size
+    int first;                    //!< \~japanese バッファの先頭位置  \~english Index of the first entry of the buffer
+    int last;                     //!< \~japanese バッファの最終位置  \~english Index of the last entry of the buffer
 } ring_buffer_t;
 
 
+//! \~japanese リングバッファ内の連続した領域  \~english Contiguous region of the ring buffer
+typedef struct
+{
+    char *data;                   //!< \~japanese 領域の先頭  \~english Start of the region
+    int size;                     //!< \~japanese 領域のサイズ  \~english Size of the region
+} ring_span_t;
+
+
+/*!
+  \~japanese
+  \brief リングバッファにデータを読み足す関数
+
+  context の受信バッファに size バイト以上が格納されるか、timeout [msec] が経過するまでデータを読み足し、読み足したバイト数を返す。
+
+  \~english
+  \brief Function which reads more data into the ring buffer
+
+  Reads data into the receive buffer of context until at least size bytes are stored or timeout [msec] elapses, and returns the number of bytes read.
+*/
+typedef int (*ring_fill_function)(void *context, int size, int timeout);
+
+
 /*!
   \~japanese
-  \brief 
+  \brief 初期化
 
-  \param[in] ring Oobt@̍\
-  \param[in] buffer 蓖Ăobt@
-  \param[in] shift_length obt@TCY 2 ̏搔
+  \param[in] ring リングバッファの構造体
+  \param[in] buffer 割り当てるバッファ
+  \param[in] shift_length バッファサイズの 2 の乗数
 
   \~english
   \brief Initialization
@@ -45,9 +67,9 @@ extern void ring_initialize(ring_buffer_t *ring,
 
 /*!
   \~japanese
-  \brief Oobt@̃NA
+  \brief リングバッファのクリア
 
-  \param[in] ring Oobt@̍\
+  \param[in] ring リングバッファの構造体
 
   \~english
   \brief Clears the ring  buffer
@@ -59,9 +81,9 @@ extern void ring_clear(ring_buffer_t *ring);
 
 /*!
   \~japanese
-  \brief i[f[^Ԃ
+  \brief 格納データ数を返す
 
-  \param[in] ring Oobt@̍\
+  \param[in] ring リングバッファの構造体
 
   \~english
   \brief Returns the number of elements on the buffer
@@ -73,9 +95,9 @@ extern int ring_size(const ring_buffer_t *ring);
 
 /*!
   \~japanese
-  \brief ő̊i[f[^Ԃ
+  \brief 最大の格納データ数を返す
 
-  \param[in] ring Oobt@̍\
+  \param[in] ring リングバッファの構造体
 
   \~english
   \brief Returns the maximum number of elements of the ring buffer
@@ -87,13 +109,13 @@ extern int ring_capacity(const ring_buffer_t *ring);
 
 /*!
   \~japanese
-  \brief f[^̊i[
+  \brief データの格納
 
-  \param[in] ring Oobt@̍\
-  \param[in] data f[^
-  \param[in] size f[^TCY
+  \param[in] ring リングバッファの構造体
+  \param[in] data データ
+  \param[in] size データサイズ
 
-  \return i[f[^
+  \return 格納したデータ数
 
   \~english
   \brief Stores data on the ring buffer
@@ -109,13 +131,13 @@ extern int ring_write(ring_buffer_t *ring, const char *data, int size);
 
 /*!
   \~japanese
-  \brief f[^̎o
+  \brief データの取り出し
 
-  \param[in] ring Oobt@̍\
-  \param[out] buffer f[^
-  \param[in] size ő̃f[^TCY
+  \param[in] ring リングバッファの構造体
+  \param[out] buffer データ
+  \param[in] size 最大のデータサイズ
 
-  \return of[^
+  \return 取り出したデータ数
 
   \~english
   \brief Extracts data from the ring buffer
@@ -128,4 +150,172 @@ extern int ring_write(ring_buffer_t *ring, const char *data, int size);
 */
 extern int ring_read(ring_buffer_t *ring, char *buffer, int size);
 
+
+
+/*!
+  \~japanese
+  \brief 格納データの領域を返す
+
+  データを取り出さずに、格納データを最大 2 つの連続した領域として返す。spans[1] はデータがバッファの終端で折り返しているときのみ使われ、それ以外のときは size が 0 となる。
+
+  \param[in] ring リングバッファの構造体
+  \param[out] spans 格納データの領域
+
+  \return 格納データ数
+
+  \~english
+  \brief Returns the regions of the stored data
+
+  Returns the stored data as up to two contiguous regions without extracting it. spans[1] is only used when the data wraps around the end of the buffer, otherwise its size is 0.
+
+  \param[in] ring Pointer to the ring buffer data structure
+  \param[out] spans Regions of the stored data
+
+  \return The number of elements stored on the buffer
+  \~
+  \see ring_consume()
+*/
+extern int ring_peek(const ring_buffer_t *ring, ring_span_t spans[2]);
+
+
+/*!
+  \~japanese
+  \brief 格納データの破棄
+
+  ring_peek() で参照したデータを先頭から size 個だけ取り除く。
+
+  \param[in] ring リングバッファの構造体
+  \param[in] size 取り除くデータ数
+
+  \~english
+  \brief Discards stored data
+
+  Removes size elements from the start of the data referred with ring_peek().
+
+  \param[in] ring Pointer to the ring buffer data structure
+  \param[in] size Number of elements to remove
+*/
+extern void ring_consume(ring_buffer_t *ring, int size);
+
+
+/*!
+  \~japanese
+  \brief 空き領域を返す
+
+  データを書き込める空き領域を最大 2 つの連続した領域として返す。書き込んだデータは ring_commit() で格納データに加える。バッファが空のときは、連続した領域が最大になるように先頭に戻す。
+
+  \param[in] ring リングバッファの構造体
+  \param[out] spans 空き領域
+
+  \return 空き領域のサイズ
+
+  \~english
+  \brief Returns the free regions
+
+  Returns the free area where data can be written as up to two contiguous regions. Written data is added to the buffer with ring_commit(). An empty buffer is rewound so that the contiguous region is the largest.
+
+  \param[in] ring Pointer to the ring buffer data structure
+  \param[out] spans Free regions
+
+  \return Size of the free area
+  \~
+  \see ring_commit()
+*/
+extern int ring_reserve(ring_buffer_t *ring, ring_span_t spans[2]);
+
+
+/*!
+  \~japanese
+  \brief 書き込んだデータの格納
+
+  ring_reserve() で返した領域に書き込んだ size 個のデータを格納データに加える。
+
+  \param[in] ring リングバッファの構造体
+  \param[in] size 書き込んだデータ数
+
+  \~english
+  \brief Stores the written data
+
+  Adds size elements written into the regions returned by ring_reserve() to the stored data.
+
+  \param[in] ring Pointer to the ring buffer data structure
+  \param[in] size Number of elements written
+*/
+extern void ring_commit(ring_buffer_t *ring, int size);
+
+
+/*!
+  \~japanese
+  \brief 格納データを連続した領域に並べ替える
+
+  バッファの終端で折り返している格納データを、バッファの先頭から連続するように並べ替える。
+
+  \param[in] ring リングバッファの構造体
+
+  \return 格納データの先頭
+
+  \~english
+  \brief Rearranges the stored data into a contiguous region
+
+  Moves the stored data wrapping around the end of the buffer so that it starts from the beginning of the buffer.
+
+  \param[in] ring Pointer to the ring buffer data structure
+
+  \return Pointer to the start of the stored data
+*/
+extern char *ring_linearize(ring_buffer_t *ring);
+
+
+/*!
+  \~japanese
+  \brief 改行文字の位置を返す
+
+  \param[in] ring リングバッファの構造体
+  \param[in] size 探すデータ数
+
+  \return 格納データの先頭 size 個の中で最初の改行文字 (CR, LF) の位置。見つからなければ -1
+
+  \~english
+  \brief Returns the position of the EOL character
+
+  \param[in] ring Pointer to the ring buffer data structure
+  \param[in] size Number of elements to search
+
+  \return Position of the first EOL character (CR, LF) within the first size stored elements, -1 if not found
+*/
+extern int ring_find_linefeed(const ring_buffer_t *ring, int size);
+
+
+/*!
+  \~japanese
+  \brief 1 行分のデータの取り出し
+
+  改行文字までのデータを data に取り出し、改行文字は取り除く。改行が見つかるまで fill でデータを読み足す。max_size - 1 文字までに改行が無いときは、max_size - 1 文字を取り出し、残りはリングバッファに残す。
+
+  \param[in] ring リングバッファの構造体
+  \param[out] data 取り出した行 (末尾に '\\0' を付加する)
+  \param[in] max_size data の最大サイズ
+  \param[in] fill データを読み足す関数
+  \param[in] context fill に渡す引数
+  \param[in] timeout fill に渡すタイムアウト時間 [msec]
+
+  \return 取り出した文字数。1 文字も取り出せなかったときは -1
+
+  \~english
+  \brief Extracts one line of data
+
+  Extracts the data up to the EOL character into data, and removes the EOL character. Data is read with fill until the EOL is found. If there is no EOL within max_size - 1 characters, max_size - 1 characters are extracted and the rest is left in the ring buffer.
+
+  \param[in] ring Pointer to the ring buffer data structure
+  \param[out] data Extracted line, terminated with '\\0'
+  \param[in] max_size Maximum size of data
+  \param[in] fill Function which reads more data
+  \param[in] context Argument passed to fill
+  \param[in] timeout Timeout [msec] passed to fill
+
+  \return Number of extracted characters, -1 if no character was extracted
+*/
+extern int ring_readline(ring_buffer_t *ring, char *data, int max_size,
+                         ring_fill_function fill, void *context, int timeout);
+
 #endif /* ! RING_BUFFER_H */
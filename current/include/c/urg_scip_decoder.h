@@ -0,0 +1,147 @@
+#ifndef URG_SCIP_DECODER_H
+#define URG_SCIP_DECODER_H
+
+/*!
+  \file
+  \~japanese
+  \brief SCIP 文字列の一括デコード
+
+  SIMD 命令で複数の SCIP 文字列をまとめてデコードする。使用する命令セットは実行時に CPU を調べて選択し、使えないときは 1 つずつデコードする。
+
+  \~english
+  \brief Block decoding of SCIP strings
+
+  Decodes many SCIP strings at once with SIMD instructions. The instruction set is chosen at run time from the CPU features, and the values are decoded one by one if none is available.
+  \~
+
+  $Id$
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "urg_detect_os.h"
+
+#if defined(URG_MSC) && (_MSC_VER < 1600)
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+#else
+#include <stdint.h>
+#endif
+
+
+/*!
+  \~japanese
+  \brief SCIP 文字列の一括デコード
+
+  width 文字ずつで符号化された count 個の値をデコードし、values に格納する。
+
+  \param[in] data SCIP 文字列
+  \param[in] count デコードする値の個数
+  \param[in] width 1 つの値の文字数 (1 から 4)
+  \param[out] values デコード後の数値
+
+  \retval >=0 デコードした値の個数 (count)
+  \retval <0 エラー
+
+  data は count * width バイトを参照できること。各文字の下位 6 ビット以外は無視されるため、data はチェックサムで検証してから渡すこと。
+
+  \~english
+  \brief Decodes a block of SCIP strings
+
+  Decodes count values encoded with width characters each and stores them in values.
+
+  \param[in] data SCIP string
+  \param[in] count Number of values to decode
+  \param[in] width Number of characters of one value (1 to 4)
+  \param[out] values Decoded values
+
+  \retval >=0 Number of decoded values (count)
+  \retval <0 Error
+
+  data must hold count * width bytes. Only the lower 6 bits of each character are used, so data should be validated with its checksum beforehand.
+  \~
+  Example
+  \code
+  uint32_t values[3];
+  urg_scip_decode_block("0m20m30m4", 3, 3, values); \endcode
+
+  \~
+  \see urg_scip_decode()
+*/
+extern int urg_scip_decode_block(const char data[], int count, int width,
+                                 uint32_t values[]);
+
+
+/*!
+  \~japanese
+  \brief バイト和を求めながらの一括デコード
+
+  urg_scip_decode_block() と同じデコードを行い、同じ走査で data の count * width バイトの和を *sum に加える。デコードとチェックサムの計算とで行を 2 回読まずに済む。
+
+  \param[in] data SCIP 文字列
+  \param[in] count デコードする値の個数
+  \param[in] width 1 つの値の文字数 (1 から 4)
+  \param[out] values デコード後の数値
+  \param[in,out] sum バイト和を加える変数
+
+  \retval >=0 デコードした値の個数 (count)
+  \retval <0 エラー
+
+  \~english
+  \brief Block decoding with the byte sum
+
+  Decodes as urg_scip_decode_block() does, and adds the sum of the count * width bytes of data to *sum in the same pass. The line is then read once for both the decoding and the checksum.
+
+  \param[in] data SCIP string
+  \param[in] count Number of values to decode
+  \param[in] width Number of characters of one value (1 to 4)
+  \param[out] values Decoded values
+  \param[in,out] sum Variable the byte sum is added to
+
+  \retval >=0 Number of decoded values (count)
+  \retval <0 Error
+  \~
+  \see urg_scip_decode_block()
+*/
+extern int urg_scip_decode_block_sum(const char data[], int count, int width,
+                                     uint32_t values[], uint32_t *sum);
+
+
+/*!
+  \~japanese
+  \brief 一括デコードに使う命令セットの選択
+
+  CPU が対応する命令セットを調べ、一括デコードに使う処理を選択する。urg_open() と urg_parser_initialize() がこの関数を呼び出す。選択していないまま一括デコードを呼び出すと、その呼び出しの中で選択する。
+
+  \attention 選択の結果はスレッド間で同期されない。複数のスレッドでデコードするときは、それらのスレッドを開始する前に 1 つのスレッドでこの関数 (または urg_open()) を呼び出すこと。
+
+  \~english
+  \brief Selects the instruction set used for block decoding
+
+  Checks the instruction sets supported by the CPU and selects the processing used for block decoding. urg_open() and urg_parser_initialize() call this function. If block decoding is called before the selection, it selects within that call.
+
+  \attention The selection is not synchronised between threads. When decoding from several threads, call this function (or urg_open()) from a single thread before starting those threads.
+*/
+extern void urg_scip_decoder_initialize(void);
+
+
+/*!
+  \~japanese
+  \brief 一括デコードに使う命令セット名を返す
+
+  \retval "avx2", "ssse3", "sse2", "neon", "scalar" のいずれか
+
+  \~english
+  \brief Returns the name of the instruction set used for block decoding
+
+  \retval One of "avx2", "ssse3", "sse2", "neon" or "scalar"
+*/
+extern const char *urg_scip_decoder_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !URG_SCIP_DECODER_H */
@@ -4,9 +4,9 @@
 /*!
   \file
   \~japanese
-  \brief URG ZT
+  \brief URG センサ制御
 
-  URG p̊{IȊ֐񋟂܂B
+  URG 用の基本的な関数を提供します。
 
   \~english
   \brief URG sensor control
@@ -24,43 +24,59 @@ extern "C" {
 #endif
 
 #include "urg_connection.h"
+#include "urg_scip_decoder.h"
+#include "urg_cache.h"
 
     /*!
       \~japanese
-      \brief v^Cv
+      \brief 計測タイプ
       \~english
       \brief Measurement types
     */
     typedef enum {
-        URG_DISTANCE,           //!< \~japanese   \~english Distance (range)
-        URG_DISTANCE_INTENSITY, //!< \~japanese  + x  \~english Distance (range) and intensity (strength)
-        URG_MULTIECHO,          //!< \~japanese }`GR[̋  \~english Multiecho distance
-        URG_MULTIECHO_INTENSITY, //!< \~japanese }`GR[( + x)  \~english Multiecho distance and intensity
-        URG_STOP,                //!< \~japanese v̒~  \~english Stop measurement
-        URG_UNKNOWN,             //!< \~japanese s  \~english Unknown measurement type
+        URG_DISTANCE,           //!< \~japanese 距離  \~english Distance (range)
+        URG_DISTANCE_INTENSITY, //!< \~japanese 距離 + 強度  \~english Distance (range) and intensity (strength)
+        URG_MULTIECHO,          //!< \~japanese マルチエコーの距離  \~english Multiecho distance
+        URG_MULTIECHO_INTENSITY, //!< \~japanese マルチエコーの(距離 + 強度)  \~english Multiecho distance and intensity
+        URG_STOP,                //!< \~japanese 計測の停止  \~english Stop measurement
+        URG_UNKNOWN,             //!< \~japanese 不明  \~english Unknown measurement type
     } urg_measurement_type_t;
 
     /*!
       \~japanese
-      \brief  byte ŕ\邩̎w
+      \brief 距離を何 byte で表現するかの指定
       \~english
       \brief Distance data encoding types (number of bytes)
     */
     typedef enum {
-        URG_COMMUNICATION_3_BYTE, //!< \~japanese  3 byte ŕ\  \~english Use 3-bytes encoding for distance
-        URG_COMMUNICATION_2_BYTE, //!< \~japanese  2 byte ŕ\  \~english Use 2-bytes encoding for distance
+        URG_COMMUNICATION_3_BYTE, //!< \~japanese 距離を 3 byte で表現する  \~english Use 3-bytes encoding for distance
+        URG_COMMUNICATION_2_BYTE, //!< \~japanese 距離を 2 byte で表現する  \~english Use 2-bytes encoding for distance
     } urg_range_data_byte_t;
 
 
+    /*!
+      \~japanese
+      \brief 計測データの受信方法
+      \~english
+      \brief Measurement data receive modes
+    */
+    typedef enum {
+        URG_RECEIVE_LINE,       //!< \~japanese 1 行ずつ受信してデコードする  \~english Receives and decodes line by line
+        URG_RECEIVE_FRAME,      //!< \~japanese 応答全体を受信してから受信バッファ上でデコードする  \~english Receives the whole response, then decodes it in the receive buffer
+        URG_RECEIVE_EXACT_FRAME, //!< \~japanese 計測開始時に求めた応答サイズ分を受信してから受信バッファ上でデコードする。応答サイズの決まらないマルチエコーの計測は開始できない  \~english Receives the response size computed when the measurement started, then decodes it in the receive buffer. Multiecho measurements, whose response size is not fixed, cannot be started
+    } urg_receive_mode_t;
+
+
     enum {
-        URG_SCAN_INFINITY = 0,  //!< \~japanese ̃f[^擾  \~english Continuous data scanning
-        URG_MAX_ECHO = 3, //!< \~japanese }`GR[̍őGR[  \~english Maximum number of echoes
+        URG_SCAN_INFINITY = 0,  //!< \~japanese 無限回のデータ取得  \~english Continuous data scanning
+        URG_MAX_ECHO = 3, //!< \~japanese マルチエコーの最大エコー数  \~english Maximum number of echoes
+        URG_MAX_COMMAND_SIZE = 16, //!< \~japanese urg_send_command() で送信できるコマンドの最大長  \~english Maximum length of a command sent with urg_send_command()
     };
 
 
     /*!
        \~japanese
-       \brief G[nh
+       \brief エラーハンドラ
        \~english
        \brief Error handler
     */
@@ -70,10 +86,61 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief URG ZTǗ
+      \brief デコードする step の範囲
+      \~english
+      \brief Range of steps to decode
+    */
+    typedef struct
+    {
+        int first_step;         //!< \~japanese 開始 step  \~english First step
+        int last_step;          //!< \~japanese 終了 step  \~english Last step
+    } urg_step_region_t;
+
+
+    enum {
+        URG_SENSOR_INFO_SIZE = 64, //!< \~japanese センサ情報の文字列の最大長  \~english Maximum length of a sensor information string
+    };
+
+
+    /*!
+      \~japanese
+      \brief センサ情報
+
+      VV と II の応答の各項目を、末尾の ';' を除いて格納する。応答に含まれない項目は空文字列になる。
+
+      \~english
+      \brief Sensor information
+
+      Holds each field of the VV and II responses, without the trailing ';'. Fields missing from the responses are empty strings.
+    */
+    typedef struct urg_sensor_info
+    {
+        char vendor[URG_SENSOR_INFO_SIZE]; //!< \~japanese VV の VEND  \~english VEND of VV
+        char product_type[URG_SENSOR_INFO_SIZE]; //!< \~japanese VV の PROD  \~english PROD of VV
+        char firmware_version[URG_SENSOR_INFO_SIZE]; //!< \~japanese VV の FIRM の、日付より前  \~english FIRM of VV, before the date
+        char protocol_version[URG_SENSOR_INFO_SIZE]; //!< \~japanese VV の PROT  \~english PROT of VV
+        char serial_id[URG_SENSOR_INFO_SIZE]; //!< \~japanese VV の SERI  \~english SERI of VV
+
+        char model[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の MODL  \~english MODL of II
+        char laser_state[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の LASR  \~english LASR of II
+        char motor_speed[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の SCSP  \~english SCSP of II
+        char state[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の MESM  \~english MESM of II
+        char bitrate[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の SBPS  \~english SBPS of II
+        char time_stamp[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の TIME  \~english TIME of II
+        char status[URG_SENSOR_INFO_SIZE]; //!< \~japanese II の STAT  \~english STAT of II
+    } urg_sensor_info_t;
+
+
+    /*!
+      \~japanese
+      \brief URG センサ管理
+
+      シリアル接続とイーサーネット接続の受信バッファ (それぞれ 8 KB) を含むため、約 17 KB になる。関数のローカル変数にするときはスタックの大きさに注意すること。
 
       \~english
       \brief URG sensor control structure
+
+      It holds the receive buffers of the serial and Ethernet connections (8 KB each), about 17 KB in total. Mind the stack size when it is a local variable.
     */
     typedef struct
     {
@@ -104,8 +171,25 @@ extern "C" {
         int received_skip_step;
         urg_range_data_byte_t received_range_data_byte;
         int is_sending;
+        urg_receive_mode_t receive_mode;
+        int expected_frame_size;
 
         urg_error_handler error_handler;
+        const urg_step_region_t *decode_regions;
+        int decode_region_count;
+        uint32_t *validity_mask;
+        int validity_mask_size;
+        int is_resync_mode;
+        long dropped_frame_count;
+        int baudrate_settle_msec;
+
+        char command_echoback[URG_MAX_COMMAND_SIZE];
+        char *command_response;
+        int command_response_size;
+        int command_response_filled;
+        int command_response_lines;
+        int is_command_pending;
+        long command_deadline;
 
         char return_buffer[80];
     } urg_t;
@@ -113,25 +197,50 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ڑ
+      \brief エコーごとに分けたマルチエコーのデータ
 
-      w肵foCXɐڑAvł悤ɂB
+      距離と強度を、エコーの番号ごとの配列 (面) に step の順で格納する。echo_count[i] が i 番目の step のエコー数で、length[e][i], intensity[e][i] は e < echo_count[i] のときだけ有効になる。
 
-      \param[in,out] urg URG ZTǗ
-      \param[in] connection_type ʐM^Cv
-      \param[in] device_or_address ڑfoCX
-      \param[in] baudrate_or_port ڑ{[[g [bps] / TCP/IP |[g
+      NULL の配列には格納しない。最初のエコーだけが必要なら length[0] 以外を NULL にすればよい。
 
-      \retval 0 
-      \retval <0 G[
+      \~english
+      \brief Multiecho data split by echo
+
+      Distances and intensities are stored in one array (plane) per echo number, in step order. echo_count[i] is the number of echoes of the i-th step, and length[e][i], intensity[e][i] are valid only if e < echo_count[i].
+
+      NULL arrays are not written. If only the first echo is needed, set every array but length[0] to NULL.
+    */
+    typedef struct
+    {
+        unsigned char *echo_count;  //!< \~japanese step ごとのエコー数  \~english Number of echoes per step
+        uint32_t *length[URG_MAX_ECHO]; //!< \~japanese エコーごとの距離 [mm]  \~english Distances per echo [mm]
+        unsigned short *intensity[URG_MAX_ECHO]; //!< \~japanese エコーごとの強度  \~english Intensities per echo
+    } urg_multiecho_planes_t;
 
-      connection_type ɂ́Aȉ̍ڂwł܂B
+
+    /*!
+      \~japanese
+      \brief 接続
+
+      指定したデバイスに接続し、距離を計測できるようにする。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] connection_type 通信タイプ
+      \param[in] device_or_address 接続デバイス名
+      \param[in] baudrate_or_port 接続ボーレート [bps] / TCP/IP ポート
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      connection_type には、以下の項目が指定できます。
 
       - #URG_SERIAL
-      - VAAUSB ڑ
+      - シリアル、USB 接続
 
       - #URG_ETHERNET
-      - C[T[lbgڑ
+      - イーサーネット接続
+
+      イーサーネット接続ではボーレートの探索を行わず、RS と QT の応答の終端を内容で判定して接続するため、受信のタイムアウトを待ちません。
 
       \~english
       \brief Connect
@@ -153,6 +262,8 @@ extern "C" {
 
       - #URG_ETHERNET
       - Ethernet connection
+
+      For an Ethernet connection the baudrate is not probed. The end of the RS and QT responses is found by their content, so no receive timeout is waited for.
       \~
       Example
       \code
@@ -167,7 +278,7 @@ extern "C" {
       urg_close(&urg); \endcode
 
       \~japanese
-      \attention URG C Cȗ̊֐ĂяoOɁÅ֐ĂяoKv܂B
+      \attention URG C ライブラリの他の関数を呼び出す前に、この関数を呼び出す必要があります。
       \~english
       \attention Call this function before using any other function on the URG library.
 
@@ -181,11 +292,153 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ؒf
+      \brief オプションを指定しての接続
+
+      urg_open() に加え、受信バッファなどの接続オプションを指定できます。option に NULL を指定したときは urg_open() と同じ動作になります。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] connection_type 通信タイプ
+      \param[in] device_or_address 接続デバイス名
+      \param[in] baudrate_or_port 接続ボーレート [bps] / TCP/IP ポート
+      \param[in] option 接続オプション
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      受信バッファのサイズは urg_buffer_shift_length() で計測データ１回分を格納できる大きさを求められます。
+
+      イーサーネット接続では option->tcpclient で TCP_NODELAY, SO_RCVBUF, キープアライブ, SO_BUSY_POLL を指定できます。
+
+      connection_type に #URG_USER_TRANSPORT を指定すると、option->transport の通信手段で接続します。urg_memory.h の memory_transport を使うと、メモリ上の応答から計測データを受信できます。
+
+      \~english
+      \brief Connect with options
+
+      In addition to urg_open(), connection options such as the receive buffer can be specified. If option is NULL, works the same as urg_open().
+
+      \param[in,out] urg URG control structure
+      \param[in] connection_type Type of the connection
+      \param[in] device_or_address Name of the device
+      \param[in] baudrate_or_port Connection baudrate [bps] or TCP/IP port number
+      \param[in] option Connection options
+
+      \retval 0 Successful
+      \retval <0 Error
+
+      The receive buffer size which can hold one whole scan is obtained with urg_buffer_shift_length().
+
+      For Ethernet connections, TCP_NODELAY, SO_RCVBUF, keepalive and SO_BUSY_POLL can be set through option->tcpclient.
+
+      With #URG_USER_TRANSPORT as connection_type, the connection uses the transport given in option->transport. memory_transport of urg_memory.h receives the measurement data from responses in memory.
+      \~
+      Example
+      \code
+      enum { MAX_STEPS = 1081 };
+      urg_connection_option_t option;
+      int shift_length = urg_buffer_shift_length(MAX_STEPS,
+                                                 URG_MULTIECHO_INTENSITY);
+      char *buffer = malloc(1 << shift_length);
+
+      connection_option_initialize(&option);
+      option.buffer = buffer;
+      option.buffer_shift_length = shift_length;
+      option.tcpclient.no_delay = 1;
+      option.tcpclient.receive_buffer_size = 4 << shift_length;
+      option.tcpclient.keepalive_idle = 1;
+      option.tcpclient.keepalive_interval = 1;
+      option.tcpclient.keepalive_count = 3;
+      if (urg_open_with_option(&urg, URG_ETHERNET, "192.168.0.10", 10940,
+                               &option) < 0) {
+      return 1;
+      }
+
+      ...
+
+      urg_close(&urg);
+      free(buffer); \endcode
+
+      \~
+      \see urg_open(), urg_buffer_shift_length()
+    */
+    extern int urg_open_with_option(urg_t *urg,
+                                    urg_connection_type_t connection_type,
+                                    const char *device_or_address,
+                                    long baudrate_or_port,
+                                    const urg_connection_option_t *option);
+
+
+    /*!
+      \~japanese
+      \brief 接続情報のキャッシュを使った接続
 
-      [UAURG Ƃ̐ڑؒf܂B
+      urg_open_with_option() と同じく接続し、cache に device_or_address の接続情報があればそれを使う。
 
-      \param[in,out] urg URG ZTǗ
+      - シリアル接続では、記録したボーレートで、探索せずに接続を試みる。接続できないときは、通常どおりボーレートを探索する。
+      - VV で取得したシリアル番号が記録と一致するときは、PP の問い合わせを省き、記録したパラメータを使う。
+
+      接続できたときは、ボーレート、シリアル番号、パラメータを cache に記録する。cache をファイルに保存するときは urg_cache_save() を使う。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] connection_type 通信タイプ
+      \param[in] device_or_address 接続デバイス名
+      \param[in] baudrate_or_port 接続ボーレート [bps] / TCP/IP ポート
+      \param[in] option 接続オプション。NULL のときは既定値
+      \param[in,out] cache 接続情報のキャッシュ
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      \~english
+      \brief Connects using the cache of connection information
+
+      Connects as urg_open_with_option() does, and uses the information of device_or_address in cache if there is one.
+
+      - For a serial connection, the recorded baudrate is tried without probing. If that fails, the baudrate is probed as usual.
+      - If the serial id given by VV matches the recorded one, the PP query is skipped and the recorded parameters are used.
+
+      On success the baudrate, the serial id and the parameters are recorded in cache. Use urg_cache_save() to save cache to a file.
+
+      \param[in,out] urg URG control structure
+      \param[in] connection_type Type of the connection
+      \param[in] device_or_address Name of the device
+      \param[in] baudrate_or_port Connection baudrate [bps] or TCP/IP port number
+      \param[in] option Connection options, or NULL for the defaults
+      \param[in,out] cache Cache of connection information
+
+      \retval 0 Successful
+      \retval <0 Error
+      \~
+      Example
+      \code
+      urg_cache_t cache;
+
+      urg_cache_initialize(&cache);
+      urg_cache_load(&cache, "urg_cache.txt");
+
+      if (urg_open_with_cache(&urg, URG_SERIAL, "/dev/ttyACM0", 115200,
+                              NULL, &cache) < 0) {
+      return 1;
+      }
+      urg_cache_save(&cache, "urg_cache.txt"); \endcode
+
+      \~
+      \see urg_open_with_option()
+    */
+    extern int urg_open_with_cache(urg_t *urg,
+                                   urg_connection_type_t connection_type,
+                                   const char *device_or_address,
+                                   long baudrate_or_port,
+                                   const urg_connection_option_t *option,
+                                   urg_cache_t *cache);
+
+
+    /*!
+      \~japanese
+      \brief 切断
+
+      レーザを消灯し、URG との接続を切断します。
+
+      \param[in,out] urg URG センサ管理
 
       \~english
       \brief Disconnection
@@ -201,12 +454,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ^CAEgԂ̐ݒ
+      \brief タイムアウト時間の設定
 
-      \param[in,out] urg URG ZTǗ
-      \param[in] msec ^CAEg鎞 [msec]
+      \param[in,out] urg URG センサ管理
+      \param[in] msec タイムアウトする時間 [msec]
 
-      \attention urg_open() Ăяo timeout ̐ݒl̓ftHglɏ邽߁Å֐ urg_open() ɌĂяoƁB
+      \attention urg_open() を呼び出すと timeout の設定値はデフォルト値に初期化されるため、この関数は urg_open() 後に呼び出すこと。
       \~english
       \brief Defines the timeout value to use during communication
 
@@ -218,9 +471,109 @@ extern "C" {
     extern void urg_set_timeout_msec(urg_t *urg, int msec);
 
 
+    /*!
+      \~japanese
+      \brief 計測データの受信方法の設定
+
+      #URG_RECEIVE_FRAME を指定すると、計測データの応答全体 (空行まで) を受信バッファに受信してから、コピーせずにデコードする。受信バッファには応答全体が収まる大きさが必要であり、urg_buffer_shift_length() で求めたサイズのバッファを urg_open_with_option() で指定すること。
+
+      #URG_RECEIVE_EXACT_FRAME を指定すると、urg_start_measurement() の時点で計測範囲、まとめるステップ数、エンコードのバイト数、強度の有無から応答のバイト数を求め、そのバイト数をまとめて受信する。受信したデータが求めたバイト数の応答になっていないときは #URG_FRAMING_ERROR を返す。応答のバイト数が決まらないマルチエコーの計測は、urg_start_measurement() が #URG_INVALID_PARAMETER を返す。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] mode 受信方法
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      \attention urg_open() を呼び出すと受信方法は #URG_RECEIVE_LINE に初期化されるため、この関数は urg_open() 後に呼び出すこと。
+      \~english
+      \brief Defines how measurement data is received
+
+      With #URG_RECEIVE_FRAME, the whole measurement response (up to the empty line) is received into the receive buffer and then decoded without copying. The receive buffer must be large enough to hold the whole response; pass a buffer of the size given by urg_buffer_shift_length() to urg_open_with_option().
+
+      With #URG_RECEIVE_EXACT_FRAME, the byte length of the response is computed in urg_start_measurement() from the scanning range, the step grouping, the encoding size and the intensity, and that many bytes are received at once. If the received data is not a response of that length, #URG_FRAMING_ERROR is returned. For multiecho measurements, whose response length is not fixed, urg_start_measurement() returns #URG_INVALID_PARAMETER.
+
+      \param[in,out] urg URG control structure
+      \param[in] mode Receive mode
+
+      \retval 0 Successful
+      \retval <0 Error
+
+      \attention The urg_open() function always sets the receive mode to #URG_RECEIVE_LINE, if necessary call this function after urg_open().
+    */
+    extern int urg_set_receive_mode(urg_t *urg, urg_receive_mode_t mode);
+
+
+    /*!
+      \~japanese
+      \brief 連続計測中の受信エラーからの再同期の設定
+
+      is_enabled に 0 以外を指定すると、Mx, Nx の連続計測中にチェックサムの誤り、余分なデータ、エコーバックや応答の破損を検出したとき、QT で計測を止めずに、壊れた応答を次の空行 (LF LF) まで読み捨ててエラーを返す。次の呼び出しでは、その次の応答のエコーバックから受信を続ける。読み捨てた応答の数は urg_dropped_frame_count() で取得できる。
+
+      センサがエラーのステータスを返したときと、応答が受信バッファに収まらないときは、再同期せずにこれまでどおり計測を止める。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] is_enabled 再同期するとき 0 以外
+
+      \attention urg_open() を呼び出すと再同期は無効に初期化されるため、この関数は urg_open() 後に呼び出すこと。
+      \~english
+      \brief Defines whether receive errors are resynchronised during continuous measurement
+
+      With a non-zero is_enabled, when a checksum error, extra data, or a damaged echoback or status is detected during a Mx, Nx continuous measurement, the measurement is not stopped with QT. Instead the damaged response is skipped up to the next empty line (LF LF) and the error is returned. The next call resumes receiving from the echoback of the following response. The number of skipped responses is given by urg_dropped_frame_count().
+
+      When the sensor returns an error status, or a response does not fit in the receive buffer, the measurement is stopped as before.
+
+      \param[in,out] urg URG control structure
+      \param[in] is_enabled Non-zero to resynchronise
+
+      \attention The urg_open() function always disables the resynchronisation, if necessary call this function after urg_open().
+    */
+    extern void urg_set_resync_mode(urg_t *urg, int is_enabled);
+
+
+    /*!
+      \~japanese
+      \brief 再同期で読み捨てた応答の数
+
+      \param[in] urg URG センサ管理
+
+      \return urg_open() 以降に、urg_set_resync_mode() の再同期で読み捨てた応答の数
+
+      \~english
+      \brief Number of responses skipped by the resynchronisation
+
+      \param[in] urg URG control structure
+
+      \return Number of responses skipped by the resynchronisation of urg_set_resync_mode() since urg_open()
+    */
+    extern long urg_dropped_frame_count(const urg_t *urg);
+
+
+    /*!
+      \~japanese
+      \brief ボーレート変更の反映にかかった時間
+
+      urg_open() がセンサのボーレートを SS で変更したときは、新しいボーレートでセンサが QT に応答するまで、待ち時間を 8 msec から倍にしながら QT を送信する。この関数はその応答までの時間を返す。
+
+      \param[in] urg URG センサ管理
+
+      \return 直近の urg_open() でボーレートの変更後、センサが応答するまでの時間 [msec]。ボーレートを変更しなかったときは 0
+
+      \~english
+      \brief Time taken for a baudrate change to take effect
+
+      When urg_open() changes the sensor baudrate with SS, it sends QT until the sensor answers at the new baudrate, doubling the wait from 8 msec. This function returns the time until that answer.
+
+      \param[in] urg URG control structure
+
+      \return Time [msec] until the sensor answered after the baudrate change in the last urg_open(), or 0 if the baudrate was not changed
+    */
+    extern int urg_baudrate_settle_msec(const urg_t *urg);
+
+
     /*!
        \~japanese
-       \brief ^CX^v[h̊Jn
+       \brief タイムスタンプモードの開始
        \~english
        \brief Starts the timestamp mode (time adjustment state)
     */
@@ -229,12 +582,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ^CX^v̎擾
+      \brief タイムスタンプの取得
 
-      \param[in,out] urg URG ZTǗ
+      \param[in,out] urg URG センサ管理
 
-      \retval >=0 ^CX^v [msec]
-      \retval <0 G[
+      \retval >=0 タイムスタンプ [msec]
+      \retval <0 エラー
 
       \~english
       \brief Read timestamp data
@@ -254,7 +607,7 @@ extern "C" {
       after_ticks = get_pc_msec_function();
 
       \~japanese
-      // ^CX^vɂĂ̌vZ
+      // タイムスタンプについての計算
       \~english
       // Processing of timestamp data
       \~
@@ -263,7 +616,7 @@ extern "C" {
       urg_stop_time_stamp_mode(&urg); \endcode
 
       \~japanese
-      ڂ \ref sync_time_stamp.c QƂĉB
+      詳しくは \ref sync_time_stamp.c を参照して下さい。
       \~english
       For a detailed use consult the \ref sync_time_stamp.c example
     */
@@ -272,7 +625,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief ^CX^v[h̏I
+       \brief タイムスタンプモードの終了
        \~english
        \brief Stops the timestamp mode (returning to idle state)
     */
@@ -281,33 +634,35 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief f[^̎擾Jn
+      \brief 距離データの取得を開始
+
+      距離データの取得を開始します。実際のデータは urg_get_distance(), urg_get_distance_intensity(), urg_get_multiecho(), urg_get_multiecho_intensity() で取得できます。
 
-      f[^̎擾Jn܂Bۂ̃f[^ urg_get_distance(), urg_get_distance_intensity(), urg_get_multiecho(), urg_get_multiecho_intensity() Ŏ擾ł܂B
+      \param[in,out] urg URG センサ管理
+      \param[in] type データ・タイプ
+      \param[in] scan_times データの取得回数
+      \param[in] skip_scan データの取得間隔
 
-      \param[in,out] urg URG ZTǗ
-      \param[in] type f[^E^Cv
-      \param[in] scan_times f[^̎擾
-      \param[in] skip_scan f[^̎擾Ԋu
+      \retval 0 正常
+      \retval <0 エラー
 
-      \retval 0 
-      \retval <0 G[
+      type には取得するデータの種類を指定します。
 
-      type ɂ͎擾f[^̎ނw肵܂B
+      - #URG_DISTANCE ... 距離データ
+      - #URG_DISTANCE_INTENSITY ... 距離データと強度データ
+      - #URG_MULTIECHO ... マルチエコー版の距離データ
+      - #URG_MULTIECHO_INTENSITY ... マルチエコー版の(距離データと強度データ)
 
-      - #URG_DISTANCE ... f[^
-      - #URG_DISTANCE_INTENSITY ... f[^Ƌxf[^
-      - #URG_MULTIECHO ... }`GR[ł̋f[^
-      - #URG_MULTIECHO_INTENSITY ... }`GR[ł(f[^Ƌxf[^)
+      scan_times は何回のデータを取得するかを 0 以上の数で指定します。ただし、0 または #URG_SCAN_INFINITY を指定した場合は、無限回のデータを取得します。\n
+      開始した計測を中断するには urg_stop_measurement() を使います。
 
-      scan_times ͉̃f[^擾邩 0 ȏ̐Ŏw肵܂BA0 ܂ #URG_SCAN_INFINITY w肵ꍇ́Ãf[^擾܂B\n
-      Jnv𒆒fɂ urg_stop_measurement() g܂B
+      skip_scan はミラーの回転数のうち、１回のスキャン後に何回スキャンしないかを指定します。skip_scan に指定できる範囲は [0, 9] です。
 
-      skip_scan ̓~[̉]̂AP̃XLɉXLȂw肵܂Bskip_scan Ɏwł͈͂ [0, 9] łB
+      \image html skip_scan_image.png 何回に１回だけ計測するか
 
-      \image html skip_scan_image.png ɂP񂾂v邩
+      たとえば、ミラーの１回転が 100 [msec] のセンサで skip_scan に 1 を指定した場合、データの取得間隔は 200 [msec] になります。
 
-      Ƃ΁A~[̂P] 100 [msec] ̃ZT skip_scan  1 w肵ꍇAf[^̎擾Ԋu 200 [msec] ɂȂ܂B
+      \attention urg_set_receive_mode() で #URG_RECEIVE_EXACT_FRAME を指定しているときは、#URG_MULTIECHO, #URG_MULTIECHO_INTENSITY の計測は開始できず、#URG_INVALID_PARAMETER を返します。
 
       \~english
       \brief Start getting distance measurement data
@@ -339,6 +694,8 @@ extern "C" {
 
       For example, for a sensor with one mirror (motor) revolution is 100 [msec] and skip_scan is set to 1, measurement data will be obtained with an interval of 200 [msec].
 
+      \attention When #URG_RECEIVE_EXACT_FRAME is set with urg_set_receive_mode(), #URG_MULTIECHO and #URG_MULTIECHO_INTENSITY measurements cannot be started and #URG_INVALID_PARAMETER is returned.
+
       \~
       Example
       \code
@@ -349,7 +706,7 @@ extern "C" {
       int n = urg_get_distance(&urg, data, &time_stamp);
 
       \~japanese
-      // Mf[^̗p
+      // 受信したデータの利用
       \~english
       // Processing of obtained data
       \~
@@ -365,20 +722,20 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief f[^̎擾
+      \brief 距離データの取得
 
-      ZT狗f[^擾܂BO urg_start_measurement()  #URG_DISTANCE wŌĂяoĂKv܂B
+      センサから距離データを取得します。事前に urg_start_measurement() を #URG_DISTANCE 指定で呼び出しておく必要があります。
 
-      \param[in,out] urg URG ZTǗ
-      \param[out] data f[^ [mm]
-      \param[out] time_stamp ^CX^v [msec]
+      \param[in,out] urg URG センサ管理
+      \param[out] data 距離データ [mm]
+      \param[out] time_stamp タイムスタンプ [msec]
 
-      \retval >=0 Mf[^
-      \retval <0 G[
+      \retval >=0 受信したデータ個数
+      \retval <0 エラー
 
-      data ɂ́AZT擾f[^i[܂Bdata ̓f[^i[̃TCYmۂĂKv܂Bdata Ɋi[f[^ urg_max_data_size() Ŏ擾ł܂B
+      data には、センサから取得した距離データが格納されます。data はデータを格納するのサイズを確保しておく必要があります。data に格納されるデータ数は urg_max_data_size() で取得できます。
 
-      time_stamp ɂ́AZT̃^CX^vi[܂Btime_stamp 擾Ȃꍇ NULL w肵ĉB
+      time_stamp には、センサ内部のタイムスタンプが格納されます。time_stamp を取得したくない場合 NULL を指定して下さい。
 
       \~english
       \brief Gets distance data
@@ -404,7 +761,7 @@ extern "C" {
       ...
 
       \~japanese
-      // f[^̂ݎ擾
+      // データのみ取得する
       \~english
       // Gets only measurement data
       urg_start_measurement(&urg, URG_DISTANCE, 1, 0);
@@ -413,7 +770,7 @@ extern "C" {
       ...
 
       \~japanese
-      // f[^ƃ^CX^v擾
+      // データとタイムスタンプを取得する
       \~english
       // Gets measurement data and timestamp
       long time_stamp;
@@ -428,23 +785,23 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief Ƌxf[^̎擾
+      \brief 距離と強度データの取得
 
-      urg_get_distance() ɉAxf[^̎擾ł֐łBO urg_start_measurement()  #URG_DISTANCE_INTENSITY wŌĂяoĂKv܂B
+      urg_get_distance() に加え、強度データの取得ができる関数です。事前に urg_start_measurement() を #URG_DISTANCE_INTENSITY 指定で呼び出しておく必要があります。
 
-      \param[in,out] urg URG ZTǗ
-      \param[out] data f[^ [mm]
-      \param[out] intensity xf[^
-      \param[out] time_stamp ^CX^v [msec]
+      \param[in,out] urg URG センサ管理
+      \param[out] data 距離データ [mm]
+      \param[out] intensity 強度データ
+      \param[out] time_stamp タイムスタンプ [msec]
 
-      \retval >=0 Mf[^
-      \retval <0 G[
+      \retval >=0 受信したデータ個数
+      \retval <0 エラー
 
-      xf[^Ƃ́AvZɎgg`̔ˋxłAZT̃V[YɓقȂ܂B xf[^gƂŁÂ̔˗̑܂ȔZW𐄑ł܂B
+      強度データとは、距離計算に使った波形の反射強度であり、センサのシリーズ毎に特性が異なります。 強度データを使うことで、物体の反射率や環境の大まかな濃淡を推測できます。
 
-      data, time_stamp ɂĂ urg_get_distance() ƓłB
+      data, time_stamp については urg_get_distance() と同じです。
 
-      intensity ɂ́AZT擾xf[^i[܂Bintensity ̓f[^i[̃TCYmۂĂKv܂Bintensity Ɋi[f[^ urg_max_data_size() Ŏ擾ł܂B
+      intensity には、センサから取得した強度データが格納されます。intensity はデータを格納するのサイズを確保しておく必要があります。intensity に格納されるデータ数は urg_max_data_size() で取得できます。
 
       \~english
       \brief Gets distance and intensity data
@@ -487,36 +844,36 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief f[^̎擾 (}`GR[)
+      \brief 距離データの取得 (マルチエコー版)
 
-      }`GR[ł̋f[^擾֐łBO urg_start_measurement()  #URG_MULTIECHO wŌĂяoĂKv܂B
+      マルチエコー版の距離データ取得関数です。事前に urg_start_measurement() を #URG_MULTIECHO 指定で呼び出しておく必要があります。
 
-      \param[in,out] urg URG ZTǗ
-      \param[out] data_multi f[^ [mm]
-      \param[out] time_stamp ^CX^v [msec]
+      \param[in,out] urg URG センサ管理
+      \param[out] data_multi 距離データ [mm]
+      \param[out] time_stamp タイムスタンプ [msec]
 
-      \retval >=0 Mf[^
-      \retval <0 G[
+      \retval >=0 受信したデータ個数
+      \retval <0 エラー
 
-      }`GR[Ƃ͕̋f[^łB }`GR[́AP̃[Uɂĕ̋f[^ꂽƂɓ܂B
+      マルチエコーとは複数の距離データです。 マルチエコーは、１つのレーザ発光において複数の距離データが得られたときに得られます。
 
-      \image html multiecho_image.png }`GR[̃C[W}
+      \image html multiecho_image.png マルチエコーのイメージ図
 
-      time_stamp ɂĂ urg_get_distance() ƓłB
+      time_stamp については urg_get_distance() と同じです。
 
-      data_multi ɂ́AZT擾f[^P step ő #URG_MAX_ECHO (3 )i[܂B}`GR[݂Ȃڂ̃f[^l -1 i[Ă܂B
+      data_multi には、センサから取得した距離データが１つの step あたり最大で #URG_MAX_ECHO (3 つ)格納されます。マルチエコーが存在しない項目のデータ値は -1 が格納されています。
 
       \verbatim
-      data_multi[0] ... step n ̋f[^ (1 )
-      data_multi[1] ... step n ̋f[^ (2 )
-      data_multi[2] ... step n ̋f[^ (3 )
-      data_multi[3] ... step (n + 1)  f[^ (1 )
-      data_multi[4] ... step (n + 1)  f[^ (2 )
-      data_multi[5] ... step (n + 1)  f[^ (3 )
+      data_multi[0] ... step n の距離データ (1 つめ)
+      data_multi[1] ... step n の距離データ (2 つめ)
+      data_multi[2] ... step n の距離データ (3 つめ)
+      data_multi[3] ... step (n + 1) の 距離データ (1 つめ)
+      data_multi[4] ... step (n + 1) の 距離データ (2 つめ)
+      data_multi[5] ... step (n + 1) の 距離データ (3 つめ)
       ... \endverbatim
 
-      i[́Ae step ɂ urg_get_distance() ̂ƂƓ̃f[^ (3n + 0) ̈ʒuɊi[AȊÕf[^ (3n + 1), (3n + 2) ̈ʒuɍ~Ɋi[܂B\n
-      ܂ data_multi[3n + 1] >= data_multi[3n + 2] ɂȂ邱Ƃ͕ۏ؂܂ data_multi[3n + 0]  data_multi[3n + 1] ̊֌W͖`łB(data_multi[3n + 1] == data_multi[3n + 2] 藧̂̓f[^l -1 ̂ƂB)
+      格納順は、各 step において urg_get_distance() のときと同じ距離のデータが (3n + 0) の位置に格納され、それ以外のデータが (3n + 1), (3n + 2) の位置に降順に格納されます。\n
+      つまり data_multi[3n + 1] >= data_multi[3n + 2] になることは保証されますが data_multi[3n + 0] と data_multi[3n + 1] の関係は未定義です。(data_multi[3n + 1] == data_multi[3n + 2] が成り立つのはデータ値が -1 のとき。)
 
       \~english
       \brief Gets distance data (multiecho mode)
@@ -568,21 +925,21 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief Ƌxf[^̎擾 (}`GR[)
+      \brief 距離と強度データの取得 (マルチエコー版)
 
-      urg_get_multiecho() ɉAxf[^̎擾ł֐łBO urg_start_measurement()  #URG_MULTIECHO_INTENSITY wŌĂяoĂKv܂B
+      urg_get_multiecho() に加え、強度データの取得できる関数です。事前に urg_start_measurement() を #URG_MULTIECHO_INTENSITY 指定で呼び出しておく必要があります。
 
-      \param[in,out] urg URG ZTǗ
-      \param[out] data_multi f[^ [mm]
-      \param[out] intensity_multi xf[^
-      \param[out] time_stamp ^CX^v [msec]
+      \param[in,out] urg URG センサ管理
+      \param[out] data_multi 距離データ [mm]
+      \param[out] intensity_multi 強度データ
+      \param[out] time_stamp タイムスタンプ [msec]
 
-      \retval >=0 Mf[^
-      \retval <0 G[
+      \retval >=0 受信したデータ個数
+      \retval <0 エラー
 
-      data_multi, time_stamp ɂĂ urg_get_multiecho() ƓłB
+      data_multi, time_stamp については urg_get_multiecho() と同じです。
 
-      intensity_multi ̃f[^̕т data_multi ƑΉ̂ɂȂ܂Bintensity_multi Ɋi[f[^ urg_max_data_size() Ŏ擾ł܂B
+      intensity_multi のデータの並びは data_multi と対応したものになります。intensity_multi に格納されるデータ数は urg_max_data_size() で取得できます。
 
       \~english
       \brief Gets distance and intensity data (multiecho mode)
@@ -623,14 +980,247 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief v𒆒fA[U܂
+      \brief 距離データの取得 (uint32_t 版)
 
-      \ref urg_start_measurement() ̌v𒆒f܂B
+      urg_get_distance(), urg_get_distance_intensity(), urg_get_multiecho(), urg_get_multiecho_intensity() と同じデータを、long ではなく uint32_t の配列に格納します。引数、戻り値、データの並びはそれぞれ long 版と同じです。
 
-      \param[in,out] urg URG ZTǗ
+      long が 8 byte の環境では、データを格納する領域が半分になります。
 
-      \retval 0 
-      \retval <0 G[
+      \~english
+      \brief Gets distance data (uint32_t version)
+
+      Stores the same data as urg_get_distance(), urg_get_distance_intensity(), urg_get_multiecho() and urg_get_multiecho_intensity() in a uint32_t array instead of long. The arguments, return values and data order are the same as in the long versions.
+
+      Where long is 8 bytes, this halves the size of the data buffers.
+      \~
+      Example
+      \code
+      uint32_t *data = malloc(urg_max_data_size(&urg) * sizeof(uint32_t));
+
+      ...
+
+      urg_start_measurement(&urg, URG_DISTANCE, 1, 0);
+      int n = urg_get_distance_uint32(&urg, data, NULL); \endcode
+
+      \~
+      \see urg_get_distance(), urg_get_distance_uint16()
+    */
+    extern int urg_get_distance_uint32(urg_t *urg, uint32_t data[],
+                                       long *time_stamp);
+
+    //! \~japanese urg_get_distance_intensity() の uint32_t 版  \~english uint32_t version of urg_get_distance_intensity()
+    extern int urg_get_distance_intensity_uint32(urg_t *urg, uint32_t data[],
+                                                 unsigned short intensity[],
+                                                 long *time_stamp);
+
+    //! \~japanese urg_get_multiecho() の uint32_t 版  \~english uint32_t version of urg_get_multiecho()
+    extern int urg_get_multiecho_uint32(urg_t *urg, uint32_t data_multi[],
+                                        long *time_stamp);
+
+    //! \~japanese urg_get_multiecho_intensity() の uint32_t 版  \~english uint32_t version of urg_get_multiecho_intensity()
+    extern int urg_get_multiecho_intensity_uint32(urg_t *urg,
+                                                  uint32_t data_multi[],
+                                                  unsigned short
+                                                  intensity_multi[],
+                                                  long *time_stamp);
+
+
+    /*!
+      \~japanese
+      \brief 距離データの取得 (uint16_t 版)
+
+      urg_get_distance() と同じデータを uint16_t の配列に格納します。urg_set_communication_data_size() で #URG_COMMUNICATION_2_BYTE を指定したときの距離 (最大 4095) を格納するためのものです。3 byte で受信した 65535 より大きな距離は 65535 として格納されます。
+
+      \~english
+      \brief Gets distance data (uint16_t version)
+
+      Stores the same data as urg_get_distance() in a uint16_t array. It is meant for the distances received after #URG_COMMUNICATION_2_BYTE was set with urg_set_communication_data_size(), which are at most 4095. Distances larger than 65535 received in 3 bytes are stored as 65535.
+      \~
+      \see urg_get_distance(), urg_set_communication_data_size()
+    */
+    extern int urg_get_distance_uint16(urg_t *urg, uint16_t data[],
+                                       long *time_stamp);
+
+
+    /*!
+      \~japanese
+      \brief マルチエコーのデータをエコーごとに取得
+
+      urg_get_multiecho(), urg_get_multiecho_intensity() と同じデータを、step あたり #URG_MAX_ECHO 個の領域に並べずに、planes のエコーごとの配列に格納します。存在しないエコーの領域は埋めません。
+
+      \param[in,out] urg URG センサ管理
+      \param[out] planes データの格納先
+      \param[out] time_stamp タイムスタンプ [msec]
+
+      \retval >=0 受信した step の個数
+      \retval <0 エラー
+
+      各配列には urg_max_data_size() 個のデータを格納できること。intensity は #URG_MULTIECHO_INTENSITY で計測したときのみ格納されます。
+
+      \~english
+      \brief Gets multiecho data split by echo
+
+      Stores the same data as urg_get_multiecho() and urg_get_multiecho_intensity() in the per-echo arrays of planes, instead of #URG_MAX_ECHO slots per step. The slots of missing echoes are not filled.
+
+      \param[in,out] urg URG control structure
+      \param[out] planes Destination of the data
+      \param[out] time_stamp Timestamp [msec]
+
+      \retval >=0 Number of steps received
+      \retval <0 Error
+
+      Each array must hold urg_max_data_size() elements. intensity is stored only when measuring with #URG_MULTIECHO_INTENSITY.
+      \~
+      Example
+      \code
+      int data_size = urg_max_data_size(&urg);
+      urg_multiecho_planes_t planes;
+
+      memset(&planes, 0, sizeof(planes));
+      planes.echo_count = malloc(data_size);
+      planes.length[0] = malloc(data_size * sizeof(uint32_t));
+
+      ...
+
+      urg_start_measurement(&urg, URG_MULTIECHO, 1, 0);
+      int n = urg_get_multiecho_planes(&urg, &planes, NULL); \endcode
+
+      \~
+      \see urg_get_multiecho(), urg_get_multiecho_intensity()
+    */
+    extern int urg_get_multiecho_planes(urg_t *urg,
+                                        urg_multiecho_planes_t *planes,
+                                        long *time_stamp);
+
+
+    /*!
+      \~japanese
+      \brief 計測データの応答をデコードせずに取得
+
+      センサから受信した計測データの応答を、エコーバック、ステータス、タイムスタンプ、データの各行と最後の空行を含めて、デコードせずに frame に格納します。全ての行のチェックサムは評価済みです。記録した応答は urg_decode_raw_frame() で後からデコードできます。
+
+      \param[in,out] urg URG センサ管理
+      \param[out] frame 応答の格納先
+      \param[in] max_size frame のバイト数
+      \param[out] type 計測データの種類。不要なときは NULL
+      \param[out] time_stamp タイムスタンプ [msec]。不要なときは NULL
+
+      \retval >0 応答のバイト数
+      \retval 0 QT の応答を受信した
+      \retval <0 エラー
+
+      応答が max_size に収まらないときは、frame に格納せずに応答のバイト数 (max_size より大きな値) を返します。応答は受信バッファに残るため、そのバイト数以上の frame で再度呼び出すと取得できます。type, time_stamp はこのときも格納します。
+
+      \~english
+      \brief Gets the measurement response without decoding it
+
+      Stores the measurement response received from the sensor in frame without decoding it, including the echoback, status, timestamp and data lines and the final empty line. The checksums of all the lines have been validated. The stored response can be decoded later with urg_decode_raw_frame().
+
+      \param[in,out] urg URG control structure
+      \param[out] frame Destination of the response
+      \param[in] max_size Size of frame in bytes
+      \param[out] type Type of the measurement data, or NULL if not needed
+      \param[out] time_stamp Timestamp [msec], or NULL if not needed
+
+      \retval >0 Size of the response in bytes
+      \retval 0 The QT response was received
+      \retval <0 Error
+
+      If the response does not fit in max_size, it is not stored in frame and its size (larger than max_size) is returned. The response is left in the receive buffer, so calling again with a frame of at least that size obtains it. type and time_stamp are stored in this case as well.
+      \~
+      Example
+      \code
+      char frame[8192];
+      long time_stamp;
+
+      urg_start_measurement(&urg, URG_DISTANCE, URG_SCAN_INFINITY, 0);
+      while (1) {
+          int n = urg_get_raw_frame(&urg, frame, sizeof(frame),
+                                    NULL, &time_stamp);
+          if (n > 0) {
+              fwrite(frame, 1, n, log_file);
+          }
+      } \endcode
+
+      \~
+      \see urg_decode_raw_frame()
+    */
+    extern int urg_get_raw_frame(urg_t *urg, char frame[], int max_size,
+                                 urg_measurement_type_t *type,
+                                 long *time_stamp);
+
+
+    /*!
+      \~japanese
+      \brief 記録した応答のデコード
+
+      urg_get_raw_frame() で取得した応答をデコードし、urg_get_distance() などと同じ形式で data, intensity に格納します。urg はセンサパラメータを読むだけで変更しないため、計測中の urg でも使えます。センサに接続していない urg でも使えます。
+
+      urg_set_decode_regions() の範囲と urg_set_validity_mask() の有効ビットは適用せず、全ての step をデコードします。応答を記録したときと同じ urg_set_scanning_parameter() の設定であれば、urg_utils.h の角度変換はそのまま使えます。
+
+      \param[in] urg URG センサ管理
+      \param[in] frame 応答
+      \param[in] frame_size frame のバイト数
+      \param[out] data 距離データ [mm]
+      \param[out] intensity 強度データ。不要なときは NULL
+      \param[out] time_stamp タイムスタンプ [msec]。不要なときは NULL
+
+      \retval >=0 デコードしたデータ個数
+      \retval <0 エラー
+
+      \~english
+      \brief Decodes a stored response
+
+      Decodes a response obtained with urg_get_raw_frame() and stores it in data and intensity in the same format as urg_get_distance() and the others. urg is only read for the sensor parameters and is not modified, so a measuring urg can be used. urg does not need to be connected to a sensor.
+
+      The ranges of urg_set_decode_regions() and the validity mask of urg_set_validity_mask() are not applied, and every step is decoded. The angle conversions of urg_utils.h can be used as usual if urg_set_scanning_parameter() has the same setting as when the response was stored.
+
+      \param[in] urg URG control structure
+      \param[in] frame Response
+      \param[in] frame_size Size of frame in bytes
+      \param[out] data Distance data [mm]
+      \param[out] intensity Intensity data, or NULL if not needed
+      \param[out] time_stamp Timestamp [msec], or NULL if not needed
+
+      \retval >=0 Number of decoded data
+      \retval <0 Error
+      \~
+      \see urg_get_raw_frame()
+    */
+    extern int urg_decode_raw_frame(const urg_t *urg,
+                                    const char frame[], int frame_size,
+                                    long data[], unsigned short intensity[],
+                                    long *time_stamp);
+
+    //! \~japanese urg_decode_raw_frame() の uint32_t 版  \~english uint32_t version of urg_decode_raw_frame()
+    extern int urg_decode_raw_frame_uint32(const urg_t *urg,
+                                           const char frame[], int frame_size,
+                                           uint32_t data[],
+                                           unsigned short intensity[],
+                                           long *time_stamp);
+
+    //! \~japanese urg_decode_raw_frame() の uint16_t 版。65535 より大きな距離は 65535 になる  \~english uint16_t version of urg_decode_raw_frame(). Distances larger than 65535 become 65535
+    extern int urg_decode_raw_frame_uint16(const urg_t *urg,
+                                           const char frame[], int frame_size,
+                                           uint16_t data[], long *time_stamp);
+
+    //! \~japanese urg_decode_raw_frame() のエコーごとの配列版。urg_get_multiecho_planes() と同じ形式で格納する  \~english Per-echo array version of urg_decode_raw_frame(), stored as with urg_get_multiecho_planes()
+    extern int urg_decode_raw_frame_planes(const urg_t *urg,
+                                           const char frame[], int frame_size,
+                                           urg_multiecho_planes_t *planes,
+                                           long *time_stamp);
+
+
+    /*!
+      \~japanese
+      \brief 計測を中断し、レーザを消灯させます
+
+      \ref urg_start_measurement() の計測を中断します。
+
+      \param[in,out] urg URG センサ管理
+
+      \retval 0 正常
+      \retval <0 エラー
 
       \~english
       \brief Stops measurement process and turns off the laser.
@@ -659,40 +1249,40 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief v͈͂ݒ肵܂
+      \brief 計測範囲を設定します
 
-      ZTv͈͂ step lŎw肵܂Burg_get_distance() Ȃǂ̋f[^擾̊֐ŕԂf[^́AŎw肵͈͂Ő܂B
+      センサが計測する範囲を step 値で指定します。urg_get_distance() などの距離データ取得の関数で返されるデータ数は、ここで指定した範囲で制限されます。
 
-      \param[in,out] urg URG ZTǗ
-      \param[in] first_step v̊Jn step
-      \param[in] last_step v̏I step
-      \param[in] skip_step vf[^O[sO
+      \param[in,out] urg URG センサ管理
+      \param[in] first_step 計測の開始 step
+      \param[in] last_step 計測の終了 step
+      \param[in] skip_step 計測データをグルーピングする個数
 
-      \retval 0 
-      \retval <0 G[
+      \retval 0 正常
+      \retval <0 エラー
 
-      ZT step ́AZTʂ 0 ƂAZT㕔猩Ĕv܂̌̒lƂȂ鏇ɊU܂B
+      センサの step は、センサ正面を 0 とし、センサ上部から見て反時計まわりの向きが正の値となる順に割り振られます。
 
-      \image html sensor_angle_image.png ZT step ̊֌W
+      \image html sensor_angle_image.png センサと step の関係
 
-      step ̊ԊuƁAőlAŏl̓ZTˑłBstep l̍őlAŏl urg_step_min_max() Ŏ擾ł܂B\n
+      step の間隔と、最大値、最小値はセンサ依存です。step 値の最大値、最小値は urg_step_min_max() で取得できます。\n
 
-      first_step, last_step Ńf[^̌v͈͂w肵܂Bv͈͂ [first_step, last_step] ƂȂ܂B
+      first_step, last_step でデータの計測範囲を指定します。計測範囲は [first_step, last_step] となります。
 
-      skip_step ́Avf[^O[sOw肵܂Bwłl [0, 99] łB\n
-      skip_step ́Aw肳ꂽ̃f[^ 1 ɂ܂Ƃ߂邱ƂŁAZTMf[^ʂ炵A擾s֐̉߂ƂɎg܂BAf[^܂Ƃ߂邽߁Af[^̕\͌܂B
+      skip_step は、計測データをグルーピングする個数を指定します。指定できる値は [0, 99] です。\n
+      skip_step は、指定された数のデータを 1 つにまとめることで、センサから受信するデータ量を減らし、距離取得を行う関数の応答性を高めるときに使います。ただし、データをまとめるため、得られるデータの分解能は減ります。
 
-      ႦΈȉ̂悤ȋf[^ꍇ
+      例えば以下のような距離データが得られる場合に
       \verbatim
       100, 101, 102, 103, 104, 105, 106, 107, 108, 109
       \endverbatim
 
-      skip_step  2 w肷ƁAf[^
+      skip_step に 2 を指定すると、得られるデータは
       \verbatim
       100, 102, 104, 106, 108
       \endverbatim
 
-      f[^́A܂Ƃ߂f[^̂AԏȒl̃f[^p܂B
+      データは、まとめるデータのうち、一番小さな値のデータが用いられます。
 
       \~japanese
       \brief Configure measurement parameters
@@ -713,7 +1303,7 @@ extern "C" {
 
       The spacing between steps, the minimum and maximum step numbers depend on the sensor. Use urg_step_min_max() to get the minimum and maximum step values.\n
 
-      first_step and last_step define the data measurement scope ([first_step, last_step])B
+      first_step and last_step define the data measurement scope ([first_step, last_step])。
 
       skip_step allows setting a step grouping factor, where valid values are [0, 99].\n
       With the skip_step parameter, several adjacent steps are grouped and combined into 1 single step, thus the amount of data transmitted from the sensor is reduced and so the response time of measurement data adquisition functions. Of course, grouping several steps into one means the measurement resolution is reduced.
@@ -749,23 +1339,132 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ʐMf[^̃TCYύX
+      \brief デコードする step の範囲を指定
 
-      f[^ZTM̍ۂ̃f[^TCYύX܂B
+      受信したデータのうち、regions のいずれかの範囲に含まれる step だけをデコードして格納します。範囲外の step はデコードせず、格納先の値も変更しません。チェックサムと応答の形式は、範囲外のデータも含めて評価します。
 
-      \param[in,out] urg URG ZTǗ
-      \param[in] data_byte l\f[^̃oCg
+      urg_set_scanning_parameter() とは異なりセンサへの要求は変わらないため、全ての step を受信しながら、一部の範囲だけを使うときに用います。
 
-      \retval 0 
-      \retval <0 G[
+      範囲外の step の距離と強度は 0 で埋めず、前回の値のまま残ります。マルチエコーでは #URG_MAX_ECHO 個の領域全てがそのまま残ります。urg_get_multiecho_planes() の echo_count だけは 0 になり、有効ビット (urg_set_validity_mask()) は 0 になります。範囲外のインデックスを参照するときは、格納先を事前に初期化しておくこと。
 
-      data_byte ɂ
+      \param[in,out] urg URG センサ管理
+      \param[in] regions デコードする step の範囲の配列
+      \param[in] region_count regions の個数。0 のときは全ての step をデコードする
 
-      - URG_COMMUNICATION_3_BYTE ...  3 byte ŕ\
-      - URG_COMMUNICATION_2_BYTE ...  2 byte ŕ\
+      \retval 0 正常
+      \retval <0 エラー
 
-      wł܂B\n
-      Ԃł͋ 3 byte ŕ\悤ɂȂĂ܂B̐ݒ 2 byte ɐݒ肷邱ƂŁAZTMf[^ 2/3 ɂȂ܂BA擾ł鋗̍ől 4095 ɂȂ邽߁AϑΏۂ 4 [m] ȓ͈̔͂ɑ݂ꍇ̂ݗpĉB
+      step は urg_set_scanning_parameter() と同じく、センサ正面を 0 とした値です。regions はこの関数の後も参照されるため、解除するまで有効にしておくこと。urg_decode_raw_frame(), urg_parser_feed() のデコードには適用されません。
+
+      \~english
+      \brief Sets the ranges of steps to decode
+
+      Only the received steps within one of the ranges in regions are decoded and stored. Steps outside are neither decoded nor stored, and the destination keeps its values. Checksums and the response format are still validated for all the data.
+
+      Unlike urg_set_scanning_parameter(), the request to the sensor does not change. It is used when all the steps are received but only some ranges are needed.
+
+      The distances and intensities of steps outside the ranges are not filled with 0; they are left untouched and keep their previous values. For multiecho, all #URG_MAX_ECHO slots are left untouched. Only echo_count of urg_get_multiecho_planes() is set to 0, and the validity bits (urg_set_validity_mask()) are 0. Initialize the destination beforehand if indexes outside the ranges are read.
+
+      \param[in,out] urg URG control structure
+      \param[in] regions Array of ranges of steps to decode
+      \param[in] region_count Number of regions. If 0, all the steps are decoded
+
+      \retval 0 Successful
+      \retval <0 Error
+
+      Steps are counted from the front of the sensor, as in urg_set_scanning_parameter(). regions is referenced after this call and must stay valid until it is cleared. It does not apply to the decoding of urg_decode_raw_frame() and urg_parser_feed().
+      \~
+      Example
+      \code
+      urg_step_region_t regions[] = { { -100, -50 }, { 50, 100 } };
+      urg_set_decode_regions(&urg, regions, 2);
+
+      ...
+
+      int n = urg_get_distance(&urg, data, NULL); \endcode
+
+      \~
+      \see urg_set_scanning_parameter()
+    */
+    extern int urg_set_decode_regions(urg_t *urg,
+                                      const urg_step_region_t regions[],
+                                      int region_count);
+
+
+    /*!
+      \~japanese
+      \brief 距離データの有効ビットの出力先を指定
+
+      計測データをデコードするときに、同じ走査で、データのインデックスごとに距離が min_distance 以上なら 1、未満 (センサのエラーコード) なら 0 となるビットを mask に格納します。インデックス i のビットは mask[i / 32] の (i % 32) ビット目です。比較は分岐せずに行います。
+
+      マルチエコーでは、step ごとに最初のエコーの距離で判定します。urg_set_decode_regions() の範囲外の step と、受信しなかったインデックスのビットは 0 になります。
+
+      \param[in,out] urg URG センサ管理
+      \param[out] mask 有効ビットの格納先。(max_data_size + 31) / 32 個の要素が必要
+      \param[in] max_data_size ビットを格納するデータの最大個数。0 のときは格納しない
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      mask はこの関数の後も参照されるため、解除するまで有効にしておくこと。urg_decode_raw_frame(), urg_parser_feed() のデコードには適用されません。
+
+      \~english
+      \brief Sets where the validity bits of the distances are stored
+
+      While the measurement data is decoded, a bit is stored in mask for each data index in the same pass. The bit is 1 if the distance is at least min_distance, and 0 if it is below (a sensor error code). The bit of index i is bit (i % 32) of mask[i / 32]. The comparison is made without branching.
+
+      For multiecho, each step is judged by the distance of its first echo. Steps outside the ranges of urg_set_decode_regions() and indexes that were not received get a 0 bit.
+
+      \param[in,out] urg URG control structure
+      \param[out] mask Destination of the validity bits. Needs (max_data_size + 31) / 32 elements
+      \param[in] max_data_size Maximum number of data to store bits for. If 0, no bits are stored
+
+      \retval 0 Successful
+      \retval <0 Error
+
+      mask is referenced after this call and must stay valid until it is cleared. It does not apply to the decoding of urg_decode_raw_frame() and urg_parser_feed().
+      \~
+      Example
+      \code
+      int max_data_size = urg_max_data_size(&urg);
+      uint32_t *mask = (uint32_t*)malloc((max_data_size + 31) / 32 * sizeof(mask[0]));
+      urg_set_validity_mask(&urg, mask, max_data_size);
+
+      ...
+
+      int n = urg_get_distance(&urg, data, NULL);
+      for (i = 0; i < (n + 31) / 32; ++i) {
+          uint32_t bits = mask[i];
+          while (bits) {
+              uint32_t lowest = bits & (~bits + 1);
+              ...
+              bits ^= lowest;
+          }
+      } \endcode
+    */
+    extern int urg_set_validity_mask(urg_t *urg, uint32_t mask[],
+                                     int max_data_size);
+
+
+    /*!
+      \~japanese
+      \brief 通信データのサイズ変更
+
+      距離データをセンサから受信の際のデータサイズを変更します。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] data_byte 距離値を表現するデータのバイト数
+
+      \retval 0 成功
+      \retval <0 エラー
+
+      data_byte には
+
+      - URG_COMMUNICATION_3_BYTE ... 距離を 3 byte で表現する
+      - URG_COMMUNICATION_2_BYTE ... 距離を 2 byte で表現する
+
+      を指定できます。\n
+      初期状態では距離を 3 byte で表現するようになっています。この設定を 2 byte に設定することで、センサから受信するデータ数は 2/3 になります。ただし、取得できる距離の最大値が 4095 になるため、観測したい対象が 4 [m] 以内の範囲に存在する場合のみ利用して下さい。
 
       \~english
       \brief Change the size (number of bytes) of measurement data used during communications.
@@ -793,7 +1492,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief [U𔭌
+       \brief レーザを発光させる
        \~english
        \brief Turns on the laser
     */
@@ -802,7 +1501,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief [U
+       \brief レーザを消灯する
        \~english
        \brief Turns off the laser
     */
@@ -811,7 +1510,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief ZTċN
+       \brief センサを再起動する
        \~english
        \brief Reboots the sensor
     */
@@ -820,15 +1519,15 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZTd͂̏ԂɑJڂ
+      \brief センサを低消費電力の状態に遷移させる
 
-      d͂̃[hł́AXLỉ]~vf܂B
+      低消費電力のモードでは、スキャナの回転が停止し計測も中断されます。
 
-      - d͂̃[h
-        - [UČvfB
-        - XLỉ]~B
+      - 低消費電力のモード
+        - レーザが消灯して計測が中断される。
+        - スキャナの回転が停止する。
 
-      d͂̃[h甲邽߂ɂ \ref urg_wakeup() ֐ĂяoĉB
+      低消費電力のモードから抜けるためには \ref urg_wakeup() 関数を呼び出して下さい。
 
       \~english
       \brief Sets the sensor into low power mode (sleep state)
@@ -848,7 +1547,7 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZTd͂̃[hʏ̏ԂɑJڂ
+      \brief センサを低消費電力のモードから通常の状態に遷移させる
       \~english
       \brief Returns from the low power mode (sleep state) to the normal mode (idle state)
       \~
@@ -858,12 +1557,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZTvłԂԂ
+      \brief センサが計測できる状態かを返す
 
-      \retval 1 ZTvłԂɂ
-      \retval 0 ZTvłԂɂȂ
+      \retval 1 センサが計測できる状態にある
+      \retval 0 センサが計測できる状態にない
 
-      NŃXLỉ]肵ĂȂꍇA炩̃G[ŌvłȂꍇÅ֐ 0 Ԃ܂B
+      起動直後でスキャナの回転が安定していない場合や、何らかのエラーで計測できない場合、この関数は 0 を返します。
 
       \~english
       \brief Returns whether the sensor is stable to perform measurement or not
@@ -879,12 +1578,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZT^𕶎ŕԂ
+      \brief センサ型式を文字列で返す
 
-      ZŤ^𕶎ŕԂBԂ镶̓ZTˑƂȂB
+      センサの型式を文字列で返す。返される文字列はセンサ依存となる。
 
-      \param[in] urg URG ZTǗ
-      \return ZT^̕
+      \param[in] urg URG センサ管理
+      \return センサ型式の文字列
 
       \~english
       \brief Returns the sensor model string
@@ -899,12 +1598,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZT̃VA ID Ԃ
+      \brief センサのシリアル ID 文字列を返す
 
-      ZT̃VA ID ԂBԂ镶̓ZTˑƂȂB
+      センサのシリアル ID 文字列を返す。返される文字列はセンサ依存となる。
 
-      \param[in] urg URG ZTǗ
-      \return VA ID 
+      \param[in] urg URG センサ管理
+      \return シリアル ID 文字列
 
       \~english
       \brief Returns the sensor serial number string
@@ -919,12 +1618,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZT̃o[WԂ
+      \brief センサのバージョン文字列を返す
 
-      ZT̃\tgEFAEo[WԂBԂ镶̓ZTˑƂȂB
+      センサのソフトウェア・バージョン文字列を返す。返される文字列はセンサ依存となる。
 
-      \param[in] urg URG ZTǗ
-      \return o[W
+      \param[in] urg URG センサ管理
+      \return バージョン文字列
 
       \~english
       \brief Returns the current sensor firmware version string
@@ -939,12 +1638,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZT̃Xe[^XԂ
+      \brief センサのステータス文字列を返す
 
-      ZT̃Xe[^XԂBԂ镶̓ZTˑƂȂB
+      センサのステータス文字列を返す。返される文字列はセンサ依存となる。
 
-      \param[in] urg URG ZTǗ
-      \return Xe[^X
+      \param[in] urg URG センサ管理
+      \return ステータス文字列
 
       \~english
       \brief Returns the current sensor status string
@@ -959,14 +1658,14 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZT̏ԂԂ
+      \brief センサの状態を返す
 
-      ZT̃Xe[^XԂBԂ镶̓ZTˑƂȂB
+      センサのステータス文字列を返す。返される文字列はセンサ依存となる。
 
-      \param[in] urg URG ZTǗ
-      \return Ԃ
+      \param[in] urg URG センサ管理
+      \return 状態を示す文字列
 
-      \attention ԂɂĂ SCIP ̒ʐMdlQƂ̂ƁB
+      \attention 状態については SCIP の通信仕様書を参照のこと。
 
       \~english
       \brief Returns the current sensor state string
@@ -983,9 +1682,172 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief vp̃G[nho^
+      \brief センサ情報の取得
+
+      VV と II をそれぞれ 1 回だけ送信し、応答の全項目を info に格納する。urg_sensor_product_type() などを項目ごとに呼び出すと、そのたびにコマンドを送信する。
+
+      \param[in] urg URG センサ管理
+      \param[out] info センサ情報
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      \~english
+      \brief Gets the sensor information
+
+      Sends VV and II once each and stores every field of the responses into info. Calling urg_sensor_product_type() and the others field by field sends one command per call.
+
+      \param[in] urg URG control structure
+      \param[out] info Sensor information
+
+      \retval 0 Successful
+      \retval <0 Error
+      \~
+      \see urg_sensor_update_status()
+    */
+    extern int urg_sensor_info(urg_t *urg, urg_sensor_info_t *info);
+
+
+    /*!
+      \~japanese
+      \brief センサ情報のうち、II の項目だけを更新する
+
+      VV の項目は接続中に変化しないため、urg_sensor_info() で一度取得したあとは、この関数で II の 1 回の送信だけで状態を更新できる。
+
+      \param[in] urg URG センサ管理
+      \param[in,out] info センサ情報
+
+      \retval 0 正常
+      \retval <0 エラー
+
+      \~english
+      \brief Updates only the II fields of the sensor information
+
+      The VV fields do not change while connected, so once they are read with urg_sensor_info(), this function updates the status with a single II.
+
+      \param[in] urg URG control structure
+      \param[in,out] info Sensor information
+
+      \retval 0 Successful
+      \retval <0 Error
+    */
+    extern int urg_sensor_update_status(urg_t *urg, urg_sensor_info_t *info);
+
+
+    /*!
+      \~japanese
+      \brief 連続計測を止めずにコマンドを送信する
+
+      command に改行を加えて送信し、応答を response に格納する。Mx, Nx の連続計測中は、応答は計測データの応答の間に返されるため、計測データの受信関数がエコーバックで振り分けて response に格納する。計測を QT で止めずに、II による状態の確認や TM1 による時刻の取得ができる。
+
+      応答を受信したかは urg_command_response() で確認する。連続計測中でなければ、この関数の中で応答を受信する。一度に送信できるコマンドは 1 つまで。
+
+      \param[in,out] urg URG センサ管理
+      \param[in] command 改行を含まないコマンド (#URG_MAX_COMMAND_SIZE 未満)
+      \param[out] response 応答の格納先。エコーバックを除く各行を '\\0' で区切って格納する
+      \param[in] max_size response のバイト数
+
+      \retval 0 正常
+      \retval <0 エラー
 
-      G[nh Gx, Mx ñR}h̉ "00"  "99" ȊÔƂɌĂяoB
+      \attention response は urg_command_response() が 0 以外を返すまで参照され続けるため、それまで解放しないこと。
+
+      \~english
+      \brief Sends a command without stopping the continuous measurement
+
+      Sends command followed by a line feed and stores its response into response. During a Mx, Nx continuous measurement the response arrives between the measurement responses, so the measurement receive functions route it by its echoback into response. II for the status or TM1 for the time can then be used without stopping the measurement with QT.
+
+      Whether the response arrived is checked with urg_command_response(). Without a continuous measurement, the response is received within this function. Only one command can be pending at a time.
+
+      \param[in,out] urg URG control structure
+      \param[in] command Command without the line feed (shorter than #URG_MAX_COMMAND_SIZE)
+      \param[out] response Destination of the response. Each line but the echoback is stored, terminated by '\\0'
+      \param[in] max_size Number of bytes of response
+
+      \retval 0 Successful
+      \retval <0 Error
+
+      \attention response is referred to until urg_command_response() returns non-zero, do not release it before.
+      \~
+      Example
+      \code
+      char response[256];
+      urg_sensor_info_t info;
+
+      urg_start_measurement(&urg, URG_DISTANCE, URG_SCAN_INFINITY, 0);
+      urg_send_command(&urg, "II", response, sizeof(response));
+      while (1) {
+          int lines;
+          urg_get_distance(&urg, data, &time_stamp);
+          lines = urg_command_response(&urg);
+          if (lines > 0) {
+              urg_parse_sensor_info(&info, response, lines);
+              urg_send_command(&urg, "II", response, sizeof(response));
+          }
+      } \endcode
+    */
+    extern int urg_send_command(urg_t *urg, const char *command,
+                                char response[], int max_size);
+
+
+    /*!
+      \~japanese
+      \brief urg_send_command() の応答を受信したかを返す
+
+      連続計測中でないときに応答が未受信なら、この関数の中で受信する。
+
+      \param[in,out] urg URG センサ管理
+
+      \retval >0 受信した応答の行数 (ステータスの行を含む)
+      \retval 0 連続計測中で、応答が未受信
+      \retval <0 エラー。送信したコマンドが無いときは #URG_INVALID_PARAMETER。連続計測中に、タイムアウトと数回分のスキャンの時間が過ぎても応答を受信しなかったときは #URG_NO_RESPONSE
+
+      \~english
+      \brief Returns whether the response of urg_send_command() arrived
+
+      Without a continuous measurement, a response not yet received is received within this function.
+
+      \param[in,out] urg URG control structure
+
+      \retval >0 Number of lines of the received response, the status included
+      \retval 0 The response has not arrived yet during the continuous measurement
+      \retval <0 Error, #URG_INVALID_PARAMETER if no command was sent. #URG_NO_RESPONSE if the response did not arrive during the continuous measurement within the timeout plus a few scans
+    */
+    extern int urg_command_response(urg_t *urg);
+
+
+    /*!
+      \~japanese
+      \brief VV, II の応答からセンサ情報を取り出す
+
+      urg_send_command() で受信した VV, II の応答の項目を info に格納する。応答に含まれない項目は変更しない。
+
+      \param[in,out] info センサ情報
+      \param[in] response urg_send_command() で受信した応答
+      \param[in] lines urg_command_response() が返した行数
+
+      \return 格納した項目の数
+
+      \~english
+      \brief Extracts the sensor information from a VV or II response
+
+      Stores the fields of a VV or II response received with urg_send_command() into info. Fields missing from the response are left unchanged.
+
+      \param[in,out] info Sensor information
+      \param[in] response Response received with urg_send_command()
+      \param[in] lines Number of lines returned by urg_command_response()
+
+      \return Number of fields stored
+    */
+    extern int urg_parse_sensor_info(urg_sensor_info_t *info,
+                                     const char response[], int lines);
+
+
+    /*!
+      \~japanese
+      \brief 計測用のエラーハンドラを登録する
+
+      エラーハンドラは Gx, Mx 系のコマンドの応答が "00" か "99" 以外のときに呼び出される。
 
       \~english
       \brief Registers an error handler for measurement functions
@@ -997,12 +1859,12 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief SCIP ̃fR[hs
+      \brief SCIP 文字列のデコードを行う
 
-      \param[in] data SCIP 
-      \param[in] size data  byte TCY
+      \param[in] data SCIP 文字列
+      \param[in] size data の byte サイズ
 
-      \retval fR[h̐l
+      \retval デコード後の数値
 
       \~english
       \brief Decodes a SCIP message
@@ -1015,6 +1877,157 @@ extern "C" {
     extern long urg_scip_decode(const char data[], int size);
 
 
+    struct urg_parser;
+
+    /*!
+      \~japanese
+      \brief 計測データのハンドラ
+
+      n はデコードした step の個数、負のときはエラー (urg_errno.h) を表す。
+
+      \~english
+      \brief Measurement data handler
+
+      n is the number of decoded steps, or an error (urg_errno.h) if negative.
+    */
+    typedef void (*urg_scan_handler)(const struct urg_parser *parser, int n,
+                                     void *user_data);
+
+
+    /*!
+      \~japanese
+      \brief 計測データの逐次解析の状態
+
+      urg_parser_feed() に渡された受信データを buffer に溜め、応答が揃うごとにデコードして scan_handler を呼び出す。応答の区切り、チェックサム、エコーバックの解析に必要な状態は全てこの構造体が持つため、受信データは任意の大きさに分けて渡せる。
+
+      urg はセンサパラメータを読むだけで変更しないため、計測中の urg でも使える。デコードは urg_decode_raw_frame() と同じく、urg_set_decode_regions() の範囲と urg_set_validity_mask() の有効ビットを適用せずに全ての step を行う。エコーバックの step 範囲は first_index, last_index, skip_step に格納する。
+
+      \~english
+      \brief State of the incremental parser of measurement data
+
+      Stores the data given to urg_parser_feed() in buffer, and decodes each response as soon as it is complete and calls scan_handler. All the state needed for the framing, the checksums and the echoback is kept in this structure, so the received data can be given in chunks of any size.
+
+      urg is only read for the sensor parameters and is not modified, so a measuring urg can be used. As with urg_decode_raw_frame(), every step is decoded without the ranges of urg_set_decode_regions() and the validity mask of urg_set_validity_mask(). The step range of the echoback is stored in first_index, last_index and skip_step.
+    */
+    typedef struct urg_parser
+    {
+        const urg_t *urg;           //!< \~japanese URG センサ管理。センサパラメータを読むだけ  \~english URG control structure, only read for the sensor parameters
+        char *buffer;               //!< \~japanese 応答を溜める領域  \~english Buffer holding the response
+        int buffer_size;            //!< \~japanese buffer のバイト数  \~english Size of buffer in bytes
+        int filled;                 //!< \~japanese buffer に溜めたバイト数  \~english Bytes stored in buffer
+        int is_overflow;            //!< \~japanese 応答が buffer に収まらなかったか  \~english Whether the response did not fit in buffer
+        char last_ch;               //!< \~japanese 最後に受け取った文字  \~english Last received character
+
+        long *data;                 //!< \~japanese 距離データの格納先  \~english Destination of the distance data
+        uint32_t *data_uint32;      //!< \~japanese uint32_t の距離データの格納先  \~english Destination of the uint32_t distance data
+        uint16_t *data_uint16;      //!< \~japanese uint16_t の距離データの格納先  \~english Destination of the uint16_t distance data
+        urg_multiecho_planes_t *planes; //!< \~japanese エコーごとの配列の格納先  \~english Destination of the per-echo arrays
+        unsigned short *intensity;  //!< \~japanese 強度データの格納先  \~english Destination of the intensity data
+        urg_measurement_type_t type; //!< \~japanese 最後の計測データの種類  \~english Type of the last measurement data
+        long time_stamp;            //!< \~japanese 最後の計測データのタイムスタンプ  \~english Timestamp of the last measurement data
+        int first_index;            //!< \~japanese 最後の計測データのエコーバックの開始 step  \~english First step in the echoback of the last measurement data
+        int last_index;             //!< \~japanese 最後の計測データのエコーバックの終了 step  \~english Last step in the echoback of the last measurement data
+        int skip_step;              //!< \~japanese 最後の計測データのエコーバックのまとめる step 数  \~english Step grouping in the echoback of the last measurement data
+
+        urg_scan_handler scan_handler; //!< \~japanese 計測データのハンドラ  \~english Measurement data handler
+        void *user_data;            //!< \~japanese scan_handler に渡すデータ  \~english Data given to scan_handler
+    } urg_parser_t;
+
+
+    /*!
+      \~japanese
+      \brief 逐次解析の初期化
+
+      \param[out] parser 逐次解析の状態
+      \param[in] urg URG センサ管理
+      \param[in] buffer 応答を溜める領域
+      \param[in] buffer_size buffer のバイト数
+      \param[out] data 距離データの格納先
+      \param[out] intensity 強度データの格納先。不要なときは NULL
+
+      buffer は最も長い応答を格納できること。data, intensity は urg_get_distance() などと同じ大きさが必要になる。scan_handler, user_data は NULL で初期化されるため、初期化後に設定すること。
+
+      \~english
+      \brief Initializes the incremental parser
+
+      \param[out] parser State of the incremental parser
+      \param[in] urg URG control structure
+      \param[in] buffer Buffer holding the response
+      \param[in] buffer_size Size of buffer in bytes
+      \param[out] data Destination of the distance data
+      \param[out] intensity Destination of the intensity data, or NULL if not needed
+
+      buffer must hold the longest response. data and intensity need the same size as with urg_get_distance() and the others. scan_handler and user_data are initialized to NULL and should be set afterwards.
+    */
+    extern void urg_parser_initialize(urg_parser_t *parser, const urg_t *urg,
+                                      char buffer[], int buffer_size,
+                                      long data[], unsigned short intensity[]);
+
+    //! \~japanese urg_parser_initialize() の uint32_t 版  \~english uint32_t version of urg_parser_initialize()
+    extern void urg_parser_initialize_uint32(urg_parser_t *parser,
+                                             const urg_t *urg,
+                                             char buffer[], int buffer_size,
+                                             uint32_t data[],
+                                             unsigned short intensity[]);
+
+    //! \~japanese urg_parser_initialize() の uint16_t 版。65535 より大きな距離は 65535 になる  \~english uint16_t version of urg_parser_initialize(). Distances larger than 65535 become 65535
+    extern void urg_parser_initialize_uint16(urg_parser_t *parser,
+                                             const urg_t *urg,
+                                             char buffer[], int buffer_size,
+                                             uint16_t data[]);
+
+    //! \~japanese urg_parser_initialize() のエコーごとの配列版。urg_get_multiecho_planes() と同じ形式で格納する  \~english Per-echo array version of urg_parser_initialize(), stored as with urg_get_multiecho_planes()
+    extern void urg_parser_initialize_planes(urg_parser_t *parser,
+                                             const urg_t *urg,
+                                             char buffer[], int buffer_size,
+                                             urg_multiecho_planes_t *planes);
+
+
+    /*!
+      \~japanese
+      \brief 受信データを逐次解析する
+
+      data を受信データの続きとして解析し、計測データの応答が揃うごとに scan_handler を呼び出す。計測開始の応答 ("00") や QT の応答では呼び出さない。壊れた応答のときは、エラー (urg_errno.h) を n に渡して scan_handler を呼び出す。urg の last_errno は変更しない。
+
+      \param[in,out] parser 逐次解析の状態
+      \param[in] data 受信データ
+      \param[in] size data のバイト数
+
+      \retval >=0 scan_handler を呼び出した回数
+
+      \~english
+      \brief Parses received data incrementally
+
+      Parses data as the continuation of the received data, and calls scan_handler each time a response with measurement data is complete. It is not called for the response that starts the measurement ("00") nor for the QT response. For a damaged response, scan_handler is called with the error (urg_errno.h) as n. The last_errno of urg is not modified.
+
+      \param[in,out] parser State of the incremental parser
+      \param[in] data Received data
+      \param[in] size Size of data in bytes
+
+      \retval >=0 Number of scan_handler calls
+      \~
+      Example
+      \code
+      static void on_scan(const urg_parser_t *parser, int n, void *user_data)
+      {
+          if (n > 0) {
+              printf("%ld: %ld [mm]\n", parser->time_stamp, parser->data[0]);
+          }
+      }
+
+      ...
+
+      urg_parser_initialize(&parser, &urg, buffer, sizeof(buffer), data, NULL);
+      parser.scan_handler = on_scan;
+
+      while ((n = recv(sock, received, sizeof(received), 0)) > 0) {
+          urg_parser_feed(&parser, received, n);
+      } \endcode
+    */
+    extern int urg_parser_feed(urg_parser_t *parser,
+                               const char data[], int size);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief VAʐM
+  \brief シリアル通信
   \~english
   \brief Serial communications
   \~
@@ -27,59 +27,94 @@ extern "C" {
 #include "urg_ring_buffer.h"
 
 
+// \~japanese 受信バッファは 1081 step の距離と強度の応答 (約 6.7 KB) 1 回分を格納できる大きさとする
+// \~english The receive buffer holds one 1081-step distance and intensity response (about 6.7 KB)
 enum {
-    RING_BUFFER_SIZE_SHIFT = 7,
+    RING_BUFFER_SIZE_SHIFT = 13,
     RING_BUFFER_SIZE = 1 << RING_BUFFER_SIZE_SHIFT,
 
     ERROR_MESSAGE_SIZE = 256,
 };
 
 
-//! \~japanese VAʐMp  \~english Control information for serial connection
+//! \~japanese シリアル通信用  \~english Control information for serial connection
 typedef struct
 {
 #if defined(URG_WINDOWS_OS)
-    HANDLE hCom;                //!< \~japanese ڑ\[X  \~english Connection resource
-    int current_timeout;        //!< \~japanese ^CAEg̐ݒ莞 [msec]  \~english Timeout configuration value
+    HANDLE hCom;                //!< \~japanese 接続リソース  \~english Connection resource
+    int current_timeout;        //!< \~japanese タイムアウトの設定時間 [msec]  \~english Timeout configuration value
 #else
-    int fd;                     //!< \~japanese t@CfBXNv^  \~english File descriptor
-    struct termios sio;         //!< \~japanese ʐMݒ  \~english Connection configuration
+    int fd;                     //!< \~japanese ファイルディスクリプタ  \~english File descriptor
+    struct termios sio;         //!< \~japanese 通信設定  \~english Connection configuration
 #endif
 
-    ring_buffer_t ring;         //!< \~japanese Oobt@  \~english Ring buffer structure
-    char buffer[RING_BUFFER_SIZE]; //!< \~japanese obt@̈  \~english Data buffer
-    char has_last_ch;          //!< \~japanese ߂邩̃tO  \~english Whether the last character was received or not
-    char last_ch;              //!< \~japanese ߂P  \~english Last character received
+    ring_buffer_t ring;         //!< \~japanese リングバッファ  \~english Ring buffer structure
+    char buffer[RING_BUFFER_SIZE]; //!< \~japanese バッファ領域  \~english Data buffer
 } urg_serial_t;
 
 
-//! \~japanese ڑJ  \~english Opens the connection
+//! \~japanese 接続を開く  \~english Opens the connection
 extern int serial_open(urg_serial_t *serial, const char *device, long baudrate);
 
 
-//! \~japanese ڑ  \~english Closes the connection
+//! \~japanese 接続を閉じる  \~english Closes the connection
 extern void serial_close(urg_serial_t *serial);
 
 
-//! \~japanese {[[gݒ肷  \~english Configures the baudrate
+//! \~japanese ボーレートを設定する  \~english Configures the baudrate
 extern int serial_set_baudrate(urg_serial_t *serial, long baudrate);
 
 
-//! \~japanese f[^𑗐M  \~english Sends data over serial connection
+/*!
+  \~japanese
+  \brief 受信バッファを変更する
+
+  buffer には 2 の shift_length 乗のサイズの領域を指定する。buffer は接続を閉じるまで呼び出し側で保持すること。受信済みのデータは破棄される。
+
+  \~english
+  \brief Replaces the receive buffer
+
+  buffer must be an area of two to the shift_length-th power bytes, and must be kept by the caller until the connection is closed. Received data is discarded.
+*/
+extern void serial_set_buffer(urg_serial_t *serial,
+                              char *buffer, int shift_length);
+
+
+#if defined(URG_LINUX_OS)
+/*!
+  \~japanese
+  \brief Bxxx 定数の無いボーレートを termios2 で設定する
+
+  termios2 の無いアーキテクチャでは -1 を返す。
+
+  \~english
+  \brief Sets a baudrate which has no Bxxx constant through termios2
+
+  Returns -1 on architectures without termios2.
+*/
+extern int serial_set_arbitrary_baudrate(int fd, long baudrate);
+#endif
+
+
+//! \~japanese データを送信する  \~english Sends data over serial connection
 extern int serial_write(urg_serial_t *serial, const char *data, int size);
 
 
-//! \~japanese f[^M  \~english Gets data from serial connection
+//! \~japanese データを受信する  \~english Gets data from serial connection
 extern int serial_read(urg_serial_t *serial,
                        char *data, int max_size, int timeout);
 
 
-//! \~japanese s܂ł̃f[^M  \~english Gets data from serial connection until end-of-line
+//! \~japanese 受信バッファに size バイト以上が格納されるか、timeout [msec] が経過するまで受信し、受信したバイト数を返す  \~english Receives until at least size bytes are stored in the receive buffer or timeout [msec] elapses, and returns the number of received bytes
+extern int serial_fill(urg_serial_t *serial, int size, int timeout);
+
+
+//! \~japanese 改行までのデータを受信する  \~english Gets data from serial connection until end-of-line
 extern int serial_readline(urg_serial_t *serial,
                            char *data, int max_size, int timeout);
 
 
-//! \~japanese G[i[ĕԂ  \~english Stores the serial error message
+//! \~japanese エラー文字列を格納して返す  \~english Stores the serial error message
 extern int serial_error(urg_serial_t *serial,
                         char *error_message, int max_size);
 
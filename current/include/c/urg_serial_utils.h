@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief VAp̕⏕֐
+  \brief シリアル用の補助関数
   \~english
   \brief Auxiliary functions for serial communications
   \~
@@ -14,21 +14,21 @@
 */
 
 
-//! \~japanese VA|[g  \~english Finds the serial port
+//! \~japanese シリアルポートを検索する  \~english Finds the serial port
 extern int urg_serial_find_port(void);
 
 
-//! \~japanese VA|[gԂ  \~english Returns the name of the serial port found
+//! \~japanese 検索したシリアルポート名を返す  \~english Returns the name of the serial port found
 extern const char *urg_serial_port_name(int index);
 
 
 /*!
   \~japanese
-  \brief |[g URG ǂ
+  \brief ポートが URG かどうか
 
-  \retval 1 URG ̃|[g
-  \retval 0 s
-  \retval <0 G[
+  \retval 1 URG のポート
+  \retval 0 不明
+  \retval <0 エラー
 
   \~english
   \brief Checks whether the serial port corresponds to a URG or not
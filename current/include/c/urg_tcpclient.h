@@ -1,133 +1,193 @@
-#ifndef URG_TCPCLIENT_H
-#define URG_TCPCLIENT_H
-
-/*!
-  \file
-  \brief TCP/IP read/write functions
-
-  \author Katsumi Kimoto
-
-  $Id: urg_tcpclient.h,v 1d233c7a2240 2011/02/19 03:08:45 Satofumi $
-*/
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include "urg_ring_buffer.h"
-#include "urg_detect_os.h"
-#include <sys/types.h>
-#if defined(URG_WINDOWS_OS)
-#include <windows.h>
-#else
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#endif
-
-
-// -- NOT INTERFACE, for internal use only --
-// For urg_ringbuffer.h
-// The size of buffer must be specified by the power of 2
-// i.e. ring buffer size = two to the RB_BITSHIFT-th power.
-enum {
-    RB_BITSHIFT = 8,
-    RB_SIZE = 1 << RB_BITSHIFT,
-
-    // caution ! available buffer size is less than the
-    // size given to the ring buffer(RB_SIZE).
-    BUFSIZE = RB_SIZE - 1,
-};
-
-
-//! TCP/IP connection
-typedef struct {
-    // socket
-    struct sockaddr_in server_addr;
-    int sock_desc;
-    int sock_addr_size;
-
-    // buffer
-    ring_buffer_t rb;
-    char buf[RB_SIZE];
-
-    // line reading functions
-    int pushed_back; // for pushded back char
-
-} urg_tcpclient_t;
-// -- end of NON INTERFACE definitions --
-
-
-// -- belows are MODULE INTERFACES --
-/*!
-  \brief constructor of tcp client module
-
-  \param[in,out] cli tcp client type variable which must be allocated by a caller.
-  \param[in] server_ip_str IP address expressed in string, i.e. "192.168.0.1"
-  \param[in] port_num port number expressed in integer, i.e. port_num = 10200
-
-  \retval 0 succeeded.
-  \retval -1 error
-*/
-extern int tcpclient_open(urg_tcpclient_t* cli,
-                          const char* server_ip_str, int port_num);
-
-
-/*!
-  \brief destructor of tcp client module
-
-  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
-*/
-extern void tcpclient_close(urg_tcpclient_t* cli);
-
-
-/*!
-  \brief read from socket.
-
-  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
-  \param[out] userbuf : buffer to store read data which must be allocated by a caller.
-  \param[in] req_size: data size requested to read in byte.
-  \param[in] timeout : time out specification which unit is microsecond.
-
-  \return the number of data read, -1 when error.
-*/
-extern int tcpclient_read(urg_tcpclient_t* cli,
-                          char* userbuf, int req_size, int timeout);
-
-
-/*!
-  \brief write to socket.
-
-  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
-  \param[in] userbuf : data to write.
-  \param[in] req_size: data size requested to write in byte.
-
-  \return returns the number of data wrote, -1 when error.
-*/
-extern int tcpclient_write(urg_tcpclient_t* cli,
-                           const char* userbuf, int req_size);
-
-
-//! \attention not implemented yet.
-extern int tcpclient_error(urg_tcpclient_t* cli,
-                           char* error_message, int max_size);
-
-
-/*!
-  \brief read one line from socket.
-
-  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
-  \param[out] userbuf : buffer to store read data which must be allocated by a caller.
-  \param[in] buf_size: data size requested to read in byte.
-  \param[in] timeout : time out specification which unit is microsecond.
-
-  \return the number of data read, -1 when error.
-*/
-extern int tcpclient_readline(urg_tcpclient_t* cli,
-                              char* userbuf, int buf_size, int timeout);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif /* !URG_TCPCLIENT_H */
+#ifndef URG_TCPCLIENT_H
+#define URG_TCPCLIENT_H
+
+/*!
+  \file
+  \brief TCP/IP read/write functions
+
+  \author Katsumi Kimoto
+
+  $Id: urg_tcpclient.h,v 1d233c7a2240 2011/02/19 03:08:45 Satofumi $
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "urg_ring_buffer.h"
+#include "urg_detect_os.h"
+#include <sys/types.h>
+#if defined(URG_WINDOWS_OS)
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+
+// -- NOT INTERFACE, for internal use only --
+// For urg_ringbuffer.h
+// The size of buffer must be specified by the power of 2
+// i.e. ring buffer size = two to the RB_BITSHIFT-th power.
+// It holds one 1081-step distance and intensity response (about 6.7 KB).
+enum {
+    RB_BITSHIFT = 13,
+    RB_SIZE = 1 << RB_BITSHIFT,
+
+    // caution ! available buffer size is less than the
+    // size given to the ring buffer(RB_SIZE).
+    BUFSIZE = RB_SIZE - 1,
+};
+
+
+//! TCP/IP connection
+typedef struct {
+    // socket
+    struct sockaddr_in server_addr;
+    int sock_desc;
+    int sock_addr_size;
+
+    // buffer
+    ring_buffer_t rb;
+    char buf[RB_SIZE];
+
+} urg_tcpclient_t;
+// -- end of NON INTERFACE definitions --
+
+
+//! socket options applied when connecting. 0 leaves the system default.
+typedef struct {
+    int no_delay;               //!< non-zero to set TCP_NODELAY, sends commands without waiting to coalesce.
+    int receive_buffer_size;    //!< SO_RCVBUF in byte, set before connecting.
+    int keepalive_idle;         //!< idle time before the first keepalive probe in second, non-zero enables SO_KEEPALIVE.
+    int keepalive_interval;     //!< interval between keepalive probes in second.
+    int keepalive_count;        //!< number of unanswered probes before the link is dropped.
+    int busy_poll;              //!< SO_BUSY_POLL in microsecond, Linux only.
+} urg_tcpclient_option_t;
+
+
+// -- belows are MODULE INTERFACES --
+/*!
+  \brief constructor of tcp client module
+
+  \param[in,out] cli tcp client type variable which must be allocated by a caller.
+  \param[in] server_ip_str IP address expressed in string, i.e. "192.168.0.1"
+  \param[in] port_num port number expressed in integer, i.e. port_num = 10200
+
+  \retval 0 succeeded.
+  \retval -1 error
+*/
+extern int tcpclient_open(urg_tcpclient_t* cli,
+                          const char* server_ip_str, int port_num);
+
+
+/*!
+  \brief initialize socket options with the system defaults.
+
+  \param[out] option : socket options.
+*/
+extern void tcpclient_option_initialize(urg_tcpclient_option_t* option);
+
+
+/*!
+  \brief constructor of tcp client module with socket options.
+
+  \param[in,out] cli tcp client type variable which must be allocated by a caller.
+  \param[in] server_ip_str IP address expressed in string, i.e. "192.168.0.1"
+  \param[in] port_num port number expressed in integer, i.e. port_num = 10200
+  \param[in] option socket options, NULL is the same as tcpclient_open().
+
+  \retval 0 succeeded.
+  \retval <0 error, including an option the system refused.
+
+  keepalive_interval, keepalive_count and busy_poll are ignored on systems without the corresponding socket option.
+*/
+extern int tcpclient_open_with_option(urg_tcpclient_t* cli,
+                                      const char* server_ip_str, int port_num,
+                                      const urg_tcpclient_option_t* option);
+
+
+/*!
+  \brief destructor of tcp client module
+
+  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
+*/
+extern void tcpclient_close(urg_tcpclient_t* cli);
+
+
+/*!
+  \brief replace the receive buffer.
+
+  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
+  \param[in] buffer : buffer of two to the shift_length-th power bytes, which must be kept by a caller until closing.
+  \param[in] shift_length : buffer size expressed as power of 2.
+
+  \attention data in the current buffer is discarded.
+*/
+extern void tcpclient_set_buffer(urg_tcpclient_t* cli,
+                                 char* buffer, int shift_length);
+
+
+/*!
+  \brief read from socket.
+
+  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
+  \param[out] userbuf : buffer to store read data which must be allocated by a caller.
+  \param[in] req_size: data size requested to read in byte.
+  \param[in] timeout : time out specification which unit is microsecond.
+
+  \return the number of data read, -1 when error.
+*/
+extern int tcpclient_read(urg_tcpclient_t* cli,
+                          char* userbuf, int req_size, int timeout);
+
+
+/*!
+  \brief write to socket.
+
+  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
+  \param[in] userbuf : data to write.
+  \param[in] req_size: data size requested to write in byte.
+
+  \return returns the number of data wrote, -1 when error.
+*/
+extern int tcpclient_write(urg_tcpclient_t* cli,
+                           const char* userbuf, int req_size);
+
+
+//! \attention not implemented yet.
+extern int tcpclient_error(urg_tcpclient_t* cli,
+                           char* error_message, int max_size);
+
+
+/*!
+  \brief read from socket into the receive buffer until it stores at least size bytes.
+
+  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
+  \param[in] size : number of bytes to be stored in the receive buffer.
+  \param[in] timeout : time out specification which unit is millisecond, bounds the whole call. negative value means no time out.
+
+  \return the number of data read, 0 when no data was read.
+*/
+extern int tcpclient_fill(urg_tcpclient_t* cli, int size, int timeout);
+
+
+/*!
+  \brief read one line from socket.
+
+  \param[in,out] cli : tcp client type variable which must be deallocated by a caller after closing.
+  \param[out] userbuf : buffer to store read data which must be allocated by a caller.
+  \param[in] buf_size: data size requested to read in byte.
+  \param[in] timeout : time out specification which unit is microsecond.
+
+  \return the number of data read, -1 when error.
+*/
+extern int tcpclient_readline(urg_tcpclient_t* cli,
+                              char* userbuf, int buf_size, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !URG_TCPCLIENT_H */
@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief URG ZTp̕⏕֐
+  \brief URG センサ用の補助関数
 
   \~english
   \brief URG sensor utility
@@ -24,11 +24,11 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief URG ̃G[Ԃ
+      \brief URG のエラーを示す文字列を返す
 
-      \param[in] urg URG ZTǗ
+      \param[in] urg URG センサ管理
 
-      \retval URG ̃G[
+      \retval URG のエラーを示す文字列
 
       \~english
       \brief Returns the string message for the last URG error
@@ -50,13 +50,13 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief ZTԂ̍őlAŏlԂ
+      \brief センサが返す距離の最大値、最小値を返す
 
-      ZTԂ [ŏl, ől] ŕԂ܂B
+      センサが返す距離を [最小値, 最大値] で返します。
 
-      \param[in] urg URG ZTǗ
-      \param[out] min_distance ŏl [mm]
-      \param[out] max_distance ől [mm]
+      \param[in] urg URG センサ管理
+      \param[out] min_distance 最小値 [mm]
+      \param[out] max_distance 最大値 [mm]
 
       \~english
       \brief Obtains the minimum and maximum distance values from sensor measurements
@@ -85,19 +85,19 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief v step ̍őlAŏlԂ
+      \brief 計測 step の最大値、最小値を返す
 
-      urg_set_scanning_parameter() Ŏwł͈͂ [ŏl, ől] ŕԂB
+      urg_set_scanning_parameter() で指定できる範囲を [最小値, 最大値] で返す。
 
-      \param[in] urg URG ZTǗ
-      \param[out] min_step ŏl
-      \param[out] max_step ől
+      \param[in] urg URG センサ管理
+      \param[out] min_step 最小値
+      \param[out] max_step 最大値
 
-      step ̓ZTʂ 0 łAZT㕔猩ꍇ̔v܂̕Av܂̕ step lƂȂB
+      step はセンサ正面が 0 であり、センサ上部から見た場合の反時計まわりの方向が正、時計まわりの方向が負の step 値となる。
 
-      \image html sensor_step_image.png ZT step ̊֌W
+      \image html sensor_step_image.png センサと step の関係
 
-      min_step, max_step ̒l̓ZTɂĈقȂB
+      min_step, max_step の値はセンサによって異なる。
 
       \~english
       \brief Gets the minimum and maximum step numbers
@@ -129,7 +129,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief PXLɂ鎞 [usec] Ԃ
+       \brief １スキャンにかかる時間 [usec] を返す
        \~english
        \brief Returns the time [usec] for 1 scan
     */
@@ -138,7 +138,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief 擾f[^̍őlԂ
+       \brief 取得データ数の最大値を返す
        \~english
        \brief Returns the maximum size of data received from the sensor
     */
@@ -147,18 +147,46 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief CfbNXƊpx(radian)̕ϊs
+      \brief 計測データ１回分を格納できる受信バッファのサイズを返す
 
-      CfbNƂ urg_get_distance() Ȃǂ̋f[^擾֐Ԃf[^zɂĂ̒lłB̊֐́AŌɍsf[^擾֐̃f[^zɂėLƂȂB
+      \param[in] step_count 計測 step 数
+      \param[in] type データ・タイプ
 
-      \param[in] urg URG ZTǗ
-      \param[in] index CfbNX
+      \return 受信バッファのサイズ (2 の乗数)
 
-      \return px [radian]
+      距離を 3 byte で表現し、マルチエコーでは全ての step が #URG_MAX_ECHO 個のエコーを返すものとしてサイズを計算する。
 
-      index ́A擾vf[^ɂĂ̒lł step pxƂ̊֌W͎擾ݒɂقȂB
+      \~english
+      \brief Returns the receive buffer size which can hold one whole scan
+
+      \param[in] step_count Number of measurement steps
+      \param[in] type Measurement type
+
+      \return Receive buffer size as power of 2
+
+      The size is calculated for 3-bytes encoding, assuming that every step returns #URG_MAX_ECHO echoes in multiecho mode.
+
+      \~
+      \see urg_open_with_option()
+    */
+    extern int urg_buffer_shift_length(int step_count,
+                                       urg_measurement_type_t type);
+
+
+    /*!
+      \~japanese
+      \brief インデックスと角度(radian)の変換を行う
+
+      インデックとは urg_get_distance() などの距離データ取得関数が返したデータ配列についての値である。この関数は、最後に行った距離データ取得関数のデータ配列について有効となる。
+
+      \param[in] urg URG センサ管理
+      \param[in] index インデックス
+
+      \return 角度 [radian]
+
+      index は、取得した計測データについての値であり step や角度との関係は取得設定により異なる。
 
-      \image html sensor_index_image.png ZŤv͈͂ƃCfbNX̊֌W
+      \image html sensor_index_image.png センサの計測範囲とインデックスの関係
 
       \~english
       \brief Converts index to angle in radians
@@ -194,7 +222,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief CfbNXƊpx(degree)̕ϊs
+       \brief インデックスと角度(degree)の変換を行う
        \~english
        \brief Converts index to angle in degrees
     */
@@ -203,7 +231,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief px(radian)ƃCfbNX̕ϊs
+       \brief 角度(radian)とインデックスの変換を行う
        \~english
        \brief Converts angle in radians to index
     */
@@ -212,7 +240,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief px(degree)ƃCfbNX̕ϊs
+       \brief 角度(degree)とインデックスの変換を行う
        \~english
        \brief Converts angle in degrees to index
     */
@@ -221,18 +249,18 @@ extern "C" {
 
     /*!
       \~japanese
-      \brief px(radian) step ̕ϊs
+      \brief 角度(radian)と step の変換を行う
 
-      urg_step_min_max() Œ`Ă step ɂāApx(radian) step ̕ϊsB
+      urg_step_min_max() で定義されている step について、角度(radian)と step の変換を行う。
 
-      \param[in] urg URG ZTǗ
-      \param[in] radian px [radian]
+      \param[in] urg URG センサ管理
+      \param[in] radian 角度 [radian]
 
       \return step
 
-      \image html sensor_angle_image.png ZT step ƊpxƂ̊֌W
+      \image html sensor_angle_image.png センサの step と角度との関係
 
-      px step ֕ϊʂłȂꍇAʂ 0 ̕ɐ؂̂ĂꂽlƂȂB
+      角度から step へ変換した結果が整数でない場合、結果は 0 の方向に切り捨てられた値となる。
 
       \~english
       \brief Converts angle in radians to step number
@@ -256,7 +284,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief px(degree) step ̕ϊs
+       \brief 角度(degree)と step の変換を行う
        \~english
        \brief Converts angle in degrees to step number
     */
@@ -265,7 +293,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief step  px(radian)̕ϊs
+       \brief step と 角度(radian)の変換を行う
        \~english
        \brief Converts step number to angle in radians
     */
@@ -274,7 +302,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief step  px(degree)̕ϊs
+       \brief step と 角度(degree)の変換を行う
        \~english
        \brief Converts step number to angle in degrees
     */
@@ -282,7 +310,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief step ƃCfbNX̕ϊs
+       \brief step とインデックスの変換を行う
        \~english
        \brief Converts step number to index
     */
@@ -290,7 +318,7 @@ extern "C" {
 
     /*!
        \~japanese
-       \brief w肵ԑ҂
+       \brief 指定した時間待つ
        \~english
        \brief Wait at the specified time
     */
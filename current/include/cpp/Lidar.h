@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief Lidar C^[tF[X
+  \brief Lidar インターフェース
   \~english
   \brief Lidar interface
   \~
@@ -19,15 +19,15 @@
 
 namespace qrk
 {
-    //! \~japanese Lidar C^[tF[X  \~english Lidar interface
+    //! \~japanese Lidar インターフェース  \~english Lidar interface
     class Lidar
     {
     public:
         typedef enum {
-            Distance,            //!< \~japanese   \~english Range
-            Distance_intensity,  //!< \~japanese  + x  \~english Distance (range) and intensity (strength)
-            Multiecho,           //!< \~japanese }`GR[̋  \~english Multiecho distance
-            Multiecho_intensity, //!< \~japanese }`GR[( + x)  \~english Multiecho distance and intensity
+            Distance,            //!< \~japanese 距離  \~english Range
+            Distance_intensity,  //!< \~japanese 距離 + 強度  \~english Distance (range) and intensity (strength)
+            Multiecho,           //!< \~japanese マルチエコーの距離  \~english Multiecho distance
+            Multiecho_intensity, //!< \~japanese マルチエコーの(距離 + 強度)  \~english Multiecho distance and intensity
         } measurement_type_t;
 
         typedef enum {
@@ -57,11 +57,11 @@ namespace qrk
         virtual void wakeup(void) = 0;
         virtual bool is_stable(void) = 0;
 
-        //! \~japanese f[^擾̊Jn  \~english Starts data measurement process
+        //! \~japanese データ取得の開始  \~english Starts data measurement process
         virtual bool start_measurement(measurement_type_t type,
                                        int scan_times, int skip_scan) = 0;
 
-        //! \~japanese Mf[^̎󂯎  \~english Receives measurement data
+        //! \~japanese 受信データの受け取り  \~english Receives measurement data
         virtual bool get_distance(std::vector<long>& data,
                                   long *time_stamp) = 0;
         virtual bool get_distance_intensity(std::vector<long>& data,
@@ -80,13 +80,13 @@ namespace qrk
         virtual bool set_scanning_parameter(int first_step, int last_step,
                                             int skip_step) = 0;
 
-        //! \~japanese f[^擾̒f  \~english Stops data measurement process
+        //! \~japanese データ取得の中断  \~english Stops data measurement process
         virtual void stop_measurement(void) = 0;
 
-        //! \~japanese ^CX^v̓  \~english Synchronization of timestamps
+        //! \~japanese タイムスタンプの同期  \~english Synchronization of timestamps
         virtual bool set_sensor_time_stamp(long time_stamp) = 0;
 
-        //! \~japanese pxϊ  \~english Angle conversion functions
+        //! \~japanese 角度変換  \~english Angle conversion functions
         virtual double index2rad(int index) const = 0;
         virtual double index2deg(int index) const = 0;
         virtual int rad2index(double radian) const = 0;
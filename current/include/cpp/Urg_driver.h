@@ -1,125 +1,177 @@
-#ifndef QRK_URG_DRIVER_H
-#define QRK_URG_DRIVER_H
-
-/*!
-  \file
-  \~japanese
-  \brief URG �h���C�o
-  \~english
-  \brief URG driver
-  \~
-  \author Satofumi KAMIMURA
-
-  $Id$
-*/
-
-#include <memory>
-#include <string>
-#include "Lidar.h"
-
-namespace qrk
-{
-    //! \~japanese URG �h���C�o  \~english URG driver
-    class Urg_driver : public Lidar
-    {
-    public:
-        enum {
-            Default_baudrate = 115200,
-            Default_port = 10940,
-            Infinity_times = -1,
-        };
-
-        Urg_driver(void);
-        virtual ~Urg_driver(void);
-
-        static std::vector<std::string> find_ports(void);
-        static std::vector<std::string> find_ports(std::vector<int>&
-                                                   is_urg_ports);
-        const char* what(void) const;
-
-        bool open(const char* device_name, long baudrate = Default_baudrate,
-                  connection_type_t type = Serial);
-        void close(void);
-        bool is_open(void) const;
-
-        void set_timeout_msec(int msec);
-
-        bool laser_on(void);
-        bool laser_off(void);
-
-        void reboot(void);
-
-        void sleep(void);
-        void wakeup(void);
-        bool is_stable(void);
-
-        //! \~japanese �f�[�^�擾�̊J�n  \~english Starts data measurement process
-        bool start_measurement(measurement_type_t type = Distance,
-                               int scan_times = Infinity_times,
-                               int skip_scan = 0);
-
-        //! \~japanese ��M�f�[�^�̎󂯎��  \~english Receives measurement data
-        bool get_distance(std::vector<long>& data, long *time_stamp = NULL);
-        bool get_distance_intensity(std::vector<long>& data,
-                                    std::vector<unsigned short>& intensity,
-                                    long *time_stamp = NULL);
-
-        bool get_multiecho(std::vector<long>& data_multi,
-                           long* time_stamp = NULL);
-
-        bool get_multiecho_intensity(std::vector<long>& data_multiecho,
-                                     std::vector<unsigned short>&
-                                     intensity_multiecho,
-                                     long* time_stamp = NULL);
-
-        bool set_scanning_parameter(int first_step, int last_step,
-                                    int skip_step = 1);
-
-        //! \~japanese �f�[�^�擾�̒��f  \~english Stops data measurement process
-        void stop_measurement(void);
-
-        //! \~japanese �^�C���X�^���v�̓���  \~english Synchronization of timestamps
-        bool set_sensor_time_stamp(long time_stamp);
-        long get_sensor_time_stamp(void);
-
-        //! \~japanese �p�x�ϊ�  \~english Angle conversion functions
-        double index2rad(int index) const;
-        double index2deg(int index) const;
-        int rad2index(double radian) const;
-        int deg2index(double degree) const;
-        int rad2step(double radian) const;
-        int deg2step(double degree) const;
-        double step2rad(int step) const;
-        double step2deg(int step) const;
-        int step2index(int step) const;
-
-        int min_step(void) const;
-        int max_step(void) const;
-        long min_distance(void) const;
-        long max_distance(void) const;
-        long scan_usec(void) const;
-        int max_data_size(void) const;
-        int max_echo_size(void) const;
-
-        const char* product_type(void) const;
-        const char* firmware_version(void) const;
-        const char* serial_id(void) const;
-        const char* status(void) const;
-        const char* state(void) const;
-
-        int raw_write(const char* data, size_t data_size);
-        int raw_read(char* data, size_t max_data_size, int timeout);
-        int raw_readline(char* data, size_t max_data_size, int timeout);
-        void* raw_urg(void);
-        void set_measurement_type(measurement_type_t type);
-
-    private:
-        Urg_driver(const Urg_driver& rhs);
-        Urg_driver& operator = (const Urg_driver& rhs);
-
-        struct pImpl;
-        std::unique_ptr<pImpl> pimpl;
-    };
-}
-
-#endif /* !QRK_URG_DRIVER_H */
+#ifndef QRK_URG_DRIVER_H
+#define QRK_URG_DRIVER_H
+
+/*!
+  \file
+  \~japanese
+  \brief URG �h���C�o
+  \~english
+  \brief URG driver
+  \~
+  \author Satofumi KAMIMURA
+
+  $Id$
+*/
+
+#include <memory>
+#include <string>
+#include <stdint.h>
+#include "Lidar.h"
+
+struct urg_sensor_info;
+
+namespace qrk
+{
+    //! \~japanese URG �h���C�o  \~english URG driver
+    class Urg_driver : public Lidar
+    {
+    public:
+        enum {
+            Default_baudrate = 115200,
+            Default_port = 10940,
+            Infinity_times = -1,
+        };
+
+        Urg_driver(void);
+        virtual ~Urg_driver(void);
+
+        static std::vector<std::string> find_ports(void);
+        static std::vector<std::string> find_ports(std::vector<int>&
+                                                   is_urg_ports);
+        const char* what(void) const;
+
+        bool open(const char* device_name, long baudrate = Default_baudrate,
+                  connection_type_t type = Serial);
+        void close(void);
+        bool is_open(void) const;
+
+        void set_timeout_msec(int msec);
+
+        bool laser_on(void);
+        bool laser_off(void);
+
+        void reboot(void);
+
+        void sleep(void);
+        void wakeup(void);
+        bool is_stable(void);
+
+        //! \~japanese �f�[�^�擾�̊J�n  \~english Starts data measurement process
+        bool start_measurement(measurement_type_t type = Distance,
+                               int scan_times = Infinity_times,
+                               int skip_scan = 0);
+
+        //! \~japanese ��M�f�[�^�̎󂯎��  \~english Receives measurement data
+        bool get_distance(std::vector<long>& data, long *time_stamp = NULL);
+        bool get_distance_intensity(std::vector<long>& data,
+                                    std::vector<unsigned short>& intensity,
+                                    long *time_stamp = NULL);
+
+        bool get_multiecho(std::vector<long>& data_multi,
+                           long* time_stamp = NULL);
+
+        bool get_multiecho_intensity(std::vector<long>& data_multiecho,
+                                     std::vector<unsigned short>&
+                                     intensity_multiecho,
+                                     long* time_stamp = NULL);
+
+        //! \~japanese 受信データを uint32_t, uint16_t で受け取る  \~english Receives measurement data as uint32_t or uint16_t
+        bool get_distance(std::vector<uint32_t>& data,
+                          long *time_stamp = NULL);
+        bool get_distance(std::vector<uint16_t>& data,
+                          long *time_stamp = NULL);
+        bool get_distance_intensity(std::vector<uint32_t>& data,
+                                    std::vector<unsigned short>& intensity,
+                                    long *time_stamp = NULL);
+
+        bool get_multiecho(std::vector<uint32_t>& data_multi,
+                           long* time_stamp = NULL);
+
+        bool get_multiecho_intensity(std::vector<uint32_t>& data_multiecho,
+                                     std::vector<unsigned short>&
+                                     intensity_multiecho,
+                                     long* time_stamp = NULL);
+
+        //! \~japanese 連続計測中の受信エラーからの再同期  \~english Resynchronisation of receive errors during continuous measurement
+        void set_resync_mode(bool is_enabled);
+        long dropped_frame_count(void) const;
+
+        //! \~japanese 受信データをデコードせずに受け取る  \~english Receives measurement data without decoding it
+        bool get_raw_frame(std::string& frame, long* time_stamp = NULL);
+        bool decode_raw_frame(const std::string& frame,
+                              std::vector<long>& data,
+                              long* time_stamp = NULL);
+        bool decode_raw_frame(const std::string& frame,
+                              std::vector<long>& data,
+                              std::vector<unsigned short>& intensity,
+                              long* time_stamp = NULL);
+        bool decode_raw_frame(const std::string& frame,
+                              std::vector<uint32_t>& data,
+                              long* time_stamp = NULL);
+        bool decode_raw_frame(const std::string& frame,
+                              std::vector<uint16_t>& data,
+                              long* time_stamp = NULL);
+        bool decode_raw_frame(const std::string& frame,
+                              std::vector<uint32_t>& data,
+                              std::vector<unsigned short>& intensity,
+                              long* time_stamp = NULL);
+
+        bool set_scanning_parameter(int first_step, int last_step,
+                                    int skip_step = 1);
+
+        //! \~japanese �f�[�^�擾�̒��f  \~english Stops data measurement process
+        void stop_measurement(void);
+
+        //! \~japanese �^�C���X�^���v�̓���  \~english Synchronization of timestamps
+        bool set_sensor_time_stamp(long time_stamp);
+        long get_sensor_time_stamp(void);
+
+        //! \~japanese �p�x�ϊ�  \~english Angle conversion functions
+        double index2rad(int index) const;
+        double index2deg(int index) const;
+        int rad2index(double radian) const;
+        int deg2index(double degree) const;
+        int rad2step(double radian) const;
+        int deg2step(double degree) const;
+        double step2rad(int step) const;
+        double step2deg(int step) const;
+        int step2index(int step) const;
+
+        int min_step(void) const;
+        int max_step(void) const;
+        long min_distance(void) const;
+        long max_distance(void) const;
+        long scan_usec(void) const;
+        int max_data_size(void) const;
+        int max_echo_size(void) const;
+
+        const char* product_type(void) const;
+        const char* firmware_version(void) const;
+        const char* serial_id(void) const;
+        const char* status(void) const;
+        const char* state(void) const;
+
+        //! \~japanese VV, II を 1 回ずつ送信してセンサ情報を取得する  \~english Gets the sensor information with one VV and one II
+        bool sensor_info(struct urg_sensor_info& info) const;
+        bool update_sensor_status(struct urg_sensor_info& info) const;
+
+        //! \~japanese 連続計測を止めずにコマンドを送信する  \~english Sends a command without stopping the continuous measurement
+        bool send_command(const char* command, char* response, int max_size);
+        int command_response(void);
+
+        int raw_write(const char* data, size_t data_size);
+        int raw_read(char* data, size_t max_data_size, int timeout);
+        int raw_readline(char* data, size_t max_data_size, int timeout);
+        void* raw_urg(void);
+        void set_measurement_type(measurement_type_t type);
+
+    private:
+        Urg_driver(const Urg_driver& rhs);
+        Urg_driver& operator = (const Urg_driver& rhs);
+
+        struct pImpl;
+        std::unique_ptr<pImpl> pimpl;
+    };
+}
+
+#endif /* !QRK_URG_DRIVER_H */
@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief OŠo
+  \brief 動作OSの検出
   \~english
   \brief Detects the operating system
   \~
@@ -28,7 +28,7 @@
 #define QRK_LINUX_OS
 
 #else
-// \~japanese ołȂƂAMac ɂĂ܂
+// \~japanese 検出できないときを、Mac 扱いにしてしまう
 // \~english If cannot detect the OS, assumes it is a Mac
 #define QRK_MAC_OS
 #endif
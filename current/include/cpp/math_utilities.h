@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief w֐̕⏕t@C
+  \brief 数学関数の補助ファイル
   \~english
   \brief Auxiliary math functions
   \~
@@ -21,7 +21,7 @@
 
 
 #ifndef M_PI
-//! \~japanese ~ (Visual C++ 6.0 p)
+//! \~japanese 円周率 (Visual C++ 6.0 用)
 //! \~english PI approximation (for Visual C++ 6.0)
 #define M_PI 3.14159265358979323846
 #endif
@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief ^CX^v̎擾
+  \brief タイムスタンプの取得
   \~english
   \brief Gets timestamp values
   \~
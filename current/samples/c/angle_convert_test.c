@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example angle_convert_test.c pxϊ̌ʂ\
+  \example angle_convert_test.c 角度変換の結果を表示する
   \~english
   \example angle_convert_test.c Some cases of angle conversion
   \~
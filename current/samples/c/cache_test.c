@@ -0,0 +1,214 @@
+/*!
+  \~japanese
+  \example cache_test.c 接続情報のキャッシュの確認
+
+  接続情報の追加と、記録数を超えたときに最も古い接続情報が取り除かれること、ファイルへの保存と読み込みで値が変わらないこと、形式の合わない行と無効な値の行が読み飛ばされることを確認する。また、urg_open_with_cache() の 2 回目の接続で PP の問い合わせが省かれることを確認する。センサは不要。
+  \~english
+  \example cache_test.c Checks the cache of connection information
+
+  Checks adding entries, that the entry added first is removed when too many are recorded, that saving to a file and loading it keeps the values, and that lines in another format and lines with invalid values are skipped. Also checks that the second connection of urg_open_with_cache() skips the PP query. No sensor is needed.
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_utils.h"
+#include "urg_cache.h"
+#include "replay_sensor.h"
+#include <stdio.h>
+#include <string.h>
+
+
+static const char cache_file[] = "cache_test.txt";
+static int failures = 0;
+
+
+static void fail(const char *message)
+{
+    printf("cache_test: %s\n", message);
+    ++failures;
+}
+
+
+static void set_entry(urg_cache_entry_t *entry, int i)
+{
+    sprintf(entry->serial_id, "H%07d", i);
+    entry->baudrate = (i % 2) ? 115200 : 0;
+    entry->min_distance = 20 + i;
+    entry->max_distance = 30000 + i;
+    entry->area_resolution = 1440;
+    entry->first_data_index = i;
+    entry->last_data_index = 1080 - i;
+    entry->front_data_index = 540;
+    entry->scan_usec = 25000 + i;
+}
+
+
+// \~japanese 記録数を超えると、最も古く追加した接続情報が取り除かれる
+// \~english Adding more entries than recorded removes the entry added first
+static void check_entry(void)
+{
+    static urg_cache_t cache;
+    char device[URG_CACHE_DEVICE_SIZE + 1];
+    urg_cache_entry_t *entry;
+    int i;
+
+    urg_cache_initialize(&cache);
+    for (i = 0; i <= URG_CACHE_MAX_ENTRIES; ++i) {
+        sprintf(device, "/dev/ttyACM%d", i);
+        entry = urg_cache_entry(&cache, device);
+        if (!entry || strcmp(entry->device, device) ||
+            (entry->serial_id[0] != '\0') || (entry->baudrate != 0)) {
+            fail("added entry is not empty");
+            return;
+        }
+        set_entry(entry, i);
+    }
+
+    if (cache.entry_count != URG_CACHE_MAX_ENTRIES) {
+        fail("entry count exceeds the maximum");
+    }
+    if (urg_cache_find(&cache, "/dev/ttyACM0")) {
+        fail("entry added first was not removed");
+    }
+    entry = urg_cache_find(&cache, "/dev/ttyACM1");
+    if (!entry || (entry != &cache.entries[0]) ||
+        (entry->scan_usec != 25000 + 1)) {
+        fail("entries were not kept in order");
+    }
+
+    // \~japanese 記録済みの接続情報は追加しない
+    // \~english A recorded entry is not added again
+    sprintf(device, "/dev/ttyACM%d", URG_CACHE_MAX_ENTRIES);
+    if ((urg_cache_entry(&cache, device) !=
+         &cache.entries[URG_CACHE_MAX_ENTRIES - 1]) ||
+        (cache.entry_count != URG_CACHE_MAX_ENTRIES) ||
+        !urg_cache_find(&cache, "/dev/ttyACM1")) {
+        fail("recorded entry was added again");
+    }
+
+    memset(device, 'x', URG_CACHE_DEVICE_SIZE);
+    device[URG_CACHE_DEVICE_SIZE] = '\0';
+    if (urg_cache_entry(&cache, device)) {
+        fail("too long device name was added");
+    }
+}
+
+
+// \~japanese 保存したファイルを読み込むと同じ値になり、無効な行は読み飛ばされる
+// \~english Loading a saved file gives the same values, and invalid lines are skipped
+static void check_load_save(void)
+{
+    static urg_cache_t cache;
+    static urg_cache_t loaded;
+    urg_cache_entry_t *entry;
+    char device[URG_CACHE_DEVICE_SIZE];
+    FILE *fd;
+    int i;
+
+    urg_cache_initialize(&cache);
+    for (i = 0; i < 3; ++i) {
+        sprintf(device, "192.168.0.%d", 10 + i);
+        set_entry(urg_cache_entry(&cache, device), i);
+    }
+    if (urg_cache_save(&cache, cache_file) != 3) {
+        fail("urg_cache_save() count");
+        return;
+    }
+
+    // \~japanese 形式の合わない行と、値が無効な行を加える
+    // \~english Appends lines in another format and lines with invalid values
+    fd = fopen(cache_file, "a");
+    if (!fd) {
+        fail("cannot append to the cache file");
+        return;
+    }
+    fprintf(fd, "broken line\n");
+    fprintf(fd, "short\tH0000001\t115200\t20\n");
+    fprintf(fd, "dmax\tH0000001\t115200\t20\t20\t1440\t0\t1080\t540\t25000\n");
+    fprintf(fd, "afrt\tH0000001\t115200\t20\t30000\t1440\t0\t1080\t1081\t25000\n");
+    fprintf(fd, "scan\tH0000001\t115200\t20\t30000\t1440\t0\t1080\t540\t0\n");
+    fclose(fd);
+
+    set_entry(urg_cache_entry(&loaded, "stale"), 0);
+    if (urg_cache_load(&loaded, cache_file) != 3) {
+        fail("urg_cache_load() count");
+    } else if (urg_cache_find(&loaded, "stale")) {
+        fail("urg_cache_load() did not replace the contents");
+    } else {
+        for (i = 0; i < 3; ++i) {
+            entry = urg_cache_find(&loaded, cache.entries[i].device);
+            if (!entry || memcmp(entry, &cache.entries[i], sizeof(*entry))) {
+                fail("loaded entry differs");
+            }
+        }
+    }
+    remove(cache_file);
+
+    if (urg_cache_load(&loaded, cache_file) >= 0) {
+        fail("missing file was loaded");
+    }
+}
+
+
+// \~japanese 2 回目の接続では、記録したパラメータを使い PP を送信しない
+// \~english The second connection uses the recorded parameters and sends no PP
+static void check_open(void)
+{
+    static urg_cache_t cache;
+    static replay_sensor_t sensor;
+    urg_cache_entry_t *entry;
+    urg_t urg;
+    long scan_usec;
+    int expected_pp_count[] = { 1, 0, 1, 1 };
+    int i;
+
+    urg_cache_initialize(&cache);
+    for (i = 0; i < (int)(sizeof(expected_pp_count) /
+                          sizeof(expected_pp_count[0])); ++i) {
+        entry = urg_cache_find(&cache, "replay");
+        if (entry && (i == 2)) {
+            // \~japanese シリアル番号が異なれば、PP を問い合わせる
+            // \~english A different serial id queries PP
+            strcpy(entry->serial_id, "H9999999");
+        } else if (entry && (i == 3)) {
+            // \~japanese 値が無効な接続情報は使わない
+            // \~english An entry with invalid values is not used
+            entry->scan_usec = 0;
+        }
+
+        replay_sensor_initialize(&sensor);
+        if (replay_sensor_open_with_cache(&urg, &sensor, &cache) < 0) {
+            printf("cache_test: connection %d: %s\n", i, urg_error(&urg));
+            ++failures;
+            return;
+        }
+        scan_usec = urg.scan_usec;
+        urg_close(&urg);
+
+        entry = urg_cache_find(&cache, "replay");
+        if (sensor.pp_count != expected_pp_count[i]) {
+            printf("cache_test: connection %d: %d PP commands\n",
+                   i, sensor.pp_count);
+            ++failures;
+        }
+        if (!entry || !urg_cache_is_valid(entry) ||
+            strcmp(entry->serial_id, "H0000042") ||
+            (entry->scan_usec != scan_usec)) {
+            printf("cache_test: connection %d: entry was not recorded\n", i);
+            ++failures;
+        }
+    }
+}
+
+
+int main(void)
+{
+    check_entry();
+    check_load_save();
+    check_open();
+
+    printf("cache_test: %s\n", (failures > 0) ? "failed" : "passed");
+    return (failures > 0) ? 1 : 0;
+}
@@ -1,8 +1,8 @@
 /*!
   \~japanese
-  \example calculate_xy.c X-Y Wnł̈ʒuvZ
+  \example calculate_xy.c X-Y 座標系での位置を計算する
 
-  ZTO X ̕Ƃ݂ȂsWŁAf[^ʒuo͂B
+  センサ前方が X 軸の方向とみなした直行座標上で、距離データを位置を出力する。
 
   \~english
   \example calculate_xy.c Calculates X-Y coordinates
@@ -42,7 +42,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
     urg_start_measurement(&urg, URG_DISTANCE, 1, 0);
     n = urg_get_distance(&urg, data, &time_stamp);
@@ -52,7 +52,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese X-Y Wn̒lo
+    // \~japanese X-Y 座標系の値を出力
     // \~english Outputs X-Y coordinates
     urg_distance_min_max(&urg, &min_distance, &max_distance);
     for (i = 0; i < n; ++i) {
@@ -73,7 +73,7 @@ int main(int argc, char *argv[])
     }
     printf("\n");
 
-    // \~japanese ؒf
+    // \~japanese 切断
     // \~english Disconnects
     free(data);
     urg_close(&urg);
@@ -0,0 +1,162 @@
+/*!
+  \~japanese
+  \example decoder_test.c 計測データの種類ごとのデコードの確認
+
+  2 byte と 3 byte の距離、距離と強度、マルチエコーのそれぞれのデコード処理を、受信モードと計測範囲を変えて、生成した値と比べる。センサは不要。
+  \~english
+  \example decoder_test.c Checks the decoding of each type of measurement data
+
+  Compares the decoding of 2-byte and 3-byte distances, distances with intensities, and multiecho with the generated values, in each receive mode and for several scanning ranges. No sensor is needed.
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_utils.h"
+#include "urg_errno.h"
+#include "replay_sensor.h"
+#include <stdio.h>
+
+
+static int failures = 0;
+
+
+typedef struct
+{
+    urg_measurement_type_t type;
+    urg_range_data_byte_t data_byte;
+    const char *name;
+} decoder_case_t;
+
+
+static const decoder_case_t cases[] = {
+    { URG_DISTANCE, URG_COMMUNICATION_2_BYTE, "GS/MS" },
+    { URG_DISTANCE, URG_COMMUNICATION_3_BYTE, "GD/MD" },
+    { URG_DISTANCE_INTENSITY, URG_COMMUNICATION_3_BYTE, "GE/ME" },
+    { URG_MULTIECHO, URG_COMMUNICATION_3_BYTE, "HD/ND" },
+    { URG_MULTIECHO_INTENSITY, URG_COMMUNICATION_3_BYTE, "HE/NE" },
+};
+
+
+static int get_data(urg_t *urg, urg_measurement_type_t type,
+                    long data[], unsigned short intensity[], long *time_stamp)
+{
+    switch (type) {
+    case URG_DISTANCE:
+        return urg_get_distance(urg, data, time_stamp);
+
+    case URG_DISTANCE_INTENSITY:
+        return urg_get_distance_intensity(urg, data, intensity, time_stamp);
+
+    case URG_MULTIECHO:
+        return urg_get_multiecho(urg, data, time_stamp);
+
+    default:
+        return urg_get_multiecho_intensity(urg, data, intensity, time_stamp);
+    }
+}
+
+
+static void check_case(urg_t *urg, const decoder_case_t *c,
+                       urg_receive_mode_t mode,
+                       int first_step, int last_step, int scan_times)
+{
+    static long data[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+    static unsigned short intensity[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+    int is_intensity = (c->type == URG_DISTANCE_INTENSITY) ||
+        (c->type == URG_MULTIECHO_INTENSITY);
+    long time_stamp;
+    int first_index;
+    int n;
+    int i;
+
+    urg_set_receive_mode(urg, mode);
+    urg_set_communication_data_size(urg, c->data_byte);
+    urg_set_scanning_parameter(urg, first_step, last_step, 0);
+    first_index = urg->scanning_first_step + urg->front_data_index;
+
+    if (urg_start_measurement(urg, c->type, scan_times, 0) < 0) {
+        printf("decoder_test: %s mode %d: urg_start_measurement: %s\n",
+               c->name, mode, urg_error(urg));
+        ++failures;
+        return;
+    }
+    for (i = 0; i < scan_times; ++i) {
+        n = get_data(urg, c->type, data, intensity, &time_stamp);
+        if (n != last_step - first_step + 1) {
+            printf("decoder_test: %s mode %d, [%d, %d] scan %d: %d, %s\n",
+                   c->name, mode, first_step, last_step, i, n,
+                   urg_error(urg));
+            ++failures;
+            break;
+        }
+        if (replay_sensor_count_errors(time_stamp, c->type, first_index,
+                                       data, is_intensity ? intensity : NULL,
+                                       n) > 0) {
+            printf("decoder_test: %s mode %d, [%d, %d] scan %d: "
+                   "wrong values\n",
+                   c->name, mode, first_step, last_step, i);
+            ++failures;
+        }
+    }
+}
+
+
+// \~japanese マルチエコーは受信バイト数が決まらないため、#URG_RECEIVE_EXACT_FRAME では計測を開始しない
+// \~english Multiecho has no fixed response size, so the measurement is not started with #URG_RECEIVE_EXACT_FRAME
+static void check_rejected(urg_t *urg, const decoder_case_t *c)
+{
+    urg_set_receive_mode(urg, URG_RECEIVE_EXACT_FRAME);
+    if (urg_start_measurement(urg, c->type, 1, 0) != URG_INVALID_PARAMETER) {
+        printf("decoder_test: %s was accepted in the exact frame mode\n",
+               c->name);
+        ++failures;
+    }
+}
+
+
+int main(void)
+{
+    // \~japanese 値がデータ行をまたぐように、範囲の step 数を変える
+    // \~english Varies the number of steps so that values straddle the data lines
+    static const int ranges[][2] = {
+        { -540, 540 }, { 0, 0 }, { -10, 10 }, { -100, 200 }, { 400, 540 },
+    };
+    urg_receive_mode_t modes[] = {
+        URG_RECEIVE_LINE, URG_RECEIVE_FRAME, URG_RECEIVE_EXACT_FRAME,
+    };
+    replay_sensor_t sensor;
+    urg_t urg;
+    int i;
+    int j;
+    int k;
+
+    replay_sensor_initialize(&sensor);
+    if (replay_sensor_open(&urg, &sensor) < 0) {
+        printf("decoder_test: replay_sensor_open: %s\n", urg_error(&urg));
+        return 1;
+    }
+
+    for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); ++i) {
+        const decoder_case_t *c = &cases[i];
+        for (j = 0; j < (int)(sizeof(modes) / sizeof(modes[0])); ++j) {
+            if ((modes[j] == URG_RECEIVE_EXACT_FRAME) &&
+                ((c->type == URG_MULTIECHO) ||
+                 (c->type == URG_MULTIECHO_INTENSITY))) {
+                check_rejected(&urg, c);
+                continue;
+            }
+            for (k = 0; k < (int)(sizeof(ranges) / sizeof(ranges[0])); ++k) {
+                // \~japanese Gx と Mx の両方の応答を確認する
+                // \~english Checks both the Gx and the Mx responses
+                check_case(&urg, c, modes[j], ranges[k][0], ranges[k][1], 1);
+                check_case(&urg, c, modes[j], ranges[k][0], ranges[k][1], 3);
+            }
+        }
+    }
+    urg_close(&urg);
+
+    printf("decoder_test: %s\n", (failures > 0) ? "failed" : "passed");
+    return (failures > 0) ? 1 : 0;
+}
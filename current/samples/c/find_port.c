@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example find_port.c |[g̒T
+  \example find_port.c ポートの探索
   \~english
   \example find_port.c Finds out the port
   \~
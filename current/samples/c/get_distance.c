@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example get_distance.c f[^擾
+  \example get_distance.c 距離データを取得する
   \~english
   \example get_distance.c Obtains distance data
   \~
@@ -23,7 +23,7 @@ static void print_data(urg_t *urg, long data[], int data_n, long time_stamp)
 
     (void)data_n;
 
-    // \~japanese Õf[^݂̂\
+    // \~japanese 前方のデータのみを表示
     // \~english Shows only the front step
     front_index = urg_step2index(urg, 0);
     printf("%ld [mm], (%ld [msec])\n", data[front_index], time_stamp);
@@ -35,7 +35,7 @@ static void print_data(urg_t *urg, long data[], int data_n, long time_stamp)
     long min_distance;
     long max_distance;
 
-    // \~japanese SẴf[^ X-Y ̈ʒu\
+    // \~japanese 全てのデータの X-Y の位置を表示
     // \~english Prints the X-Y coordinates for all the measurement points
     urg_distance_min_max(urg, &min_distance, &max_distance);
     for (i = 0; i < data_n; ++i) {
@@ -78,10 +78,10 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
 #if 0
-    // \~japanese f[^̎擾͈͂ύXꍇ
+    // \~japanese データの取得範囲を変更する場合
     // \~english Case where the measurement range (start/end steps) is defined
     urg_set_scanning_parameter(&urg,
                                urg_deg2step(&urg, -90),
@@ -100,7 +100,7 @@ int main(int argc, char *argv[])
         print_data(&urg, data, n, time_stamp);
     }
 
-    // \~japanese ؒf
+    // \~japanese 切断
     // \~english Disconnects
     free(data);
     urg_close(&urg);
@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example get_distance_intensity.c Exf[^擾
+  \example get_distance_intensity.c 距離・強度データを取得する
   \~english
   \example get_distance_intensity.c Obtains distance and intensity data
   \~
@@ -23,7 +23,7 @@ static void print_data(urg_t *urg, long data[], unsigned short intensity[],
     int front_index;
     (void)data_n;
 
-    // \~japanese Õf[^݂̂\
+    // \~japanese 前方のデータのみを表示
     // \~english Shows only the front step
     front_index = urg_step2index(urg, 0);
     printf("%ld [mm], %d [1], (%ld [msec])\n",
@@ -34,7 +34,7 @@ static void print_data(urg_t *urg, long data[], unsigned short intensity[],
 
     int i;
 
-    // \~japanese SẴf[^\
+    // \~japanese 全てのデータを表示
     // \~english Prints the range/intensity values for all the measurement points
     printf("# n = %d, time_stamp = %ld\n", data_n, time_stamp);
     for (i = 0; i < data_n; ++i) {
@@ -73,7 +73,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
     urg_start_measurement(&urg, URG_DISTANCE_INTENSITY, URG_SCAN_INFINITY, 0);
     for (i = 0; i < CAPTURE_TIMES; ++i) {
@@ -87,7 +87,7 @@ int main(int argc, char *argv[])
         print_data(&urg, data, intensity, n, time_stamp);
     }
 
-    // \~japanese ؒf
+    // \~japanese 切断
     // \~english Disconnects
     free(intensity);
     free(data);
@@ -1,6 +1,6 @@
  /*!
   \~japanese
-  \example get_multiecho.c f[^(}`GR[)擾
+  \example get_multiecho.c 距離データ(マルチエコー)を取得する
   \~english
   \example get_multiecho.c Obtains multiecho distance data
   \~
@@ -34,7 +34,7 @@ static void print_data(urg_t *urg, long data[], int data_n, long time_stamp)
 
     (void)data_n;
 
-    // \~japanese Õf[^݂̂\
+    // \~japanese 前方のデータのみを表示
     // \~english Shows only the front step
     front_index = urg_step2index(urg, 0);
     print_echo_data(data, front_index);
@@ -45,7 +45,7 @@ static void print_data(urg_t *urg, long data[], int data_n, long time_stamp)
 
     int i;
 
-    // \~japanese SẴf[^\
+    // \~japanese 全てのデータを表示
     // \~english Prints the multiecho distance for all the measurement points
     printf("# n = %d, time_stamp = %ld\n", data_n, time_stamp);
     for (i = 0; i < data_n; ++i) {
@@ -77,7 +77,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
     urg_start_measurement(&urg, URG_MULTIECHO, URG_SCAN_INFINITY, 0);
     for (i = 0; i < CAPTURE_TIMES; ++i) {
@@ -91,7 +91,7 @@ int main(int argc, char *argv[])
         print_data(&urg, data, n, time_stamp);
     }
 
-    // \~japanese ؒf
+    // \~japanese 切断
     // \~english Disconnects
     free(data);
     urg_close(&urg);
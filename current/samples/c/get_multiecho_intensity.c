@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example get_multiecho_intensity.c Exf[^(}`GR[)擾
+  \example get_multiecho_intensity.c 距離・強度データ(マルチエコー)を取得する
   \~english
   \example get_multiecho_intensity.c Obtains multiecho distance and intensity data
   \~
@@ -33,7 +33,7 @@ static void print_echo_data(long data[], unsigned short intensity[],
 }
 
 
-// \~japanese Ax̃f[^\
+// \~japanese 距離、強度のデータを表示する
 // \~english Prints distance and intensity data
 static void print_data(urg_t *urg, long data[],
                        unsigned short intensity[], int data_n, long time_stamp)
@@ -43,7 +43,7 @@ static void print_data(urg_t *urg, long data[],
 
     (void)data_n;
 
-    // \~japanese Õf[^݂̂\
+    // \~japanese 前方のデータのみを表示
     // \~english Shows only the front step
     front_index = urg_step2index(urg, 0);
     print_echo_data(data, intensity, front_index);
@@ -53,7 +53,7 @@ static void print_data(urg_t *urg, long data[],
     (void)urg;
     int i;
 
-    // \~japanese SẴf[^\
+    // \~japanese 全てのデータを表示
     // \~english Prints the multiecho range/intensity values for all the measurement points
     printf("# n = %d, time_stamp = %ld\n", data_n, time_stamp);
     for (i = 0; i < data_n; ++i) {
@@ -91,7 +91,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
     urg_start_measurement(&urg, URG_MULTIECHO_INTENSITY, URG_SCAN_INFINITY, 0);
     for (i = 0; i < CAPTURE_TIMES; ++i) {
@@ -106,7 +106,7 @@ int main(int argc, char *argv[])
         print_data(&urg, data, intensity, n, time_stamp);
     }
 
-    // \~japanese ؒf
+    // \~japanese 切断
     // \~english Disconnects
     free(data);
     free(intensity);
@@ -0,0 +1,201 @@
+/*!
+  \~japanese
+  \example parser_split_test.c 受信データを分割して渡す逐次解析の確認
+
+  記録した受信データを、あらゆる位置で分けて urg_parser_feed() に渡し、分け方によらず同じ計測データが得られることを確認する。また、逐次解析が urg_t を変更しないことを確認する。センサは不要。
+  \~english
+  \example parser_split_test.c Checks the incremental parser with split received data
+
+  Gives recorded received data to urg_parser_feed() split at every position, and checks that the same measurement data is obtained however it is split. Also checks that the incremental parser does not modify urg_t. No sensor is needed.
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_utils.h"
+#include "urg_errno.h"
+#include "replay_sensor.h"
+#include <stdio.h>
+#include <string.h>
+
+
+enum {
+    CAPTURE_TIMES = 3,
+    STREAM_SIZE = 3 * 65536,
+    PARSER_BUFFER_SIZE = 1 << REPLAY_SENSOR_BUFFER_SHIFT,
+};
+
+
+typedef struct
+{
+    urg_measurement_type_t type;
+    int first_index;
+    int data_size;
+    int corrupt_call;           // \~japanese エラーになるはずの呼び出し  \~english Call expected to be an error
+    int calls;
+    int errors;
+} feed_result_t;
+
+
+static int failures = 0;
+static char stream[STREAM_SIZE];
+static char parser_buffer[PARSER_BUFFER_SIZE];
+static long data[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+static unsigned short intensity[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+
+
+static void on_scan(const urg_parser_t *parser, int n, void *user_data)
+{
+    feed_result_t *result = (feed_result_t *)user_data;
+    int is_intensity = (result->type == URG_DISTANCE_INTENSITY) ||
+        (result->type == URG_MULTIECHO_INTENSITY);
+
+    if (result->calls == result->corrupt_call) {
+        if (n != URG_CHECKSUM_ERROR) {
+            ++result->errors;
+        }
+    } else if ((n != result->data_size) || (parser->type != result->type) ||
+               (replay_sensor_count_errors(parser->time_stamp, result->type,
+                                           result->first_index,
+                                           parser->data,
+                                           is_intensity ?
+                                           parser->intensity : NULL,
+                                           n) > 0)) {
+        ++result->errors;
+    }
+    ++result->calls;
+}
+
+
+// \~japanese 計測データの受信データを、解析せずにそのまま記録する
+// \~english Records the received data of the measurement without parsing it
+static int capture(urg_t *urg, replay_sensor_t *sensor,
+                   urg_measurement_type_t type, int is_corrupt)
+{
+    int filled = 0;
+    int n;
+
+    sensor->corrupt_scan = is_corrupt ? sensor->scan_count + 1 : -1;
+    if (urg_start_measurement(urg, type, CAPTURE_TIMES, 0) < 0) {
+        return -1;
+    }
+    while ((n = connection_read(&urg->connection, &stream[filled],
+                                STREAM_SIZE - filled, 10)) > 0) {
+        filled += n;
+    }
+    urg_stop_measurement(urg);
+    return filled;
+}
+
+
+// \~japanese 最初に first_size バイト、その後は chunk_size バイトずつ渡す
+// \~english Gives first_size bytes first, then chunk_size bytes at a time
+static void feed(const urg_t *urg, feed_result_t *result,
+                 int first_size, int chunk_size, int stream_size)
+{
+    urg_parser_t parser;
+    int filled = 0;
+    int n = first_size;
+
+    urg_parser_initialize(&parser, urg, parser_buffer, sizeof(parser_buffer),
+                          data, intensity);
+    parser.scan_handler = on_scan;
+    parser.user_data = result;
+
+    result->calls = 0;
+    result->errors = 0;
+    while (filled < stream_size) {
+        if (n > stream_size - filled) {
+            n = stream_size - filled;
+        }
+        urg_parser_feed(&parser, &stream[filled], n);
+        filled += n;
+        n = chunk_size;
+    }
+}
+
+
+static void check_type(urg_t *urg, replay_sensor_t *sensor,
+                       urg_measurement_type_t type, int is_corrupt,
+                       int first_step, int last_step, int split_everywhere)
+{
+    static const int chunk_sizes[] = { 1, 2, 3, 7, 63, 64, 65, 1000 };
+    static urg_t before;
+    feed_result_t result;
+    int stream_size;
+    int i;
+
+    urg_set_scanning_parameter(urg, first_step, last_step, 0);
+    stream_size = capture(urg, sensor, type, is_corrupt);
+    if (stream_size <= 0) {
+        printf("parser_split_test: type %d: capture failed\n", type);
+        ++failures;
+        return;
+    }
+
+    result.type = type;
+    result.first_index = urg->scanning_first_step + urg->front_data_index;
+    result.data_size = last_step - first_step + 1;
+    result.corrupt_call = is_corrupt ? 1 : -1;
+
+    memcpy(&before, urg, sizeof(before));
+
+    // \~japanese 2 つに分けて渡す。分ける位置は全てのバイト境界
+    // \~english Gives the data in two parts, split at every byte boundary
+    for (i = 0; split_everywhere && (i <= stream_size); ++i) {
+        feed(urg, &result, i, stream_size, stream_size);
+        if ((result.calls != CAPTURE_TIMES) || (result.errors > 0)) {
+            printf("parser_split_test: type %d, split at %d: "
+                   "%d calls, %d errors\n", type, i,
+                   result.calls, result.errors);
+            ++failures;
+            break;
+        }
+    }
+
+    // \~japanese 一定の大きさに分けて渡す
+    // \~english Gives the data in chunks of a fixed size
+    for (i = 0; i < (int)(sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); ++i) {
+        feed(urg, &result, chunk_sizes[i], chunk_sizes[i], stream_size);
+        if ((result.calls != CAPTURE_TIMES) || (result.errors > 0)) {
+            printf("parser_split_test: type %d, chunks of %d: "
+                   "%d calls, %d errors\n", type, chunk_sizes[i],
+                   result.calls, result.errors);
+            ++failures;
+        }
+    }
+
+    if (memcmp(&before, urg, sizeof(before))) {
+        printf("parser_split_test: type %d: urg_t was modified\n", type);
+        ++failures;
+    }
+}
+
+
+int main(void)
+{
+    urg_measurement_type_t types[] = {
+        URG_DISTANCE, URG_DISTANCE_INTENSITY,
+        URG_MULTIECHO, URG_MULTIECHO_INTENSITY,
+    };
+    replay_sensor_t sensor;
+    urg_t urg;
+    int i;
+
+    replay_sensor_initialize(&sensor);
+    if (replay_sensor_open(&urg, &sensor) < 0) {
+        printf("parser_split_test: replay_sensor_open: %s\n", urg_error(&urg));
+        return 1;
+    }
+
+    for (i = 0; i < (int)(sizeof(types) / sizeof(types[0])); ++i) {
+        check_type(&urg, &sensor, types[i], 0, -40, 40, 1);
+        check_type(&urg, &sensor, types[i], 1, -40, 40, 1);
+        check_type(&urg, &sensor, types[i], 0, -540, 540, 0);
+    }
+    urg_close(&urg);
+
+    printf("parser_split_test: %s\n", (failures > 0) ? "failed" : "passed");
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+/*!
+  \~japanese
+  \example raw_frame_test.c 応答の記録と後からのデコードの確認
+
+  urg_get_raw_frame() で記録した応答を urg_decode_raw_frame() でデコードし、生成した値と比べる。小さすぎる格納先で取得できなかった応答を再度取得できること、記録した応答が壊れていればエラーになることも確認する。センサは不要。
+  \~english
+  \example raw_frame_test.c Checks storing responses and decoding them later
+
+  Decodes the responses stored with urg_get_raw_frame() with urg_decode_raw_frame() and compares them with the generated values. Also checks that a response which did not fit in a too small destination can be obtained again, and that a damaged stored response is an error. No sensor is needed.
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_utils.h"
+#include "urg_errno.h"
+#include "replay_sensor.h"
+#include <stdio.h>
+#include <string.h>
+
+
+enum {
+    CAPTURE_TIMES = 3,
+    SMALL_FRAME_SIZE = 16,
+};
+
+
+static int failures = 0;
+static char frame[1 << REPLAY_SENSOR_BUFFER_SHIFT];
+static long data[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+static uint32_t data_uint32[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+static unsigned short intensity[URG_MAX_ECHO * (REPLAY_SENSOR_MAX_INDEX + 1)];
+
+
+static void fail(const char *message, urg_measurement_type_t type,
+                 int scan_times, int scan)
+{
+    printf("raw_frame_test: %s (type %d, %d times, scan %d)\n",
+           message, type, scan_times, scan);
+    ++failures;
+}
+
+
+// \~japanese 記録した応答をデコードし、生成した値と比べる
+// \~english Decodes the stored response and compares it with the generated values
+static void check_decode(const urg_t *urg, urg_measurement_type_t type,
+                         int frame_size, long time_stamp,
+                         int scan_times, int scan)
+{
+    static urg_t before;
+    int is_intensity =
+        (type == URG_DISTANCE_INTENSITY) || (type == URG_MULTIECHO_INTENSITY);
+    int max_echoes =
+        ((type == URG_MULTIECHO) || (type == URG_MULTIECHO_INTENSITY)) ?
+        URG_MAX_ECHO : 1;
+    int data_size = urg->scanning_last_step - urg->scanning_first_step + 1;
+    int first_index = urg->scanning_first_step + urg->front_data_index;
+    long decoded_time_stamp = -1;
+    int n;
+    int i;
+
+    memcpy(&before, urg, sizeof(before));
+
+    n = urg_decode_raw_frame(urg, frame, frame_size, data,
+                             is_intensity ? intensity : NULL,
+                             &decoded_time_stamp);
+    if (n != data_size) {
+        fail("urg_decode_raw_frame() size", type, scan_times, scan);
+        return;
+    }
+    if (decoded_time_stamp != time_stamp) {
+        fail("time stamps differ", type, scan_times, scan);
+    }
+    if (replay_sensor_count_errors(time_stamp, type, first_index, data,
+                                   is_intensity ? intensity : NULL, n) > 0) {
+        fail("decoded values differ", type, scan_times, scan);
+    }
+
+    n = urg_decode_raw_frame_uint32(urg, frame, frame_size, data_uint32,
+                                    NULL, NULL);
+    if (n != data_size) {
+        fail("urg_decode_raw_frame_uint32() size", type, scan_times, scan);
+        return;
+    }
+    for (i = 0; i < n * max_echoes; ++i) {
+        if ((long)data_uint32[i] != data[i]) {
+            fail("uint32_t values differ", type, scan_times, scan);
+            break;
+        }
+    }
+
+    if (memcmp(&before, urg, sizeof(before))) {
+        fail("urg_t was modified", type, scan_times, scan);
+    }
+}
+
+
+// \~japanese 記録した応答の 1 文字を変え、デコードがエラーになることを確認する
+// \~english Changes one character of the stored response and checks that decoding it is an error
+static void check_damaged_frame(const urg_t *urg, urg_measurement_type_t type,
+                                int frame_size, int scan_times)
+{
+    // \~japanese エコーバック、ステータス、タイムスタンプの後の、最初のデータ行の先頭
+    // \~english Start of the first data line, after the echoback, status and timestamp
+    char *p = strchr(strchr(strchr(frame, '\n') + 1, '\n') + 1, '\n') + 1;
+    int n;
+
+    *p = (char)((((*p - 0x30) + 1) & 0x3f) + 0x30);
+    n = urg_decode_raw_frame(urg, frame, frame_size, data, intensity, NULL);
+    if (n != URG_CHECKSUM_ERROR) {
+        fail("damaged stored response decoded", type, scan_times, 0);
+    }
+}
+
+
+static void check_type(urg_t *urg, urg_measurement_type_t type,
+                       int scan_times)
+{
+    urg_measurement_type_t received_type;
+    long time_stamp;
+    int small_size;
+    int n;
+    int i;
+
+    if (urg_start_measurement(urg, type, scan_times, 0) < 0) {
+        fail(urg_error(urg), type, scan_times, 0);
+        return;
+    }
+    for (i = 0; i < scan_times; ++i) {
+        // \~japanese 収まらないときは応答のバイト数を返し、応答は受信バッファに残る
+        // \~english A response that does not fit returns its size and stays in the receive buffer
+        received_type = URG_UNKNOWN;
+        time_stamp = -1;
+        small_size = urg_get_raw_frame(urg, frame, SMALL_FRAME_SIZE,
+                                       &received_type, &time_stamp);
+        if ((small_size <= SMALL_FRAME_SIZE) || (received_type != type) ||
+            (time_stamp < 0)) {
+            fail("response fitting in a small frame", type, scan_times, i);
+            return;
+        }
+
+        received_type = URG_UNKNOWN;
+        n = urg_get_raw_frame(urg, frame, sizeof(frame),
+                              &received_type, &time_stamp);
+        if (n != small_size) {
+            fail("retried response size differs", type, scan_times, i);
+            return;
+        }
+        if (received_type != type) {
+            fail("type differs", type, scan_times, i);
+        }
+        check_decode(urg, type, n, time_stamp, scan_times, i);
+
+        if (i == scan_times - 1) {
+            check_damaged_frame(urg, type, n, scan_times);
+        }
+    }
+}
+
+
+// \~japanese 受信したときにチェックサムの壊れた応答は、記録せずにエラーを返す
+// \~english A response whose checksum is damaged on reception is not stored and an error is returned
+static void check_damaged_response(urg_t *urg, replay_sensor_t *sensor)
+{
+    int n;
+
+    sensor->corrupt_scan = sensor->scan_count;
+    if (urg_start_measurement(urg, URG_DISTANCE, 1, 0) < 0) {
+        fail(urg_error(urg), URG_DISTANCE, 1, 0);
+        return;
+    }
+    n = urg_get_raw_frame(urg, frame, sizeof(frame), NULL, NULL);
+    if (n != URG_CHECKSUM_ERROR) {
+        fail("damaged response stored", URG_DISTANCE, 1, 0);
+    }
+    sensor->corrupt_scan = -1;
+}
+
+
+int main(void)
+{
+    urg_measurement_type_t types[] = {
+        URG_DISTANCE, URG_DISTANCE_INTENSITY,
+        URG_MULTIECHO, URG_MULTIECHO_INTENSITY,
+    };
+    replay_sensor_t sensor;
+    urg_t urg;
+    int i;
+
+    replay_sensor_initialize(&sensor);
+    if (replay_sensor_open(&urg, &sensor) < 0) {
+        printf("raw_frame_test: replay_sensor_open: %s\n", urg_error(&urg));
+        return 1;
+    }
+
+    for (i = 0; i < (int)(sizeof(types) / sizeof(types[0])); ++i) {
+        urg_set_scanning_parameter(&urg, -540, 540, 0);
+        check_type(&urg, types[i], 1);
+        check_type(&urg, types[i], CAPTURE_TIMES);
+
+        urg_set_scanning_parameter(&urg, -100, 200, 0);
+        check_type(&urg, types[i], CAPTURE_TIMES);
+    }
+    check_damaged_response(&urg, &sensor);
+    urg_close(&urg);
+
+    printf("raw_frame_test: %s\n", (failures > 0) ? "failed" : "passed");
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/*!
+  \~japanese
+  \example replay_recorded.c 記録したセンサの応答から距離データを取得する
+
+  センサを接続せずに、メモリ上の通信手段で記録した応答を再生する。デコードした距離が記録したときの値と異なれば 1 を返す。
+  \~english
+  \example replay_recorded.c Obtains distance data from recorded sensor responses
+
+  Replays recorded responses through the in-memory transport, without a sensor. Returns 1 if a decoded distance differs from the value at recording time.
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_utils.h"
+#include "urg_memory.h"
+#include <stdio.h>
+#include <string.h>
+
+
+// \~japanese UTM-30LX から記録した応答
+// \~english Responses recorded from an UTM-30LX
+typedef struct
+{
+    const char *command;
+    const char *response;
+} recorded_response_t;
+
+
+static const recorded_response_t recorded[] = {
+    { "QT\n", "QT\n" "00P\n" "\n" },
+    { "RS\n", "RS\n" "00P\n" "\n" },
+
+    { "PP\n",
+      "PP\n" "00P\n"
+      "MODL:UTM-30LX;@\n"
+      "DMIN:23;7\n"
+      "DMAX:60000;J\n"
+      "ARES:1440;^\n"
+      "AMIN:0;?\n"
+      "AMAX:1080;Z\n"
+      "AFRT:540;0\n"
+      "SCAN:2400;U\n"
+      "\n" },
+
+    { "MD0537054300003\n",
+      "MD0537054300003\n" "00P\n" "\n"
+      "MD0537054300002\n" "99b\n" "00?Xg\n" "0G`0Ga0Gc0Gd0Gf0Gg0Gio\n" "\n"
+      "MD0537054300001\n" "99b\n" "00@1A\n" "0Ga0Gb0Gc0Ge0Gf0Gh0Gi3\n" "\n"
+      "MD0537054300000\n" "99b\n" "00@JZ\n" "0G`0Gb0Gc0Gd0Gf0Gg0Gj1\n" "\n" },
+};
+
+
+// \~japanese 記録したときに UTM-30LX が出力した距離 [mm]
+// \~english Distances output by the UTM-30LX at recording time [mm]
+static const long expected_time_stamps[] = { 1000, 1025, 1050 };
+static const long expected_distances[][7] = {
+    { 1520, 1521, 1523, 1524, 1526, 1527, 1529 },
+    { 1521, 1522, 1523, 1525, 1526, 1528, 1529 },
+    { 1520, 1522, 1523, 1524, 1526, 1527, 1530 },
+};
+
+
+// \~japanese 送信されたコマンドに対応する応答を受信データに加える
+// \~english Adds the response of the sent command to the received data
+static void respond(void *user_data, const char *data, int size)
+{
+    urg_memory_t *memory = (urg_memory_t *)user_data;
+    int n = sizeof(recorded) / sizeof(recorded[0]);
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        const recorded_response_t *p = &recorded[i];
+        if ((size == (int)strlen(p->command)) &&
+            !strncmp(data, p->command, size)) {
+            memory_receive(memory, p->response, (int)strlen(p->response));
+            return;
+        }
+    }
+}
+
+
+int main(void)
+{
+    enum {
+        CAPTURE_TIMES = 3,
+        FIRST_STEP = -3,
+        LAST_STEP = +3,
+    };
+    urg_memory_t memory;
+    urg_connection_option_t option;
+    urg_t urg;
+    long data[LAST_STEP - FIRST_STEP + 1];
+    long time_stamp;
+    int n;
+    int i;
+    int j;
+    int mismatch = 0;
+
+    // \~japanese 記録した応答を返すメモリ上の通信手段で接続する
+    // \~english Connects through the in-memory transport which returns the recorded responses
+    memory_initialize(&memory);
+    memory.on_write = respond;
+    memory.user_data = &memory;
+
+    connection_option_initialize(&option);
+    option.transport = &memory_transport;
+    option.transport_context = &memory;
+
+    if (urg_open_with_option(&urg, URG_USER_TRANSPORT, "memory", 115200,
+                             &option) < 0) {
+        printf("urg_open_with_option: %s\n", urg_error(&urg));
+        return 1;
+    }
+
+    // \~japanese データ取得
+    // \~english Gets measurement data
+    urg_set_scanning_parameter(&urg, FIRST_STEP, LAST_STEP, 0);
+    urg_start_measurement(&urg, URG_DISTANCE, CAPTURE_TIMES, 0);
+    for (i = 0; i < CAPTURE_TIMES; ++i) {
+        n = urg_get_distance(&urg, data, &time_stamp);
+        if (n <= 0) {
+            printf("urg_get_distance: %s\n", urg_error(&urg));
+            urg_close(&urg);
+            return 1;
+        }
+
+        printf("%ld [msec]:", time_stamp);
+        for (j = 0; j < n; ++j) {
+            printf(" %ld", data[j]);
+        }
+        printf(" [mm]\n");
+
+        // \~japanese 記録したときの値と比べる
+        // \~english Compares with the values at recording time
+        if ((n != LAST_STEP - FIRST_STEP + 1) ||
+            (time_stamp != expected_time_stamps[i])) {
+            ++mismatch;
+            continue;
+        }
+        for (j = 0; j < n; ++j) {
+            if (data[j] != expected_distances[i][j]) {
+                ++mismatch;
+            }
+        }
+    }
+
+    // \~japanese 切断
+    // \~english Disconnects
+    urg_close(&urg);
+
+    if (mismatch > 0) {
+        printf("replay_recorded: %d values differ from the recording\n",
+               mismatch);
+        return 1;
+    }
+    return 0;
+}
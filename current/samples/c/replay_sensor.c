@@ -0,0 +1,392 @@
+/*!
+  \~japanese
+  \brief メモリ上で応答を生成する UTM-30LX
+  \~english
+  \brief UTM-30LX generating its responses in memory
+  \~
+
+  $Id$
+*/
+
+#include "replay_sensor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+enum {
+    SCAN_MSEC = 25,
+    FIRST_TIME_STAMP = 1000,
+    LINE_SIZE = 64,
+};
+
+
+static char checksum(const char *data, int size)
+{
+    int sum = 0;
+    int i;
+
+    for (i = 0; i < size; ++i) {
+        sum += (unsigned char)data[i];
+    }
+    return (char)((sum & 0x3f) + 0x30);
+}
+
+
+static int encode(char *data, long value, int width)
+{
+    int i;
+
+    for (i = width - 1; i >= 0; --i) {
+        data[i] = (char)((value & 0x3f) + 0x30);
+        value >>= 6;
+    }
+    return width;
+}
+
+
+static int parse_number(const char *data, int size)
+{
+    int value = 0;
+    int i;
+
+    for (i = 0; i < size; ++i) {
+        value = (value * 10) + (data[i] - '0');
+    }
+    return value;
+}
+
+
+long replay_sensor_distance(int scan, int index, int echo)
+{
+    if ((index % 17) == 0) {
+        // \~japanese センサのエラーコード
+        // \~english Error code of the sensor
+        return (index % 16) + 1;
+    }
+    return 1000 + index + (100 * echo) + (scan % 10);
+}
+
+
+unsigned short replay_sensor_intensity(int scan, int index, int echo)
+{
+    return (unsigned short)(500 + (index % 100) + echo + (scan % 10));
+}
+
+
+int replay_sensor_echoes(int index)
+{
+    if ((index % 17) == 0) {
+        return 1;
+    }
+    if ((index % 10) == 0) {
+        return 3;
+    } else if ((index % 5) == 0) {
+        return 2;
+    }
+    return 1;
+}
+
+
+int replay_sensor_count_errors(long time_stamp, urg_measurement_type_t type,
+                              int first_index, const long data[],
+                              const unsigned short intensity[], int n)
+{
+    int is_multiecho =
+        (type == URG_MULTIECHO) || (type == URG_MULTIECHO_INTENSITY);
+    int max_echoes = is_multiecho ? URG_MAX_ECHO : 1;
+    int scan = (int)((time_stamp - FIRST_TIME_STAMP) / SCAN_MSEC);
+    int errors = 0;
+    int i;
+
+    if ((time_stamp < FIRST_TIME_STAMP) ||
+        (((time_stamp - FIRST_TIME_STAMP) % SCAN_MSEC) != 0)) {
+        return n * max_echoes;
+    }
+
+    for (i = 0; i < n; ++i) {
+        int index = first_index + i;
+        int echoes = is_multiecho ? replay_sensor_echoes(index) : 1;
+        int echo;
+        for (echo = 0; echo < max_echoes; ++echo) {
+            int j = (i * max_echoes) + echo;
+            int exists = (echo < echoes);
+            long distance =
+                exists ? replay_sensor_distance(scan, index, echo) : 0;
+            unsigned short level =
+                exists ? replay_sensor_intensity(scan, index, echo) : 0;
+
+            if (data[j] != distance) {
+                ++errors;
+            }
+            if (intensity && (intensity[j] != level)) {
+                ++errors;
+            }
+        }
+    }
+    return errors;
+}
+
+
+static void flush_output(replay_sensor_t *sensor)
+{
+    int n = sensor->output_last - sensor->output_first;
+
+    if (n > 0) {
+        sensor->output_first +=
+            memory_receive(&sensor->memory,
+                           &sensor->output[sensor->output_first], n);
+    }
+    if (sensor->output_first >= sensor->output_last) {
+        sensor->output_first = 0;
+        sensor->output_last = 0;
+    }
+}
+
+
+static void add_output(replay_sensor_t *sensor, const char *data, int size)
+{
+    if ((sensor->output_last + size) > REPLAY_SENSOR_OUTPUT_SIZE) {
+        memmove(sensor->output, &sensor->output[sensor->output_first],
+                sensor->output_last - sensor->output_first);
+        sensor->output_last -= sensor->output_first;
+        sensor->output_first = 0;
+    }
+    if ((sensor->output_last + size) > REPLAY_SENSOR_OUTPUT_SIZE) {
+        fprintf(stderr, "replay_sensor: output overflow\n");
+        exit(1);
+    }
+    memcpy(&sensor->output[sensor->output_last], data, size);
+    sensor->output_last += size;
+}
+
+
+static void add_line(replay_sensor_t *sensor, const char *line,
+                     int has_checksum)
+{
+    char buffer[LINE_SIZE + 2];
+    int n = (int)strlen(line);
+
+    memcpy(buffer, line, n);
+    if (has_checksum) {
+        buffer[n] = checksum(line, n);
+        ++n;
+    }
+    buffer[n++] = '\n';
+    add_output(sensor, buffer, n);
+}
+
+
+static void add_response(replay_sensor_t *sensor, const char *command,
+                         const char *status, const char *lines[])
+{
+    add_line(sensor, command, 0);
+    add_line(sensor, status, 1);
+    for (; lines && *lines; ++lines) {
+        add_line(sensor, *lines, 1);
+    }
+    add_line(sensor, "", 0);
+}
+
+
+// \~japanese 計測データの応答を加える。まとめる step は先頭の step の値を返す
+// \~english Adds a response with measurement data. Grouped steps return the value of the first step
+static void add_scan(replay_sensor_t *sensor, const char *echoback,
+                     const char *status)
+{
+    char payload[REPLAY_SENSOR_OUTPUT_SIZE];
+    char line[LINE_SIZE + 1];
+    const char *command = sensor->command;
+    int is_multiecho = (command[0] == 'H') || (command[0] == 'N');
+    int is_intensity = (command[1] == 'E');
+    int width = (command[1] == 'S') ? 2 : 3;
+    int first_index = parse_number(&command[2], 4);
+    int last_index = parse_number(&command[6], 4);
+    int skip_step = parse_number(&command[10], 2);
+    int scan = sensor->scan_count;
+    int filled = 0;
+    int index;
+    int i;
+
+    if (skip_step <= 0) {
+        skip_step = 1;
+    }
+
+    for (index = first_index; index <= last_index; index += skip_step) {
+        int echoes = is_multiecho ? replay_sensor_echoes(index) : 1;
+        int echo;
+        for (echo = 0; echo < echoes; ++echo) {
+            if (echo > 0) {
+                payload[filled++] = '&';
+            }
+            filled += encode(&payload[filled],
+                             replay_sensor_distance(scan, index, echo), width);
+            if (is_intensity) {
+                filled += encode(&payload[filled],
+                                 replay_sensor_intensity(scan, index, echo), 3);
+            }
+        }
+    }
+
+    add_line(sensor, echoback, 0);
+    add_line(sensor, status, 1);
+    line[encode(line, FIRST_TIME_STAMP + (scan * SCAN_MSEC), 4)] = '\0';
+    add_line(sensor, line, 1);
+    for (i = 0; i < filled; i += LINE_SIZE) {
+        int n = ((filled - i) < LINE_SIZE) ? (filled - i) : LINE_SIZE;
+        int first = sensor->output_last;
+
+        memcpy(line, &payload[i], n);
+        line[n] = '\0';
+        add_line(sensor, line, 1);
+
+        if ((scan == sensor->corrupt_scan) && (i == 0)) {
+            // \~japanese 値を 1 文字変え、チェックサムを合わなくする
+            // \~english Changes one character so that the checksum does not match
+            char *p = &sensor->output[first];
+            *p = (char)((((*p - 0x30) + 1) & 0x3f) + 0x30);
+        }
+    }
+    add_line(sensor, "", 0);
+
+    ++sensor->scan_count;
+}
+
+
+static void add_next_scan(replay_sensor_t *sensor)
+{
+    char echoback[sizeof(sensor->command)];
+
+    if (sensor->remain_times > 0) {
+        --sensor->remain_times;
+        if (sensor->remain_times == 0) {
+            sensor->is_streaming = 0;
+        }
+    }
+    sprintf(echoback, "%.13s%02d", sensor->command, sensor->remain_times);
+    add_scan(sensor, echoback, "99");
+}
+
+
+static void on_write(void *user_data, const char *data, int size)
+{
+    static const char *pp_lines[] = {
+        "MODL:UTM-30LX;", "DMIN:23;", "DMAX:60000;", "ARES:1440;",
+        "AMIN:0;", "AMAX:1080;", "AFRT:540;", "SCAN:2400;", NULL,
+    };
+    static const char *vv_lines[] = {
+        "VEND:Hokuyo Automatic Co., Ltd.;", "PROD:UTM-30LX;",
+        "FIRM:1.1.0;", "PROT:SCIP 2.0;", "SERI:H0000042;", NULL,
+    };
+    static const char *ii_lines[] = {
+        "MODL:UTM-30LX;", "LASR:ON;", "SCSP:2400;", "MESM:Idle;",
+        "SBPS:Ethernet 100 [Mbps];", "TIME:0000;",
+        "STAT:Stable 000 no error.;", NULL,
+    };
+    replay_sensor_t *sensor = (replay_sensor_t *)user_data;
+    char command[sizeof(sensor->command)];
+    int n = 0;
+
+    while ((n < size) && (n < (int)sizeof(command) - 1) &&
+           (data[n] != '\n') && (data[n] != '\r')) {
+        command[n] = data[n];
+        ++n;
+    }
+    command[n] = '\0';
+
+    if (!strcmp(command, "QT") || !strcmp(command, "RS") ||
+        !strcmp(command, "RT")) {
+        sensor->is_streaming = 0;
+        add_response(sensor, command, "00", NULL);
+
+    } else if (!strcmp(command, "BM")) {
+        add_response(sensor, command, "00", NULL);
+
+    } else if (!strcmp(command, "PP")) {
+        ++sensor->pp_count;
+        add_response(sensor, command, "00", pp_lines);
+
+    } else if (!strcmp(command, "VV")) {
+        add_response(sensor, command, "00", vv_lines);
+
+    } else if (!strcmp(command, "II")) {
+        add_response(sensor, command, "00", ii_lines);
+
+    } else if (!strncmp(command, "TM", 2) && (n == 3)) {
+        char time_stamp[5];
+        const char *tm_lines[2];
+        tm_lines[0] = time_stamp;
+        tm_lines[1] = NULL;
+        time_stamp[encode(time_stamp, FIRST_TIME_STAMP, 4)] = '\0';
+        add_response(sensor, command, "00",
+                     (command[2] == '1') ? tm_lines : NULL);
+
+    } else if (strchr("GH", command[0]) && strchr("DSE", command[1]) &&
+               (n == 12)) {
+        strcpy(sensor->command, command);
+        add_scan(sensor, command, "00");
+
+    } else if (strchr("MN", command[0]) && strchr("DSE", command[1]) &&
+               (n == 15)) {
+        strcpy(sensor->command, command);
+        sensor->remain_times = parse_number(&command[13], 2);
+        sensor->is_streaming = 1;
+        add_response(sensor, command, "00", NULL);
+
+    } else {
+        add_response(sensor, command, "0E", NULL);
+    }
+    flush_output(sensor);
+}
+
+
+static void on_read(void *user_data)
+{
+    replay_sensor_t *sensor = (replay_sensor_t *)user_data;
+
+    if ((sensor->output_first >= sensor->output_last) &&
+        sensor->is_streaming) {
+        add_next_scan(sensor);
+    }
+    flush_output(sensor);
+}
+
+
+void replay_sensor_initialize(replay_sensor_t *sensor)
+{
+    memory_initialize(&sensor->memory);
+    sensor->memory.on_write = on_write;
+    sensor->memory.on_read = on_read;
+    sensor->memory.user_data = sensor;
+
+    sensor->output_first = 0;
+    sensor->output_last = 0;
+    sensor->command[0] = '\0';
+    sensor->remain_times = 0;
+    sensor->is_streaming = 0;
+    sensor->scan_count = 0;
+    sensor->corrupt_scan = -1;
+    sensor->pp_count = 0;
+}
+
+
+int replay_sensor_open(urg_t *urg, replay_sensor_t *sensor)
+{
+    return replay_sensor_open_with_cache(urg, sensor, NULL);
+}
+
+
+int replay_sensor_open_with_cache(urg_t *urg, replay_sensor_t *sensor,
+                                  urg_cache_t *cache)
+{
+    urg_connection_option_t option;
+
+    connection_option_initialize(&option);
+    option.transport = &memory_transport;
+    option.transport_context = &sensor->memory;
+    option.buffer = sensor->buffer;
+    option.buffer_shift_length = REPLAY_SENSOR_BUFFER_SHIFT;
+
+    return urg_open_with_cache(urg, URG_USER_TRANSPORT, "replay", 115200,
+                               &option, cache);
+}
@@ -0,0 +1,88 @@
+#ifndef REPLAY_SENSOR_H
+#define REPLAY_SENSOR_H
+
+/*!
+  \~japanese
+  \brief メモリ上で応答を生成する UTM-30LX
+
+  センサを接続せずに受信データの解析を確認するため、SCIP 2.0 の応答をチェックサム付きで生成し、メモリ上の通信手段で返す。距離と強度は replay_sensor_distance(), replay_sensor_intensity() で求まる値になる。
+  \~english
+  \brief UTM-30LX generating its responses in memory
+
+  Generates SCIP 2.0 responses with their checksums and returns them through the in-memory transport, to check the parsing of received data without a sensor. The distances and intensities are the values given by replay_sensor_distance() and replay_sensor_intensity().
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_memory.h"
+
+
+enum {
+    REPLAY_SENSOR_MIN_DISTANCE = 23,
+    REPLAY_SENSOR_MAX_INDEX = 1080,
+    REPLAY_SENSOR_OUTPUT_SIZE = 16384,
+
+    // \~japanese 1081 step のマルチエコーの距離と強度の応答 (約 9 KB) を 1 回分格納できる受信バッファ
+    // \~english Receive buffer holding one 1081-step multiecho distance and intensity response (about 9 KB)
+    REPLAY_SENSOR_BUFFER_SHIFT = 14,
+};
+
+
+typedef struct
+{
+    urg_memory_t memory;        //!< \~japanese メモリ上の通信手段  \~english In-memory transport
+    char buffer[1 << REPLAY_SENSOR_BUFFER_SHIFT]; //!< \~japanese 受信バッファ  \~english Receive buffer
+    char output[REPLAY_SENSOR_OUTPUT_SIZE]; //!< \~japanese 受信データに加えていない応答  \~english Responses not yet added to the received data
+    int output_first;           //!< \~japanese output の先頭位置  \~english First position in output
+    int output_last;            //!< \~japanese output の末尾位置  \~english Last position in output
+    char command[16];           //!< \~japanese 継続中の計測コマンド  \~english Measurement command in progress
+    int remain_times;           //!< \~japanese 残りの計測回数。0 のときは無限  \~english Remaining scans, 0 for infinity
+    int is_streaming;           //!< \~japanese 計測データを送信中か  \~english Whether measurement data is being sent
+    int scan_count;             //!< \~japanese 送信した計測データの個数  \~english Number of sent scans
+    int corrupt_scan;           //!< \~japanese データ行のチェックサムを壊す計測データの番号。負のときは壊さない  \~english Number of the scan whose data line checksum is broken, none if negative
+    int pp_count;               //!< \~japanese 受け取った PP コマンドの個数  \~english Number of received PP commands
+} replay_sensor_t;
+
+
+//! \~japanese 初期化  \~english Initialization
+extern void replay_sensor_initialize(replay_sensor_t *sensor);
+
+//! \~japanese sensor に接続する  \~english Connects to sensor
+extern int replay_sensor_open(urg_t *urg, replay_sensor_t *sensor);
+
+//! \~japanese 接続情報のキャッシュを使って sensor に接続する  \~english Connects to sensor using the cache of connection information
+extern int replay_sensor_open_with_cache(urg_t *urg, replay_sensor_t *sensor,
+                                         urg_cache_t *cache);
+
+//! \~japanese scan 番目の計測データの index, echo の距離 [mm]  \~english Distance of index and echo in the scan-th measurement data [mm]
+extern long replay_sensor_distance(int scan, int index, int echo);
+
+//! \~japanese scan 番目の計測データの index, echo の強度  \~english Intensity of index and echo in the scan-th measurement data
+extern unsigned short replay_sensor_intensity(int scan, int index, int echo);
+
+//! \~japanese index のエコー数  \~english Number of echoes at index
+extern int replay_sensor_echoes(int index);
+
+/*!
+  \~japanese
+  \brief 受信した計測データと生成した値との比較
+
+  time_stamp から何番目の計測データかを求め、first_index から n 個の data, intensity を replay_sensor_distance(), replay_sensor_intensity() の値と比べる。data, intensity は urg_get_distance() などと同じ形式で、マルチエコーの無いエコーは 0 とする。intensity が NULL のときは強度を比べない。
+
+  \retval 異なる値の個数
+
+  \~english
+  \brief Compares received measurement data with the generated values
+
+  Finds the scan number from time_stamp, and compares n values of data and intensity from first_index with replay_sensor_distance() and replay_sensor_intensity(). data and intensity have the same format as with urg_get_distance() and the others, and missing multiecho echoes are 0. The intensities are not compared if intensity is NULL.
+
+  \retval Number of differing values
+*/
+extern int replay_sensor_count_errors(long time_stamp,
+                                      urg_measurement_type_t type,
+                                      int first_index, const long data[],
+                                      const unsigned short intensity[], int n);
+
+#endif /* !REPLAY_SENSOR_H */
@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example sensor_parameter.c ZT̏o
+  \example sensor_parameter.c センサ情報の出力
   \~english
   \example sensor_parameter.c Outputs sensor information fields
   \~
@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example sync_time_stamp.c ZT PC ̃^CX^v𓯊
+  \example sync_time_stamp.c センサと PC のタイムスタンプを同期する
   \~english
   \example sync_time_stamp.c Timestamp synchronization between PC and sensor
   \~
@@ -55,7 +55,7 @@ static int pc_msec_time(void)
 
 /*!
   \~japanese
-  \brief PC ̃^CX^vɕ␳邽߂̒lԂ
+  \brief PC のタイムスタンプに補正するための値を返す
   \~english
   \brief Returns the timestamp (offset) necessary to correct the PC time
 */
@@ -105,11 +105,11 @@ int main(int argc, char *argv[])
 
     printf("# pc,\tsensor\n");
 
-    // \~japanese URG ̃^CX^v PC ̃^CX^v\
+    // \~japanese URG のタイムスタンプと PC のタイムスタンプを表示
     // \~english Prints the URG timestamp and the PC timestamp
     time_stamp_offset = print_time_stamp(&urg, 0);
 
-    // \~japanese URG ̕␳̃^CX^v PC ^CX^v\
+    // \~japanese URG の補正後のタイムスタンプと PC タイムスタンプを表示
     // \~english Prints the URG timestamp and the PC timestamp after correction
     for (i = 0; i < TIME_STAMP_PRINT_TIMES; ++i) {
         print_time_stamp(&urg, time_stamp_offset);
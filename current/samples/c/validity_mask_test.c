@@ -0,0 +1,194 @@
+/*!
+  \~japanese
+  \example validity_mask_test.c 有効ビットとデコードする範囲の確認
+
+  urg_set_validity_mask() の有効ビットを、urg_set_decode_regions() の範囲と組み合わせて、生成した値から求めたビットと比べる。範囲外のデータが変更されないことも確認する。センサは不要。
+  \~english
+  \example validity_mask_test.c Checks the validity bits with the decode regions
+
+  Compares the validity bits of urg_set_validity_mask(), combined with the ranges of urg_set_decode_regions(), with the bits expected from the generated values. Also checks that data outside the ranges is left untouched. No sensor is needed.
+  \~
+
+  $Id$
+*/
+
+#include "urg_sensor.h"
+#include "urg_utils.h"
+#include "replay_sensor.h"
+#include <stdio.h>
+#include <string.h>
+
+
+enum {
+    MAX_DATA_SIZE = REPLAY_SENSOR_MAX_INDEX + 1,
+    MASK_SIZE = (MAX_DATA_SIZE + 31) / 32,
+};
+
+
+static int failures = 0;
+static long data[URG_MAX_ECHO * MAX_DATA_SIZE];
+static unsigned short intensity[URG_MAX_ECHO * MAX_DATA_SIZE];
+static uint32_t mask[MASK_SIZE];
+
+
+static int get_data(urg_t *urg, urg_measurement_type_t type, long *time_stamp)
+{
+    switch (type) {
+    case URG_DISTANCE:
+        return urg_get_distance(urg, data, time_stamp);
+
+    case URG_DISTANCE_INTENSITY:
+        return urg_get_distance_intensity(urg, data, intensity, time_stamp);
+
+    case URG_MULTIECHO:
+        return urg_get_multiecho(urg, data, time_stamp);
+
+    default:
+        return urg_get_multiecho_intensity(urg, data, intensity, time_stamp);
+    }
+}
+
+
+static int is_in_regions(int step, const urg_step_region_t regions[],
+                         int region_count)
+{
+    int i;
+
+    if (region_count <= 0) {
+        return 1;
+    }
+    for (i = 0; i < region_count; ++i) {
+        if ((step >= regions[i].first_step) && (step <= regions[i].last_step)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static void check(urg_t *urg, urg_receive_mode_t mode,
+                  urg_measurement_type_t type, int first_step, int last_step,
+                  const urg_step_region_t regions[], int region_count)
+{
+    int is_intensity =
+        (type == URG_DISTANCE_INTENSITY) || (type == URG_MULTIECHO_INTENSITY);
+    int max_echoes =
+        ((type == URG_MULTIECHO) || (type == URG_MULTIECHO_INTENSITY)) ?
+        URG_MAX_ECHO : 1;
+    int first_index;
+    int wrong_bits = 0;
+    int wrong_values = 0;
+    long time_stamp;
+    int scan;
+    int n;
+    int i;
+
+    urg_set_receive_mode(urg, mode);
+    urg_set_scanning_parameter(urg, first_step, last_step, 0);
+    urg_set_decode_regions(urg, regions, region_count);
+    first_index = urg->scanning_first_step + urg->front_data_index;
+
+    // \~japanese 変更されないデータが分かるように、事前に埋めておく
+    // \~english Fills the destinations beforehand, so that untouched data can be told apart
+    memset(data, 0xff, sizeof(data));
+    memset(intensity, 0xff, sizeof(intensity));
+    memset(mask, 0xaa, sizeof(mask));
+
+    if (urg_start_measurement(urg, type, 1, 0) < 0) {
+        printf("validity_mask_test: urg_start_measurement: %s\n",
+               urg_error(urg));
+        ++failures;
+        return;
+    }
+    n = get_data(urg, type, &time_stamp);
+    if (n != last_step - first_step + 1) {
+        printf("validity_mask_test: mode %d, type %d: %d, %s\n",
+               mode, type, n, urg_error(urg));
+        ++failures;
+        return;
+    }
+    scan = (int)((time_stamp - 1000) / 25);
+
+    for (i = 0; i < MAX_DATA_SIZE; ++i) {
+        int bit = (mask[i / 32] >> (i % 32)) & 1;
+        int expected_bit = 0;
+        int j = i * max_echoes;
+
+        if ((i < n) &&
+            is_in_regions(first_step + i, regions, region_count)) {
+            expected_bit = (replay_sensor_distance(scan, first_index + i, 0)
+                            >= REPLAY_SENSOR_MIN_DISTANCE);
+            wrong_values +=
+                replay_sensor_count_errors(time_stamp, type, first_index + i,
+                                           &data[j],
+                                           is_intensity ? &intensity[j] : NULL,
+                                           1);
+        } else if (i < n) {
+            int echo;
+            for (echo = 0; echo < max_echoes; ++echo) {
+                if ((data[j + echo] != -1) ||
+                    (is_intensity && (intensity[j + echo] != 0xffff))) {
+                    ++wrong_values;
+                }
+            }
+        }
+        if (bit != expected_bit) {
+            ++wrong_bits;
+        }
+    }
+
+    if ((wrong_bits > 0) || (wrong_values > 0)) {
+        printf("validity_mask_test: mode %d, type %d, [%d, %d], "
+               "%d regions: %d wrong bits, %d wrong values\n",
+               mode, type, first_step, last_step, region_count,
+               wrong_bits, wrong_values);
+        ++failures;
+    }
+}
+
+
+int main(void)
+{
+    // \~japanese 範囲の端が 32 ビットの境界をまたぐようにする
+    // \~english Lets the ends of the ranges cross 32-bit boundaries
+    static const urg_step_region_t regions[] = {
+        { -509, -476 }, { -100, -50 }, { 0, 0 }, { 50, 100 },
+    };
+    urg_measurement_type_t types[] = {
+        URG_DISTANCE, URG_DISTANCE_INTENSITY,
+        URG_MULTIECHO, URG_MULTIECHO_INTENSITY,
+    };
+    urg_receive_mode_t modes[] = {
+        URG_RECEIVE_LINE, URG_RECEIVE_FRAME, URG_RECEIVE_EXACT_FRAME,
+    };
+    int region_count = sizeof(regions) / sizeof(regions[0]);
+    replay_sensor_t sensor;
+    urg_t urg;
+    int i;
+    int j;
+
+    replay_sensor_initialize(&sensor);
+    if (replay_sensor_open(&urg, &sensor) < 0) {
+        printf("validity_mask_test: replay_sensor_open: %s\n",
+               urg_error(&urg));
+        return 1;
+    }
+    urg_set_validity_mask(&urg, mask, MAX_DATA_SIZE);
+
+    for (i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])); ++i) {
+        for (j = 0; j < (int)(sizeof(types) / sizeof(types[0])); ++j) {
+            if ((modes[i] == URG_RECEIVE_EXACT_FRAME) &&
+                ((types[j] == URG_MULTIECHO) ||
+                 (types[j] == URG_MULTIECHO_INTENSITY))) {
+                continue;
+            }
+            check(&urg, modes[i], types[j], -540, 540, NULL, 0);
+            check(&urg, modes[i], types[j], -540, 540, regions, region_count);
+            check(&urg, modes[i], types[j], -80, 300, regions, region_count);
+        }
+    }
+    urg_close(&urg);
+
+    printf("validity_mask_test: %s\n", (failures > 0) ? "failed" : "passed");
+    return (failures > 0) ? 1 : 0;
+}
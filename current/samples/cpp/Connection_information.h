@@ -4,7 +4,7 @@
 /*!
   \file
   \~japanese
-  \brief ڑ̊Ǘ
+  \brief 接続情報の管理
   \~english
   \brief Maintains connection information
   \~
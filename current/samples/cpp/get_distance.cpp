@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example get_distance.cpp f[^擾
+  \example get_distance.cpp 距離データを取得する
   \~english
   \example get_distance.cpp Obtains distance data
   \~
@@ -24,14 +24,14 @@ namespace
                     const vector<long>& data, long time_stamp)
     {
 #if 1
-    // \~japanese Õf[^݂̂\
+    // \~japanese 前方のデータのみを表示
     // \~english Shows only the front step
         int front_index = urg.step2index(0);
         cout << data[front_index] << " [mm], ("
              << time_stamp << " [msec])" << endl;
 
 #else
-    // \~japanese SẴf[^ X-Y ̈ʒu\
+    // \~japanese 全てのデータの X-Y の位置を表示
     // \~english Prints the X-Y coordinates for all the measurement points
         long min_distance = urg.min_distance();
         long max_distance = urg.max_distance();
@@ -57,7 +57,7 @@ int main(int argc, char *argv[])
 {
     Connection_information information(argc, argv);
 
-    // \~japanese ڑ
+    // \~japanese 接続
     // \~english Connects to the sensor
     Urg_driver urg;
     if (!urg.open(information.device_or_ip_name(),
@@ -68,10 +68,10 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
 #if 1
-    // \~japanese f[^̎擾͈͂ύXꍇ
+    // \~japanese データの取得範囲を変更する場合
     // \~english Case where the measurement range (start/end steps) is defined
     urg.set_scanning_parameter(urg.deg2step(-90), urg.deg2step(+90), 0);
 #endif
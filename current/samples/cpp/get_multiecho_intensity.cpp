@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example get_multiecho_intensity.cpp Exf[^(}`GR[)擾
+  \example get_multiecho_intensity.cpp 距離・強度データ(マルチエコー)を取得する
   \~english
   \example get_multiecho_intensity.cpp Obtains multiecho distance and intensity data
   \~
@@ -17,7 +17,7 @@ using namespace qrk;
 using namespace std;
 
 
-// \~japanese Ax̃f[^\
+// \~japanese 距離、強度のデータを表示する
 // \~english Prints distance and intensity data
 namespace
 {
@@ -43,7 +43,7 @@ namespace
                     long time_stamp)
     {
 #if 1
-        // \~japanese Õf[^݂̂\
+        // \~japanese 前方のデータのみを表示
         // \~english Shows only the front step
         int front_index = urg.step2index(0);
         print_echo_data(data, intensity, front_index, urg.max_echo_size());
@@ -52,7 +52,7 @@ namespace
 #else
         static_cast<void>(urg);
 
-        // \~japanese SẴf[^\
+        // \~japanese 全てのデータを表示
         // \~english Prints the multiecho range/intensity values for all the measurement points
         size_t data_n = data.size();
         cout << "# n = " << data_n << ", timestamp = " << time_stamp << endl;
@@ -72,7 +72,7 @@ int main(int argc, char *argv[])
 {
     Connection_information information(argc, argv);
 
-    // \~japanese ڑ
+    // \~japanese 接続
     // \~english Connects to the sensor
     Urg_driver urg;
     if (!urg.open(information.device_or_ip_name(),
@@ -83,7 +83,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^擾
+    // \~japanese データ取得
     // \~english Gets measurement data
     enum { Capture_times = 10 };
     urg.start_measurement(Urg_driver::Multiecho_intensity, Urg_driver::Infinity_times, 0);
@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example sensor_parameter.cpp ZT̏o
+  \example sensor_parameter.cpp センサ情報の出力
   \~english
   \example sensor_parameter.cpp Outputs sensor information fields
   \~
@@ -21,7 +21,7 @@ int main(int argc, char *argv[])
 {
     Connection_information information(argc, argv);
 
-    // \~japanese ڑ
+    // \~japanese 接続
     // \~english Connects to the sensor
     Urg_driver urg;
     if (!urg.open(information.device_or_ip_name(),
@@ -32,7 +32,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese p[^̕\
+    // \~japanese パラメータ情報の表示
     // \~english Displays sensor parameters
     cout << "Sensor product type: " << urg.product_type() << endl;
     cout << "Sensor firmware version: " << urg.firmware_version() << endl;
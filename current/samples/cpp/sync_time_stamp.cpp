@@ -1,6 +1,6 @@
 /*!
   \~japanese
-  \example sync_time_stamp.cpp ZT PC ̃^CX^v𓯊
+  \example sync_time_stamp.cpp センサと PC のタイムスタンプを同期する
   \~english
   \example sync_time_stamp.cpp Timestamp synchronization between PC and sensor
   \~
@@ -40,7 +40,7 @@ int main(int argc, char *argv[])
 {
     Connection_information information(argc, argv);
 
-    // \~japanese ڑ
+    // \~japanese 接続
     // \~english Connects to the sensor
     Urg_driver urg;
     if (!urg.open(information.device_or_ip_name(),
@@ -51,26 +51,26 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese f[^͂PXebv̂ݎ擾
+    // \~japanese データは１ステップのみ取得する
     // \~english Will obtain only one step of measurement data
     int min_step = urg.min_step();
     urg.set_scanning_parameter(min_step, min_step);
 
     //
-    // \~japanese rp PC ƃZT̃^CX^v\
+    // \~japanese 比較用に PC とセンサのタイムスタンプを表示する
     // \~english Just to compare, shows the current PC timestamp and sensor timestamp
     print_timestamp(urg);
     cout << endl;
 
-    // \~japanese ZT PC ̃^CX^vݒ肵A
-    // \~japanese f[^擾Ƃɓ^CX^vA
-    // \~japanese PC 瓾^CX^vƓɂȂ悤ɂ
+    // \~japanese センサに PC のタイムスタンプを設定し、
+    // \~japanese 距離データを取得したときに得られるタイムスタンプが、
+    // \~japanese PC から得られるタイムスタンプと同じになるようにする
     // \~english Configures the PC timestamp into the sensor
     // \~english The timestamp value which comes in the measurement data
     // \~english will match the timestamp value from the PC
     urg.set_sensor_time_stamp(ticks());
 
-    // \~japanese ݒ PC ƃZT̃^CX^v\
+    // \~japanese 設定後に PC とセンサのタイムスタンプを表示する
     // \~english Displays the PC timestamp and sensor timestamp after configuration
     print_timestamp(urg);
 
@@ -0,0 +1,127 @@
+/*!
+  \file
+  \~japanese
+  \brief 接続情報のキャッシュ
+  \~english
+  \brief Cache of connection information
+  \~
+
+  $Id$
+*/
+
+#include "urg_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+
+void urg_cache_initialize(urg_cache_t *cache)
+{
+    cache->entry_count = 0;
+}
+
+
+urg_cache_entry_t *urg_cache_find(urg_cache_t *cache, const char *device)
+{
+    int i;
+
+    for (i = 0; i < cache->entry_count; ++i) {
+        if (!strcmp(cache->entries[i].device, device)) {
+            return &cache->entries[i];
+        }
+    }
+    return NULL;
+}
+
+
+urg_cache_entry_t *urg_cache_entry(urg_cache_t *cache, const char *device)
+{
+    urg_cache_entry_t *entry = urg_cache_find(cache, device);
+
+    if (entry) {
+        return entry;
+    }
+    if (strlen(device) >= URG_CACHE_DEVICE_SIZE) {
+        return NULL;
+    }
+
+    if (cache->entry_count >= URG_CACHE_MAX_ENTRIES) {
+        // \~japanese 最も古く追加した接続情報を取り除く
+        // \~english Removes the entry added first
+        memmove(&cache->entries[0], &cache->entries[1],
+                (URG_CACHE_MAX_ENTRIES - 1) * sizeof(cache->entries[0]));
+        cache->entry_count = URG_CACHE_MAX_ENTRIES - 1;
+    }
+
+    entry = &cache->entries[cache->entry_count++];
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->device, device);
+    return entry;
+}
+
+
+int urg_cache_is_valid(const urg_cache_entry_t *entry)
+{
+    return (entry->scan_usec > 0) &&
+        (entry->max_distance > entry->min_distance) &&
+        (entry->area_resolution > 0) &&
+        (entry->first_data_index <= entry->front_data_index) &&
+        (entry->front_data_index <= entry->last_data_index) &&
+        (entry->baudrate >= 0);
+}
+
+
+int urg_cache_load(urg_cache_t *cache, const char *file_name)
+{
+    char line[URG_CACHE_DEVICE_SIZE + URG_CACHE_SERIAL_ID_SIZE + 128];
+    FILE *fd = fopen(file_name, "r");
+
+    if (!fd) {
+        return -1;
+    }
+
+    urg_cache_initialize(cache);
+    while (fgets(line, sizeof(line), fd) &&
+           (cache->entry_count < URG_CACHE_MAX_ENTRIES)) {
+        urg_cache_entry_t *entry = &cache->entries[cache->entry_count];
+
+        // \~japanese 形式が合わない行と、値が無効な行は読み飛ばす
+        // \~english Lines in another format and lines with invalid values are skipped
+        memset(entry, 0, sizeof(*entry));
+        if ((sscanf(line, "%63[^\t]\t%31[^\t]\t%ld\t%d\t%d\t%d\t%d\t%d\t%d\t%ld",
+                    entry->device, entry->serial_id, &entry->baudrate,
+                    &entry->min_distance, &entry->max_distance,
+                    &entry->area_resolution, &entry->first_data_index,
+                    &entry->last_data_index, &entry->front_data_index,
+                    &entry->scan_usec) == 10) &&
+            urg_cache_is_valid(entry)) {
+            ++cache->entry_count;
+        }
+    }
+    fclose(fd);
+
+    return cache->entry_count;
+}
+
+
+int urg_cache_save(const urg_cache_t *cache, const char *file_name)
+{
+    FILE *fd = fopen(file_name, "w");
+    int i;
+
+    if (!fd) {
+        return -1;
+    }
+
+    for (i = 0; i < cache->entry_count; ++i) {
+        const urg_cache_entry_t *entry = &cache->entries[i];
+        fprintf(fd, "%s\t%s\t%ld\t%d\t%d\t%d\t%d\t%d\t%d\t%ld\n",
+                entry->device, entry->serial_id, entry->baudrate,
+                entry->min_distance, entry->max_distance,
+                entry->area_resolution, entry->first_data_index,
+                entry->last_data_index, entry->front_data_index,
+                entry->scan_usec);
+    }
+    fclose(fd);
+
+    return cache->entry_count;
+}
@@ -1,111 +1,480 @@
-/*!
-  \file
-  \~japanese
-  \brief ʐM̏
-  \~english
-  \brief Communication related functions
-  \~
-  \author Satofumi KAMIMURA
-
-  $Id$
-*/
-
-#include "urg_connection.h"
-
-
-int connection_open(urg_connection_t *connection,
-                    urg_connection_type_t connection_type,
-                    const char *device, long baudrate_or_port)
-{
-    connection->type = connection_type;
-
-    switch (connection_type) {
-    case URG_SERIAL:
-        return serial_open(&connection->serial, device, baudrate_or_port);
-        break;
-
-    case URG_ETHERNET:
-        return tcpclient_open(&connection->tcpclient,
-                              device, baudrate_or_port);
-        break;
-    }
-    return -1;
-}
-
-
-void connection_close(urg_connection_t *connection)
-{
-    switch (connection->type) {
-    case URG_SERIAL:
-        serial_close(&connection->serial);
-        break;
-
-    case URG_ETHERNET:
-        tcpclient_close(&connection->tcpclient);
-        break;
-    }
-}
-
-
-int connection_set_baudrate(urg_connection_t *connection, long baudrate)
-{
-    int ret = -1;
-
-    switch (connection->type) {
-    case URG_SERIAL:
-        ret = serial_set_baudrate(&connection->serial, baudrate);
-        break;
-
-    case URG_ETHERNET:
-        ret = 0;
-        break;
-    }
-
-    return ret;
-}
-
-
-int connection_write(urg_connection_t *connection,
-                     const char *data, int size)
-{
-    switch (connection->type) {
-    case URG_SERIAL:
-        return serial_write(&connection->serial, data, size);
-        break;
-    case URG_ETHERNET:
-        return tcpclient_write(&connection->tcpclient, data, size);
-        break;
-    }
-    return -1;
-}
-
-
-int connection_read(urg_connection_t *connection,
-                    char *data, int max_size, int timeout)
-{
-    switch (connection->type) {
-    case URG_SERIAL:
-        return serial_read(&connection->serial, data, max_size, timeout);
-        break;
-    case URG_ETHERNET:
-        return tcpclient_read(&connection->tcpclient, data, max_size, timeout);
-        break;
-    }
-    return -1;
-}
-
-
-int connection_readline(urg_connection_t *connection,
-                        char *data, int max_size, int timeout)
-{
-    switch (connection->type) {
-    case URG_SERIAL:
-        return serial_readline(&connection->serial, data, max_size, timeout);
-        break;
-    case URG_ETHERNET:
-        return tcpclient_readline(&connection->tcpclient,
-                                  data, max_size, timeout);
-        break;
-    }
-    return -1;
-}
+/*!
+  \file
+  \~japanese
+  \brief 通信の処理
+  \~english
+  \brief Communication related functions
+  \~
+  \author Satofumi KAMIMURA
+
+  $Id$
+*/
+
+#include "urg_connection.h"
+#include <stddef.h>
+#include <string.h>
+#if defined(__MACH__)
+#include <mach/mach_time.h>
+#elif !defined(URG_WINDOWS_OS)
+#include <time.h>
+#endif
+
+
+// \~japanese シリアル接続の通信手段
+// \~english Transport of the serial connection
+static int serial_transport_open(void *context, const char *device,
+                                 long baudrate,
+                                 const urg_connection_option_t *option)
+{
+    urg_serial_t *serial = (urg_serial_t *)context;
+    int ret = serial_open(serial, device, baudrate);
+
+    if ((ret >= 0) && option && option->buffer) {
+        serial_set_buffer(serial, option->buffer, option->buffer_shift_length);
+    }
+    return ret;
+}
+
+
+static void serial_transport_close(void *context)
+{
+    serial_close((urg_serial_t *)context);
+}
+
+
+static int serial_transport_set_baudrate(void *context, long baudrate)
+{
+    return serial_set_baudrate((urg_serial_t *)context, baudrate);
+}
+
+
+static int serial_transport_write(void *context, const char *data, int size)
+{
+    return serial_write((urg_serial_t *)context, data, size);
+}
+
+
+static int serial_transport_read(void *context,
+                                 char *data, int max_size, int timeout)
+{
+    return serial_read((urg_serial_t *)context, data, max_size, timeout);
+}
+
+
+static int serial_transport_readline(void *context,
+                                     char *data, int max_size, int timeout)
+{
+    return serial_readline((urg_serial_t *)context, data, max_size, timeout);
+}
+
+
+static ring_buffer_t *serial_transport_buffer(void *context)
+{
+    return &((urg_serial_t *)context)->ring;
+}
+
+
+static int serial_transport_fill(void *context, int size, int timeout)
+{
+    return serial_fill((urg_serial_t *)context, size, timeout);
+}
+
+
+static const urg_transport_t serial_transport = {
+    serial_transport_open,
+    serial_transport_close,
+    serial_transport_set_baudrate,
+    serial_transport_write,
+    serial_transport_read,
+    serial_transport_readline,
+    serial_transport_buffer,
+    serial_transport_fill,
+};
+
+
+// \~japanese イーサーネット接続の通信手段
+// \~english Transport of the Ethernet connection
+static int tcpclient_transport_open(void *context, const char *address,
+                                    long port,
+                                    const urg_connection_option_t *option)
+{
+    urg_tcpclient_t *cli = (urg_tcpclient_t *)context;
+    int ret = tcpclient_open_with_option(cli, address, port,
+                                         option ? &option->tcpclient : NULL);
+
+    if ((ret >= 0) && option && option->buffer) {
+        tcpclient_set_buffer(cli, option->buffer, option->buffer_shift_length);
+    }
+    return ret;
+}
+
+
+static void tcpclient_transport_close(void *context)
+{
+    tcpclient_close((urg_tcpclient_t *)context);
+}
+
+
+static int tcpclient_transport_write(void *context, const char *data, int size)
+{
+    return tcpclient_write((urg_tcpclient_t *)context, data, size);
+}
+
+
+static int tcpclient_transport_read(void *context,
+                                    char *data, int max_size, int timeout)
+{
+    return tcpclient_read((urg_tcpclient_t *)context, data, max_size, timeout);
+}
+
+
+static int tcpclient_transport_readline(void *context,
+                                        char *data, int max_size, int timeout)
+{
+    return tcpclient_readline((urg_tcpclient_t *)context,
+                              data, max_size, timeout);
+}
+
+
+static ring_buffer_t *tcpclient_transport_buffer(void *context)
+{
+    return &((urg_tcpclient_t *)context)->rb;
+}
+
+
+static int tcpclient_transport_fill(void *context, int size, int timeout)
+{
+    return tcpclient_fill((urg_tcpclient_t *)context, size, timeout);
+}
+
+
+static const urg_transport_t tcpclient_transport = {
+    tcpclient_transport_open,
+    tcpclient_transport_close,
+    NULL,
+    tcpclient_transport_write,
+    tcpclient_transport_read,
+    tcpclient_transport_readline,
+    tcpclient_transport_buffer,
+    tcpclient_transport_fill,
+};
+
+
+int connection_open(urg_connection_t *connection,
+                    urg_connection_type_t connection_type,
+                    const char *device, long baudrate_or_port)
+{
+    return connection_open_with_option(connection, connection_type,
+                                       device, baudrate_or_port, NULL);
+}
+
+
+void connection_option_initialize(urg_connection_option_t *option)
+{
+    option->buffer = NULL;
+    option->buffer_shift_length = 0;
+    tcpclient_option_initialize(&option->tcpclient);
+    option->transport = NULL;
+    option->transport_context = NULL;
+}
+
+
+int connection_open_with_option(urg_connection_t *connection,
+                                urg_connection_type_t connection_type,
+                                const char *device, long baudrate_or_port,
+                                const urg_connection_option_t *option)
+{
+    connection->type = connection_type;
+    connection->transport = NULL;
+    connection->context = NULL;
+
+    if (option && option->buffer &&
+        ((option->buffer_shift_length < URG_CONNECTION_MIN_BUFFER_SHIFT) ||
+         (option->buffer_shift_length > URG_CONNECTION_MAX_BUFFER_SHIFT))) {
+        return -1;
+    }
+
+    switch (connection_type) {
+    case URG_SERIAL:
+        connection->transport = &serial_transport;
+        connection->context = &connection->serial;
+        break;
+
+    case URG_ETHERNET:
+        connection->transport = &tcpclient_transport;
+        connection->context = &connection->tcpclient;
+        break;
+
+    case URG_USER_TRANSPORT:
+        if (option) {
+            connection->transport = option->transport;
+            connection->context = option->transport_context;
+        }
+        break;
+    }
+
+    if (!connection->transport) {
+        return -1;
+    }
+    if (!connection->transport->open) {
+        return 0;
+    }
+    return connection->transport->open(connection->context,
+                                       device, baudrate_or_port, option);
+}
+
+
+void connection_close(urg_connection_t *connection)
+{
+    if (connection->transport && connection->transport->close) {
+        connection->transport->close(connection->context);
+    }
+}
+
+
+int connection_set_baudrate(urg_connection_t *connection, long baudrate)
+{
+    if (!connection->transport) {
+        return -1;
+    }
+    if (!connection->transport->set_baudrate) {
+        return 0;
+    }
+    return connection->transport->set_baudrate(connection->context, baudrate);
+}
+
+
+int connection_write(urg_connection_t *connection,
+                     const char *data, int size)
+{
+    if (!connection->transport) {
+        return -1;
+    }
+    return connection->transport->write(connection->context, data, size);
+}
+
+
+int connection_read(urg_connection_t *connection,
+                    char *data, int max_size, int timeout)
+{
+    if (!connection->transport) {
+        return -1;
+    }
+    return connection->transport->read(connection->context,
+                                       data, max_size, timeout);
+}
+
+
+int connection_readline(urg_connection_t *connection,
+                        char *data, int max_size, int timeout)
+{
+    if (!connection->transport) {
+        return -1;
+    }
+    return connection->transport->readline(connection->context,
+                                           data, max_size, timeout);
+}
+
+
+static ring_buffer_t *connection_buffer(urg_connection_t *connection)
+{
+    if (!connection->transport || !connection->transport->buffer ||
+        !connection->transport->fill) {
+        return NULL;
+    }
+    return connection->transport->buffer(connection->context);
+}
+
+
+long connection_ticks(void)
+{
+#if defined(URG_WINDOWS_OS)
+    return (long)GetTickCount();
+#elif defined(__MACH__)
+    // \~japanese 古い OS X には clock_gettime() が無いため、mach_absolute_time() を使う
+    // \~english Older OS X has no clock_gettime(), mach_absolute_time() is used
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    return (long)(mach_absolute_time() * timebase.numer / timebase.denom
+                  / 1000000);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+#endif
+}
+
+
+// \~japanese deadline までの残り時間を返す。timeout が負のときは -1 (タイムアウトなし) を返す
+// \~english Returns the time left until deadline, or -1 (no timeout) if timeout is negative
+static int connection_remaining(long deadline, int timeout)
+{
+    long remaining;
+
+    if (timeout < 0) {
+        return -1;
+    }
+    remaining = deadline - connection_ticks();
+    return (remaining > 0) ? (int)remaining : 0;
+}
+
+
+// \~japanese 受信バッファに size バイト以上が格納されるまで受信する
+// \~english Receives until the receive buffer stores at least size bytes
+static int connection_fill(urg_connection_t *connection, int size, int timeout)
+{
+    return connection->transport->fill(connection->context, size, timeout);
+}
+
+
+// \~japanese start 以降で最初の LF LF の、２つ目の LF の位置を返す
+// \~english Returns the position of the second LF of the first LF LF after start
+static int find_frame_end(const ring_span_t spans[2], int start, int size)
+{
+    int i = start;
+
+    while (i < (size - 1)) {
+        const char *p;
+        char next_ch;
+
+        if (i < spans[0].size) {
+            p = memchr(&spans[0].data[i], '\n', spans[0].size - i);
+            if (!p) {
+                i = spans[0].size;
+                continue;
+            }
+            i = (int)(p - spans[0].data);
+        } else {
+            p = memchr(&spans[1].data[i - spans[0].size], '\n', size - i);
+            if (!p) {
+                return -1;
+            }
+            i = spans[0].size + (int)(p - spans[1].data);
+        }
+
+        if (i + 1 >= size) {
+            break;
+        }
+        next_ch = (i + 1 < spans[0].size) ?
+            spans[0].data[i + 1] : spans[1].data[i + 1 - spans[0].size];
+        if (next_ch == '\n') {
+            return i + 1;
+        }
+        ++i;
+    }
+    return -1;
+}
+
+
+int connection_peek_frame(urg_connection_t *connection,
+                          char **frame, int timeout)
+{
+    ring_buffer_t *ring = connection_buffer(connection);
+    long deadline = connection_ticks() + timeout;
+    int scanned_size = 0;
+
+    if (!ring) {
+        return -1;
+    }
+
+    while (1) {
+        ring_span_t spans[2];
+        int size = ring_peek(ring, spans);
+        int last_index = find_frame_end(spans,
+                                        (scanned_size > 0) ?
+                                        scanned_size - 1 : 0, size);
+        if (last_index >= 0) {
+            // \~japanese 応答が折り返しているときは、連続した領域に並べ替える
+            // \~english If the response wraps around, makes it contiguous
+            *frame = (last_index < spans[0].size) ?
+                spans[0].data : ring_linearize(ring);
+            return last_index + 1;
+        }
+        scanned_size = size;
+
+        if (size >= ring_capacity(ring)) {
+            return URG_CONNECTION_OVERFLOW;
+        }
+        if (connection_fill(connection, size + 1,
+                            connection_remaining(deadline, timeout)) <= 0) {
+            return URG_CONNECTION_TIMEOUT;
+        }
+    }
+}
+
+
+int connection_peek_lines(urg_connection_t *connection,
+                          char **data, int line_count, int timeout)
+{
+    ring_buffer_t *ring = connection_buffer(connection);
+    long deadline = connection_ticks() + timeout;
+    int scanned_size = 0;
+    int found_count = 0;
+
+    if (!ring) {
+        return -1;
+    }
+
+    while (1) {
+        ring_span_t spans[2];
+        int size = ring_peek(ring, spans);
+        int i;
+
+        for (i = scanned_size; i < size; ++i) {
+            char ch = (i < spans[0].size) ?
+                spans[0].data[i] : spans[1].data[i - spans[0].size];
+            if ((ch == '\n') && (++found_count >= line_count)) {
+                *data = (i < spans[0].size) ?
+                    spans[0].data : ring_linearize(ring);
+                return i + 1;
+            }
+        }
+        scanned_size = size;
+
+        if (size >= ring_capacity(ring)) {
+            return URG_CONNECTION_OVERFLOW;
+        }
+        if (connection_fill(connection, size + 1,
+                            connection_remaining(deadline, timeout)) <= 0) {
+            return URG_CONNECTION_TIMEOUT;
+        }
+    }
+}
+
+
+int connection_peek(urg_connection_t *connection,
+                    char **data, int size, int timeout)
+{
+    ring_buffer_t *ring = connection_buffer(connection);
+    long deadline = connection_ticks() + timeout;
+    ring_span_t spans[2];
+
+    if (!ring) {
+        return -1;
+    }
+    if (size > ring_capacity(ring)) {
+        return URG_CONNECTION_OVERFLOW;
+    }
+
+    while (ring_size(ring) < size) {
+        if (connection_fill(connection, size,
+                            connection_remaining(deadline, timeout)) <= 0) {
+            return URG_CONNECTION_TIMEOUT;
+        }
+    }
+
+    ring_peek(ring, spans);
+    *data = (size <= spans[0].size) ? spans[0].data : ring_linearize(ring);
+    return size;
+}
+
+
+void connection_consume(urg_connection_t *connection, int size)
+{
+    ring_buffer_t *ring = connection_buffer(connection);
+    if (ring) {
+        ring_consume(ring, size);
+    }
+}
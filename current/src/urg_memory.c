@@ -0,0 +1,132 @@
+/*!
+  \file
+  \~japanese
+  \brief メモリ上の通信手段
+  \~english
+  \brief In-memory transport
+  \~
+
+  $Id$
+*/
+
+#include "urg_memory.h"
+#include <stddef.h>
+#include <string.h>
+
+
+void memory_initialize(urg_memory_t *memory)
+{
+    ring_initialize(&memory->ring, memory->buffer, RING_BUFFER_SIZE_SHIFT);
+    memory->on_write = NULL;
+    memory->on_read = NULL;
+    memory->user_data = NULL;
+}
+
+
+int memory_receive(urg_memory_t *memory, const char *data, int size)
+{
+    return ring_write(&memory->ring, data, size);
+}
+
+
+// \~japanese 受信バッファに size バイト以上が格納されるか、timeout [msec] が経過するまで on_read を呼び出す。timeout が負のときは待ち続ける
+// \~english Calls on_read until the receive buffer stores at least size bytes or timeout [msec] elapses. Waits forever if timeout is negative
+static int memory_fill(void *context, int size, int timeout)
+{
+    urg_memory_t *memory = (urg_memory_t *)context;
+    long deadline = connection_ticks() + timeout;
+    int first_size = ring_size(&memory->ring);
+    int current_size = first_size;
+
+    while ((current_size < size) && memory->on_read) {
+        memory->on_read(memory->user_data);
+        if (ring_size(&memory->ring) != current_size) {
+            current_size = ring_size(&memory->ring);
+        } else if ((timeout >= 0) && (connection_ticks() >= deadline)) {
+            // \~japanese timeout までに供給されるデータが無い
+            // \~english No data was supplied within timeout
+            break;
+        }
+    }
+    return current_size - first_size;
+}
+
+
+static int memory_open(void *context, const char *device, long baudrate,
+                       const urg_connection_option_t *option)
+{
+    urg_memory_t *memory = (urg_memory_t *)context;
+
+    (void)device;
+    (void)baudrate;
+
+    if (option && option->buffer) {
+        ring_initialize(&memory->ring,
+                        option->buffer, option->buffer_shift_length);
+    } else {
+        ring_initialize(&memory->ring, memory->buffer, RING_BUFFER_SIZE_SHIFT);
+    }
+    return 0;
+}
+
+
+static void memory_close(void *context)
+{
+    urg_memory_t *memory = (urg_memory_t *)context;
+    ring_clear(&memory->ring);
+}
+
+
+static int memory_write(void *context, const char *data, int size)
+{
+    urg_memory_t *memory = (urg_memory_t *)context;
+
+    if (memory->on_write) {
+        memory->on_write(memory->user_data, data, size);
+    }
+    return size;
+}
+
+
+static int memory_read(void *context, char *data, int max_size, int timeout)
+{
+    urg_memory_t *memory = (urg_memory_t *)context;
+    int filled = 0;
+
+    while (filled < max_size) {
+        filled += ring_read(&memory->ring, &data[filled], max_size - filled);
+        if ((filled >= max_size) || (memory_fill(memory, 1, timeout) <= 0)) {
+            break;
+        }
+    }
+    return (filled > 0) ? filled : URG_CONNECTION_TIMEOUT;
+}
+
+
+static int memory_readline(void *context,
+                           char *data, int max_size, int timeout)
+{
+    urg_memory_t *memory = (urg_memory_t *)context;
+    int n = ring_readline(&memory->ring, data, max_size,
+                          memory_fill, memory, timeout);
+
+    return (n < 0) ? URG_CONNECTION_TIMEOUT : n;
+}
+
+
+static ring_buffer_t *memory_buffer(void *context)
+{
+    return &((urg_memory_t *)context)->ring;
+}
+
+
+const urg_transport_t memory_transport = {
+    memory_open,
+    memory_close,
+    NULL,
+    memory_write,
+    memory_read,
+    memory_readline,
+    memory_buffer,
+    memory_fill,
+};
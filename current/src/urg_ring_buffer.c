@@ -1,122 +1,244 @@
-/*!
-  \file
-  \~japanese 
-  \brief Oobt@
-  \~english 
-  \brief Implements a ring buffer
-  \~
-  \author Satofumi KAMIMURA
-
-  $Id$
-*/
-
-#include "urg_ring_buffer.h"
-
-
-void ring_initialize(ring_buffer_t *ring, char *buffer, const int shift_length)
-{
-    ring->buffer = buffer;
-    ring->buffer_size = 1 << shift_length;
-    ring_clear(ring);
-}
-
-
-void ring_clear(ring_buffer_t *ring)
-{
-    ring->first = 0;
-    ring->last = 0;
-}
-
-
-int ring_size(const ring_buffer_t *ring)
-{
-    int first = ring->first;
-    int last = ring->last;
-
-    return (last >= first) ? last - first : ring->buffer_size - (first - last);
-}
-
-
-int ring_capacity(const ring_buffer_t *ring)
-{
-    return ring->buffer_size - 1;
-}
-
-
-static void byte_move(char *dest, const char *src, int n)
-{
-    const char *last_p = dest + n;
-    while (dest < last_p) {
-        *dest++ = *src++;
-    }
-}
-
-
-int ring_write(ring_buffer_t *ring, const char *data, int size)
-{
-    int free_size = ring_capacity(ring) - ring_size(ring);
-    int push_size = (size > free_size) ? free_size : size;
-
-    // \~japanese f[^zu
-    // \~english Stores the data
-    if (ring->first <= ring->last) {
-        // \~japanese last  buffer_size I[܂łɔzu
-        // \~english Stores data at the last element of the buffer and before buffer_size
-        int left_size = 0;
-        int to_end = ring->buffer_size - ring->last;
-        int move_size = (to_end > push_size) ? push_size : to_end;
-
-        byte_move(&ring->buffer[ring->last], data, move_size);
-        ring->last += move_size;
-        ring->last &= (ring->buffer_size -1);
-
-        left_size = push_size - move_size;
-        if (left_size > 0) {
-            // \~japanese 0  first ̑O܂łzu
-	    // \~english Stores data before the first element
-            byte_move(ring->buffer, &data[move_size], left_size);
-            ring->last = left_size;
-        }
-    } else {
-        // \~japanese last  first ̑O܂Ŕzu
-        // \~english Stores data from last towards first
-        byte_move(&ring->buffer[ring->last], data, size);
-        ring->last += push_size;
-    }
-    return push_size;
-}
-
-
-int ring_read(ring_buffer_t *ring, char *buffer, int size)
-{
-    // \~japanese f[^擾
-    // \~english Reads data
-    int now_size = ring_size(ring);
-    int pop_size = (size > now_size) ? now_size : size;
-
-    if (ring->first <= ring->last) {
-        byte_move(buffer, &ring->buffer[ring->first], pop_size);
-        ring->first += pop_size;
-
-    } else {
-        // \~japanese first  buffer_size I[܂łzu
-        // \~english Gets data from first element of the buffer and before buffer_size
-        int left_size = 0;
-        int to_end = ring->buffer_size - ring->first;
-        int move_size = (to_end > pop_size) ? pop_size : to_end;
-        byte_move(buffer, &ring->buffer[ring->first], move_size);
-
-        ring->first += move_size;
-        ring->first &= (ring->buffer_size -1);
-
-        left_size = pop_size - move_size;
-        if (left_size > 0) {
-            // \~japanese 0  last ̑O܂łzu
-	    // \~english Gets data before the last element
-            byte_move(&buffer[move_size], ring->buffer, left_size);
-
-            ring->first = left_size;
-        }
-    }
-    return pop_size;
-}
+/*!
+  \file
+  \~japanese 
+  \brief リングバッファ
+  \~english 
+  \brief Implements a ring buffer
+  \~
+  \author Satofumi KAMIMURA
+
+  $Id$
+*/
+
+#include "urg_ring_buffer.h"
+#include <string.h>
+
+
+void ring_initialize(ring_buffer_t *ring, char *buffer, const int shift_length)
+{
+    ring->buffer = buffer;
+    ring->buffer_size = 1 << shift_length;
+    ring_clear(ring);
+}
+
+
+void ring_clear(ring_buffer_t *ring)
+{
+    ring->first = 0;
+    ring->last = 0;
+}
+
+
+int ring_size(const ring_buffer_t *ring)
+{
+    int first = ring->first;
+    int last = ring->last;
+
+    return (last >= first) ? last - first : ring->buffer_size - (first - last);
+}
+
+
+int ring_capacity(const ring_buffer_t *ring)
+{
+    return ring->buffer_size - 1;
+}
+
+
+int ring_peek(const ring_buffer_t *ring, ring_span_t spans[2])
+{
+    spans[0].data = &ring->buffer[ring->first];
+    spans[1].data = ring->buffer;
+
+    if (ring->first <= ring->last) {
+        spans[0].size = ring->last - ring->first;
+        spans[1].size = 0;
+    } else {
+        // \~japanese first から buffer_size 終端まで、0 から last の前まで
+        // \~english From first to the end of the buffer, and from 0 to before last
+        spans[0].size = ring->buffer_size - ring->first;
+        spans[1].size = ring->last;
+    }
+    return spans[0].size + spans[1].size;
+}
+
+
+void ring_consume(ring_buffer_t *ring, int size)
+{
+    ring->first = (ring->first + size) & (ring->buffer_size - 1);
+}
+
+
+int ring_reserve(ring_buffer_t *ring, ring_span_t spans[2])
+{
+    if (ring->first == ring->last) {
+        ring_clear(ring);
+    }
+
+    spans[0].data = &ring->buffer[ring->last];
+    spans[1].data = ring->buffer;
+
+    // \~japanese first の直前の要素は、空と満杯を区別するために使わない
+    // \~english The element just before first is kept unused to tell full from empty
+    if (ring->first <= ring->last) {
+        if (ring->first == 0) {
+            spans[0].size = ring->buffer_size - ring->last - 1;
+            spans[1].size = 0;
+        } else {
+            spans[0].size = ring->buffer_size - ring->last;
+            spans[1].size = ring->first - 1;
+        }
+    } else {
+        spans[0].size = ring->first - ring->last - 1;
+        spans[1].size = 0;
+    }
+    return spans[0].size + spans[1].size;
+}
+
+
+void ring_commit(ring_buffer_t *ring, int size)
+{
+    ring->last = (ring->last + size) & (ring->buffer_size - 1);
+}
+
+
+static void reverse(char *first, char *last)
+{
+    while (first < --last) {
+        char ch = *first;
+        *first++ = *last;
+        *last = ch;
+    }
+}
+
+
+char *ring_linearize(ring_buffer_t *ring)
+{
+    int size = ring_size(ring);
+
+    if (ring->first > ring->last) {
+        // \~japanese バッファ全体を first だけ回転させる
+        // \~english Rotates the whole buffer by first elements
+        char *buffer = ring->buffer;
+        reverse(buffer, buffer + ring->first);
+        reverse(buffer + ring->first, buffer + ring->buffer_size);
+        reverse(buffer, buffer + ring->buffer_size);
+
+        ring->first = 0;
+        ring->last = size;
+    }
+    return &ring->buffer[ring->first];
+}
+
+
+int ring_write(ring_buffer_t *ring, const char *data, int size)
+{
+    ring_span_t spans[2];
+    int free_size = ring_reserve(ring, spans);
+    int push_size = (size > free_size) ? free_size : size;
+    int move_size = (push_size > spans[0].size) ? spans[0].size : push_size;
+
+    // \~japanese データ配置
+    // \~english Stores the data
+    memcpy(spans[0].data, data, move_size);
+    if (push_size > move_size) {
+        // \~japanese 0 から first の前までを配置
+        // \~english Stores data before the first element
+        memcpy(spans[1].data, &data[move_size], push_size - move_size);
+    }
+    ring_commit(ring, push_size);
+
+    return push_size;
+}
+
+
+int ring_read(ring_buffer_t *ring, char *buffer, int size)
+{
+    // \~japanese データ取得
+    // \~english Reads data
+    ring_span_t spans[2];
+    int now_size = ring_peek(ring, spans);
+    int pop_size = (size > now_size) ? now_size : size;
+    int move_size = (pop_size > spans[0].size) ? spans[0].size : pop_size;
+
+    memcpy(buffer, spans[0].data, move_size);
+    if (pop_size > move_size) {
+        // \~japanese 0 から last の前までを取得
+        // \~english Gets data before the last element
+        memcpy(&buffer[move_size], spans[1].data, pop_size - move_size);
+    }
+    ring_consume(ring, pop_size);
+
+    return pop_size;
+}
+
+
+int ring_find_linefeed(const ring_buffer_t *ring, int size)
+{
+    ring_span_t spans[2];
+    int offset = 0;
+    int i;
+
+    ring_peek(ring, spans);
+    for (i = 0; (i < 2) && (offset < size); ++i) {
+        int n = (spans[i].size < size - offset) ? spans[i].size : size - offset;
+        const char *lf = memchr(spans[i].data, '\n', n);
+        const char *cr = memchr(spans[i].data, '\r',
+                                lf ? (int)(lf - spans[i].data) : n);
+
+        if (cr) {
+            return offset + (int)(cr - spans[i].data);
+        } else if (lf) {
+            return offset + (int)(lf - spans[i].data);
+        }
+        offset += n;
+    }
+    return -1;
+}
+
+
+int ring_readline(ring_buffer_t *ring, char *data, int max_size,
+                  ring_fill_function fill, void *context, int timeout)
+{
+    int filled = 0;
+
+    if (max_size <= 0) {
+        return -1;
+    }
+
+    while (1) {
+        int scan_size = ring_size(ring);
+        int pos;
+
+        if (scan_size > max_size - filled) {
+            scan_size = max_size - filled;
+        }
+
+        pos = ring_find_linefeed(ring, scan_size);
+        if (pos >= 0) {
+            // \~japanese 改行文字はバッファから取り除く
+            // \~english The EOL character is removed from the buffer
+            filled += ring_read(ring, &data[filled], pos);
+            ring_consume(ring, 1);
+            break;
+        }
+
+        if (filled + scan_size >= max_size) {
+            // \~japanese 改行が見つからないときは、最後の１文字をバッファに残す
+            // \~english If no EOL was found, the last character is left in the buffer
+            filled += ring_read(ring, &data[filled], max_size - 1 - filled);
+            break;
+        }
+
+        filled += ring_read(ring, &data[filled], scan_size);
+        if (fill(context, 1, timeout) <= 0) {
+            if (filled == 0) {
+                data[0] = '\0';
+                return -1;
+            }
+            break;
+        }
+    }
+    data[filled] = '\0';
+
+    return filled;
+}
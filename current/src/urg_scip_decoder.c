@@ -0,0 +1,446 @@
+/*!
+  \file
+  \~japanese
+  \brief SCIP 文字列の一括デコード
+  \~english
+  \brief Block decoding of SCIP strings
+  \~
+
+  $Id$
+*/
+
+#include "urg_scip_decoder.h"
+#include <stddef.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) ||                            \
+     ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define URG_DECODER_X86
+#define URG_DECODER_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+
+#elif defined(URG_MSC) && (_MSC_VER >= 1700) &&                         \
+    (defined(_M_X64) || defined(_M_IX86))
+#define URG_DECODER_X86
+#define URG_DECODER_TARGET(isa)
+#include <intrin.h>
+#include <immintrin.h>
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define URG_DECODER_NEON
+#include <arm_neon.h>
+#endif
+
+
+//! \~japanese 命令セットごとのデコード処理  \~english Decoder of an instruction set
+typedef struct
+{
+    const char *name;
+
+    // \~japanese 先頭から SIMD 命令で処理できるだけデコードし、デコードした個数を返す。sum にはデコードした文字のバイト和を格納する
+    // \~english Decodes as many values from the start as the SIMD path can, and returns how many were decoded. sum receives the byte sum of the decoded characters
+    int (*decode)(const char data[], int count, int width, uint32_t values[],
+                  uint32_t *sum);
+} decoder_t;
+
+
+// \~japanese 1 つずつデコードし、デコードした文字のバイト和を返す
+// \~english Decodes the values one by one and returns the byte sum of the decoded characters
+static uint32_t decode_scalar(const char data[], int count, int width,
+                              uint32_t values[])
+{
+    const unsigned char *p = (const unsigned char *)data;
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        uint32_t value = 0;
+        int j;
+        for (j = 0; j < width; ++j) {
+            sum += *p;
+            value = (value << 6) | ((*p++ - 0x30) & 0x3f);
+        }
+        values[i] = value;
+    }
+    return sum;
+}
+
+
+static int decode_none(const char data[], int count, int width,
+                       uint32_t values[], uint32_t *sum)
+{
+    (void)data;
+    (void)count;
+    (void)width;
+    (void)values;
+    *sum = 0;
+    return 0;
+}
+
+
+#if defined(URG_DECODER_X86)
+// \~japanese 2 つの 64 ビットの和を 32 ビットに畳み込む
+// \~english Folds the two 64 bit sums into 32 bits
+URG_DECODER_TARGET("sse2")
+static uint32_t fold_sum(__m128i total)
+{
+    return (uint32_t)(_mm_cvtsi128_si32(total) +
+                      _mm_cvtsi128_si32(_mm_srli_si128(total, 8)));
+}
+
+
+URG_DECODER_TARGET("sse2")
+static int decode_sse2(const char data[], int count, int width,
+                       uint32_t values[], uint32_t *sum)
+{
+    const __m128i offset = _mm_set1_epi8(0x30);
+    const __m128i mask = _mm_set1_epi8(0x3f);
+    const __m128i low_byte = _mm_set1_epi16(0x00ff);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    int i = 0;
+
+    // \~japanese 16 文字から 8 個の値をデコードする
+    // \~english Decodes 8 values from 16 characters
+    for (; (width == 2) && ((i + 8) <= count); i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&data[2 * i]);
+        __m128i words;
+
+        total = _mm_add_epi64(total, _mm_sad_epu8(v, zero));
+        v = _mm_and_si128(_mm_sub_epi8(v, offset), mask);
+        words = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, low_byte), 6),
+                             _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)&values[i],
+                         _mm_unpacklo_epi16(words, zero));
+        _mm_storeu_si128((__m128i *)&values[i + 4],
+                         _mm_unpackhi_epi16(words, zero));
+    }
+    *sum = fold_sum(total);
+    return i;
+}
+
+
+URG_DECODER_TARGET("ssse3")
+static int decode_ssse3(const char data[], int count, int width,
+                        uint32_t values[], uint32_t *sum)
+{
+    const __m128i offset = _mm_set1_epi8(0x30);
+    const __m128i mask = _mm_set1_epi8(0x3f);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    int i = 0;
+
+    if (width == 2) {
+        // \~japanese 2 文字を c0 * 64 + c1 の 16 ビット値にまとめる
+        // \~english Combines 2 characters into the 16 bit value c0 * 64 + c1
+        const __m128i weight = _mm_set1_epi16(0x0140);
+
+        for (; (i + 8) <= count; i += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&data[2 * i]);
+            __m128i words;
+
+            total = _mm_add_epi64(total, _mm_sad_epu8(v, zero));
+            v = _mm_and_si128(_mm_sub_epi8(v, offset), mask);
+            words = _mm_maddubs_epi16(v, weight);
+            _mm_storeu_si128((__m128i *)&values[i],
+                             _mm_unpacklo_epi16(words, zero));
+            _mm_storeu_si128((__m128i *)&values[i + 4],
+                             _mm_unpackhi_epi16(words, zero));
+        }
+
+    } else if (width == 3) {
+        // \~japanese 3 文字を 32 ビットの [c1, c0, c2, 0] に並べ替え、(c0 * 64 + c1) * 64 + c2 を求める
+        // \~english Arranges 3 characters as [c1, c0, c2, 0] in 32 bits and computes (c0 * 64 + c1) * 64 + c2
+        const __m128i order = _mm_setr_epi8(1, 0, 2, -128, 4, 3, 5, -128,
+                                            7, 6, 8, -128, 10, 9, 11, -128);
+        const __m128i used = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                           -1, -1, -1, -1, 0, 0, 0, 0);
+        const __m128i byte_weight = _mm_set1_epi32(0x00014001);
+        const __m128i word_weight = _mm_set1_epi32(0x00010040);
+
+        // \~japanese 16 バイトを読むため、12 文字の後に 4 文字以上が残っていること
+        // \~english 16 bytes are loaded, so at least 4 characters must follow the 12 used
+        for (; (i + 6) <= count; i += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&data[3 * i]);
+
+            total = _mm_add_epi64(total,
+                                  _mm_sad_epu8(_mm_and_si128(v, used), zero));
+            v = _mm_and_si128(_mm_sub_epi8(v, offset), mask);
+            v = _mm_shuffle_epi8(v, order);
+            v = _mm_madd_epi16(_mm_maddubs_epi16(v, byte_weight), word_weight);
+            _mm_storeu_si128((__m128i *)&values[i], v);
+        }
+    }
+    *sum = fold_sum(total);
+    return i;
+}
+
+
+URG_DECODER_TARGET("avx2")
+static int decode_avx2(const char data[], int count, int width,
+                       uint32_t values[], uint32_t *sum)
+{
+    const __m256i offset = _mm256_set1_epi8(0x30);
+    const __m256i mask = _mm256_set1_epi8(0x3f);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+    uint32_t rest_sum;
+    int i = 0;
+
+    if (width == 2) {
+        const __m256i weight = _mm256_set1_epi16(0x0140);
+
+        for (; (i + 16) <= count; i += 16) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)&data[2 * i]);
+            __m256i words;
+
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(v, zero));
+            v = _mm256_and_si256(_mm256_sub_epi8(v, offset), mask);
+            words = _mm256_maddubs_epi16(v, weight);
+            _mm256_storeu_si256((__m256i *)&values[i],
+                                _mm256_cvtepu16_epi32(
+                                    _mm256_castsi256_si128(words)));
+            _mm256_storeu_si256((__m256i *)&values[i + 8],
+                                _mm256_cvtepu16_epi32(
+                                    _mm256_extracti128_si256(words, 1)));
+        }
+
+    } else if (width == 3) {
+        const __m256i order =
+            _mm256_setr_epi8(1, 0, 2, -128, 4, 3, 5, -128,
+                             7, 6, 8, -128, 10, 9, 11, -128,
+                             1, 0, 2, -128, 4, 3, 5, -128,
+                             7, 6, 8, -128, 10, 9, 11, -128);
+        const __m256i used =
+            _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                             -1, -1, -1, -1, 0, 0, 0, 0,
+                             -1, -1, -1, -1, -1, -1, -1, -1,
+                             -1, -1, -1, -1, 0, 0, 0, 0);
+        const __m256i byte_weight = _mm256_set1_epi32(0x00014001);
+        const __m256i word_weight = _mm256_set1_epi32(0x00010040);
+
+        // \~japanese 12 文字ずつを 128 ビットの各レーンに読み込む
+        // \~english Loads 12 characters into each 128 bit lane
+        for (; (i + 10) <= count; i += 8) {
+            const char *p = &data[3 * i];
+            __m256i v = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+                _mm_loadu_si128((const __m128i *)(p + 12)), 1);
+
+            total = _mm256_add_epi64(
+                total, _mm256_sad_epu8(_mm256_and_si256(v, used), zero));
+            v = _mm256_and_si256(_mm256_sub_epi8(v, offset), mask);
+            v = _mm256_shuffle_epi8(v, order);
+            v = _mm256_madd_epi16(_mm256_maddubs_epi16(v, byte_weight),
+                                  word_weight);
+            _mm256_storeu_si256((__m256i *)&values[i], v);
+        }
+    }
+    *sum = fold_sum(_mm_add_epi64(_mm256_castsi256_si128(total),
+                                  _mm256_extracti128_si256(total, 1)));
+
+    // \~japanese 残りは SSSE3 で処理する。SSE 命令との切り替えの遅延を避けるため、YMM レジスタの上位をクリアしておく
+    // \~english The rest is processed with SSSE3. The upper halves of the YMM registers are cleared to avoid the SSE transition penalty
+    _mm256_zeroupper();
+    i += decode_ssse3(&data[width * i], count - i, width, &values[i],
+                      &rest_sum);
+    *sum += rest_sum;
+    return i;
+}
+
+
+enum {
+    ISA_SSE2,
+    ISA_SSSE3,
+    ISA_AVX2,
+};
+
+
+// \~japanese CPU が命令セットに対応しているかを返す
+// \~english Returns whether the CPU supports the instruction set
+static int cpu_supports(int isa)
+{
+#if defined(URG_MSC)
+    int info[4];
+    int os_ymm;
+
+    __cpuid(info, 1);
+    switch (isa) {
+    case ISA_SSE2:
+        return (info[3] >> 26) & 1;
+
+    case ISA_SSSE3:
+        return (info[2] >> 9) & 1;
+
+    case ISA_AVX2:
+        // \~japanese AVX2 は OS が YMM レジスタを保存するときのみ使える
+        // \~english AVX2 is usable only if the OS saves the YMM registers
+        os_ymm = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) &&
+            ((_xgetbv(0) & 6) == 6);
+        __cpuidex(info, 7, 0);
+        return os_ymm && ((info[1] >> 5) & 1);
+    }
+    return 0;
+#else
+    __builtin_cpu_init();
+    switch (isa) {
+    case ISA_SSE2:
+        return __builtin_cpu_supports("sse2");
+
+    case ISA_SSSE3:
+        return __builtin_cpu_supports("ssse3");
+
+    case ISA_AVX2:
+        return __builtin_cpu_supports("avx2");
+    }
+    return 0;
+#endif
+}
+#endif
+
+
+#if defined(URG_DECODER_NEON)
+static int decode_neon(const char data[], int count, int width,
+                       uint32_t values[], uint32_t *sum)
+{
+    const uint8x16_t offset = vdupq_n_u8(0x30);
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    const uint8_t *p = (const uint8_t *)data;
+    uint32x4_t total = vdupq_n_u32(0);
+    int i = 0;
+
+    if (width == 2) {
+        // \~japanese 32 文字を c0, c1 の列に分けて 16 個の値をデコードする
+        // \~english Splits 32 characters into the c0 and c1 columns and decodes 16 values
+        for (; (i + 16) <= count; i += 16) {
+            uint8x16x2_t v = vld2q_u8(&p[2 * i]);
+            uint8x16_t c0 = vandq_u8(vsubq_u8(v.val[0], offset), mask);
+            uint8x16_t c1 = vandq_u8(vsubq_u8(v.val[1], offset), mask);
+            uint16x8_t low = vaddw_u8(vshll_n_u8(vget_low_u8(c0), 6),
+                                      vget_low_u8(c1));
+            uint16x8_t high = vaddw_u8(vshll_n_u8(vget_high_u8(c0), 6),
+                                       vget_high_u8(c1));
+
+            total = vpadalq_u16(total, vpadalq_u8(vpaddlq_u8(v.val[0]),
+                                                  v.val[1]));
+            vst1q_u32(&values[i], vmovl_u16(vget_low_u16(low)));
+            vst1q_u32(&values[i + 4], vmovl_u16(vget_high_u16(low)));
+            vst1q_u32(&values[i + 8], vmovl_u16(vget_low_u16(high)));
+            vst1q_u32(&values[i + 12], vmovl_u16(vget_high_u16(high)));
+        }
+
+    } else if (width == 3) {
+        // \~japanese 48 文字を c0, c1, c2 の列に分けて 16 個の値をデコードする
+        // \~english Splits 48 characters into the c0, c1 and c2 columns and decodes 16 values
+        for (; (i + 16) <= count; i += 16) {
+            uint8x16x3_t v = vld3q_u8(&p[3 * i]);
+            uint8x16_t c0 = vandq_u8(vsubq_u8(v.val[0], offset), mask);
+            uint8x16_t c1 = vandq_u8(vsubq_u8(v.val[1], offset), mask);
+            uint8x16_t c2 = vandq_u8(vsubq_u8(v.val[2], offset), mask);
+            uint16x8_t low = vaddw_u8(vshll_n_u8(vget_low_u8(c0), 6),
+                                      vget_low_u8(c1));
+            uint16x8_t high = vaddw_u8(vshll_n_u8(vget_high_u8(c0), 6),
+                                       vget_high_u8(c1));
+            uint16x8_t low_c2 = vmovl_u8(vget_low_u8(c2));
+            uint16x8_t high_c2 = vmovl_u8(vget_high_u8(c2));
+
+            total = vpadalq_u16(total,
+                                vpadalq_u8(vpadalq_u8(vpaddlq_u8(v.val[0]),
+                                                      v.val[1]), v.val[2]));
+            vst1q_u32(&values[i],
+                      vaddw_u16(vshll_n_u16(vget_low_u16(low), 6),
+                                vget_low_u16(low_c2)));
+            vst1q_u32(&values[i + 4],
+                      vaddw_u16(vshll_n_u16(vget_high_u16(low), 6),
+                                vget_high_u16(low_c2)));
+            vst1q_u32(&values[i + 8],
+                      vaddw_u16(vshll_n_u16(vget_low_u16(high), 6),
+                                vget_low_u16(high_c2)));
+            vst1q_u32(&values[i + 12],
+                      vaddw_u16(vshll_n_u16(vget_high_u16(high), 6),
+                                vget_high_u16(high_c2)));
+        }
+    }
+    *sum = vgetq_lane_u32(total, 0) + vgetq_lane_u32(total, 1) +
+        vgetq_lane_u32(total, 2) + vgetq_lane_u32(total, 3);
+    return i;
+}
+#endif
+
+
+static const decoder_t *select_decoder(void)
+{
+#if defined(URG_DECODER_X86)
+    static const decoder_t avx2 = { "avx2", decode_avx2 };
+    static const decoder_t ssse3 = { "ssse3", decode_ssse3 };
+    static const decoder_t sse2 = { "sse2", decode_sse2 };
+#elif defined(URG_DECODER_NEON)
+    static const decoder_t neon = { "neon", decode_neon };
+#endif
+    static const decoder_t scalar = { "scalar", decode_none };
+
+#if defined(URG_DECODER_X86)
+    if (cpu_supports(ISA_AVX2)) {
+        return &avx2;
+    } else if (cpu_supports(ISA_SSSE3)) {
+        return &ssse3;
+    } else if (cpu_supports(ISA_SSE2)) {
+        return &sse2;
+    }
+#elif defined(URG_DECODER_NEON)
+    return &neon;
+#endif
+    return &scalar;
+}
+
+
+static const decoder_t *selected_decoder = NULL;
+
+
+void urg_scip_decoder_initialize(void)
+{
+    if (!selected_decoder) {
+        selected_decoder = select_decoder();
+    }
+}
+
+
+// \~japanese 使用するデコード処理を返す。選択されていなければ、ここで選択する
+// \~english Returns the decoder to use, selected here if not selected yet
+static const decoder_t *decoder(void)
+{
+    urg_scip_decoder_initialize();
+    return selected_decoder;
+}
+
+
+int urg_scip_decode_block(const char data[], int count, int width,
+                          uint32_t values[])
+{
+    uint32_t sum = 0;
+    return urg_scip_decode_block_sum(data, count, width, values, &sum);
+}
+
+
+int urg_scip_decode_block_sum(const char data[], int count, int width,
+                              uint32_t values[], uint32_t *sum)
+{
+    uint32_t block_sum;
+    int n;
+
+    if ((count < 0) || (width < 1) || (width > 4)) {
+        return -1;
+    }
+
+    n = decoder()->decode(data, count, width, values, &block_sum);
+    block_sum += decode_scalar(&data[width * n], count - n, width, &values[n]);
+    *sum += block_sum;
+
+    return count;
+}
+
+
+const char *urg_scip_decoder_name(void)
+{
+    return decoder()->name;
+}
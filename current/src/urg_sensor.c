@@ -18,6 +18,7 @@
 #include "urg_sensor.h"
 #include "urg_errno.h"
 #include "urg_utils.h"
+#include "urg_scip_decoder.h"
 #include <stddef.h>
 #include <string.h>
 #include <stdio.h>
@@ -27,6 +28,14 @@
 #define snprintf _snprintf
 #endif
 
+#if defined(URG_MSC)
+#define URG_FORCE_INLINE __forceinline
+#elif defined(__GNUC__)
+#define URG_FORCE_INLINE __inline__ __attribute__((always_inline))
+#else
+#define URG_FORCE_INLINE
+#endif
+
 
 enum {
     URG_FALSE = 0,
@@ -44,6 +53,7 @@ enum {
     II_RESPONSE_LINES = 9,
 
     MAX_TIMEOUT = 140,
+    COMMAND_RESPONSE_SCANS = 8,
 };
 
 
@@ -67,6 +77,27 @@ static char scip_checksum(const char buffer[], int size)
 }
 
 
+// \~japanese [p, last_p) のバイト和を返す
+// \~english Returns the byte sum of [p, last_p)
+static uint32_t byte_sum(const char *p, const char *last_p)
+{
+    uint32_t sum = 0;
+
+    while (p < last_p) {
+        sum += (unsigned char)*p++;
+    }
+    return sum;
+}
+
+
+// \~japanese バイト和からチェックサムを求める
+// \~english Calculates the checksum from the byte sum
+static char sum_checksum(uint32_t sum)
+{
+    return (char)((sum & 0x3f) + 0x30);
+}
+
+
 static int set_errno_and_return(urg_t *urg, int urg_errno)
 {
     urg->last_errno = urg_errno;
@@ -200,6 +231,120 @@ static void ignore_receive_data_with_qt(urg_t *urg, int timeout)
 }
 
 
+// \~japanese 残りの計測回数を更新する
+// \~english Updates the remaining number of scans
+static void update_remain_times(urg_t *urg)
+{
+    // \~japanese specified_scan_times == 1 �̂Ƃ��� Gx �n�R�}���h���g���邽��
+    // \~japanese �f�[�^�𖾎��I�ɒ�~���Ȃ��Ă悢
+    // \~english If specified_scan_times == 1 then we are using a Gx type command
+    // \~english it is not necessary to explicity stop measurement
+    if ((urg->specified_scan_times > 1) && (urg->scanning_remain_times > 0)) {
+        if (--urg->scanning_remain_times <= 0) {
+            // \~japanese �f�[�^�̒�~�݂̂��s��
+	    // \~english Stops measurement
+            urg_stop_measurement(urg);
+        }
+    }
+}
+
+
+// \~japanese 連続計測中の受信エラーを再同期するか
+// \~english Whether receive errors during the continuous measurement are resynchronised
+static int is_resync_enabled(const urg_t *urg)
+{
+    return urg->is_resync_mode && urg->is_sending &&
+        (urg->specified_scan_times != 1);
+}
+
+
+// \~japanese 受信中の応答を破棄してエラーを返す。n は最後に受信した行の長さ
+// \~japanese 再同期するときは計測を止めずに、応答の終端の空行まで読み捨てる
+// \~english Discards the response being received and returns the error. n is the length of the last received line
+// \~english When resynchronising, skips up to the empty line that ends the response without stopping the measurement
+static int drop_lines_and_return(urg_t *urg, int n, int urg_errno)
+{
+    char buffer[BUFFER_SIZE];
+
+    if (!is_resync_enabled(urg)) {
+        ignore_receive_data_with_qt(urg, urg->timeout);
+        return set_errno_and_return(urg, urg_errno);
+    }
+
+    while (n > 0) {
+        n = connection_readline(&urg->connection,
+                                buffer, BUFFER_SIZE, urg->timeout);
+    }
+    ++urg->dropped_frame_count;
+    update_remain_times(urg);
+    return set_errno_and_return(urg, urg_errno);
+}
+
+
+// \~japanese echoback の応答の終端 (空行) まで、受信データを読み捨てる
+// \~japanese 応答の前に受信した計測データなども読み捨て、タイムアウトを待たずに戻る
+// \~english Skips the received data up to the end (empty line) of the response to echoback
+// \~english Data received before the response, such as measurement data, is skipped as well, without waiting for the timeout
+static int skip_to_response_end(urg_t *urg, const char *echoback, int timeout)
+{
+    enum { MAX_SKIP_LINES = 4096 };
+    char buffer[BUFFER_SIZE];
+    int is_echoback_found = URG_FALSE;
+    int i;
+
+    for (i = 0; i < MAX_SKIP_LINES; ++i) {
+        int n = connection_readline(&urg->connection,
+                                    buffer, BUFFER_SIZE, timeout);
+        if (n < 0) {
+            return URG_NO_RESPONSE;
+        } else if (is_echoback_found) {
+            if (n == 0) {
+                return URG_NO_ERROR;
+            }
+        } else if (!strcmp(buffer, echoback)) {
+            is_echoback_found = URG_TRUE;
+        }
+    }
+    return URG_INVALID_RESPONSE;
+}
+
+
+// \~japanese ボーレートを変更したセンサが応答するまで、QT を待ち時間を倍にしながら送信する
+// \~japanese 応答までの時間を baudrate_settle_msec に記録する
+// \~english Sends QT with a doubling wait until the sensor answers at the changed baudrate
+// \~english The time until the answer is recorded in baudrate_settle_msec
+static int wait_baudrate_settled(urg_t *urg)
+{
+    enum {
+        FIRST_WAIT_MSEC = 8,
+        MAX_WAIT_MSEC = 128,
+        SETTLE_TIMEOUT_MSEC = 1000,
+        PING_SIZE = 16,
+    };
+    char ping[PING_SIZE];
+    long first_ticks = connection_ticks();
+    int wait_msec = FIRST_WAIT_MSEC;
+    int i;
+
+    for (i = 0; (connection_ticks() - first_ticks) < SETTLE_TIMEOUT_MSEC; ++i) {
+        // \~japanese 前の QT への遅れた応答と区別するため、QT ごとに異なる文字列を付ける
+        // \~english Each QT carries its own string, so that late answers to the previous ones are told apart
+        int n = snprintf(ping, PING_SIZE, "QT;%d\n", i);
+        connection_write(&urg->connection, ping, n);
+        ping[n - 1] = '\0';
+
+        if (skip_to_response_end(urg, ping, wait_msec) == URG_NO_ERROR) {
+            urg->baudrate_settle_msec = connection_ticks() - first_ticks;
+            return URG_NO_ERROR;
+        }
+        if (wait_msec < MAX_WAIT_MSEC) {
+            wait_msec *= 2;
+        }
+    }
+    return URG_NO_RESPONSE;
+}
+
+
 static int change_sensor_baudrate(urg_t *urg,
                                   long current_baudrate, long next_baudrate)
 {
@@ -231,12 +376,13 @@ static int change_sensor_baudrate(urg_t *urg,
     // \~japanese ���퉞���Ȃ�΁A�z�X�g���̃{�[���[�g��ύX����
     // \~english If the result is correct, change the host's baudrate
     ret = connection_set_baudrate(&urg->connection, next_baudrate);
+    if (ret < 0) {
+        return set_errno_and_return(urg, ret);
+    }
 
-    ignore_receive_data(urg, MAX_TIMEOUT);
-
-    // \~japanese �Z���T���̐ݒ蔽�f��҂��߂ɏ��������ҋ@����
-    // \~english Waits a bit for the sensor to change baudrate
-    urg_delay(150);
+    // \~japanese センサ側の設定反映を、新しいボーレートでの応答で確認する
+    // \~english Waits for the sensor to change baudrate, until it answers at the new rate
+    ret = wait_baudrate_settled(urg);
 
     return set_errno_and_return(urg, ret);
 }
@@ -342,6 +488,38 @@ static int connect_urg_device(urg_t *urg, long baudrate)
 }
 
 
+// \~japanese ボーレートを探索せずに、現在の通信設定のままセンサに接続する
+// \~japanese RS, QT の応答の終端は内容で判定し、受信のタイムアウトを待たない
+// \~english Connects to the sensor with the current link settings, without probing the baudrate
+// \~english The end of the RS and QT responses is found by their content, without waiting for a receive timeout
+static int connect_urg_directly(urg_t *urg)
+{
+    enum { RECEIVE_BUFFER_SIZE = 4 };
+    int qt_expected[] = { 0, EXPECTED_END };
+    char receive_buffer[RECEIVE_BUFFER_SIZE + 1];
+    int ret;
+
+    // \~japanese RS で計測を止め、送信中だったデータは RS の応答までを読み捨てる
+    // \~english Stops the measurement with RS, and skips the data sent before the RS response
+    if (connection_write(&urg->connection, "RS\n", 3) != 3) {
+        return URG_SEND_ERROR;
+    }
+    ret = skip_to_response_end(urg, "RS", MAX_TIMEOUT);
+    if (ret != URG_NO_ERROR) {
+        return ret;
+    }
+
+    // \~japanese QT の応答で SCIP 2.0 の通常の状態であることを確認する
+    // \~english Checks with the QT response that the sensor is in the normal SCIP 2.0 state
+    ret = scip_response(urg, "QT\n", qt_expected, MAX_TIMEOUT,
+                        receive_buffer, RECEIVE_BUFFER_SIZE);
+    if ((ret <= 0) || strcmp(receive_buffer, "00P")) {
+        return URG_INVALID_RESPONSE;
+    }
+    return URG_NO_ERROR;
+}
+
+
 // \~japanese PP �R�}���h�̉����� urg_t �Ɋi�[����
 // \~english Stores the PP command response into urg_t
 static int receive_parameter(urg_t *urg)
@@ -415,6 +593,77 @@ static int receive_parameter(urg_t *urg)
 }
 
 
+// \~japanese VV の応答からシリアル番号を取得する
+// \~english Gets the serial id from the VV response
+static int receive_serial_id(urg_t *urg, char serial_id[], int max_size)
+{
+    enum { RECEIVE_BUFFER_SIZE = BUFFER_SIZE * VV_RESPONSE_LINES, };
+    char receive_buffer[RECEIVE_BUFFER_SIZE];
+    int vv_expected[] = { 0, EXPECTED_END };
+    char *p;
+    int i;
+
+    int ret = scip_response(urg, "VV\n", vv_expected, MAX_TIMEOUT,
+                            receive_buffer, RECEIVE_BUFFER_SIZE);
+    if (ret < 0) {
+        return ret;
+    }
+
+    p = receive_buffer;
+    for (i = 0; i < (ret - 1); ++i) {
+        if (!strncmp(p, "SERI:", 5)) {
+            const char *last_p = strchr(p + 5, ';');
+            int n = last_p ? (int)(last_p - (p + 5)) : -1;
+            if ((n < 0) || (n >= max_size)) {
+                break;
+            }
+            memcpy(serial_id, p + 5, n);
+            serial_id[n] = '\0';
+            return set_errno_and_return(urg, URG_NO_ERROR);
+        }
+        p += strlen(p) + 1;
+    }
+    return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+}
+
+
+// \~japanese 記録した PP のパラメータを urg_t に格納する
+// \~english Stores the recorded PP parameters into urg_t
+static void load_cached_parameter(urg_t *urg, const urg_cache_entry_t *entry)
+{
+    urg->min_distance = entry->min_distance;
+    urg->max_distance = entry->max_distance;
+    urg->area_resolution = entry->area_resolution;
+    urg->first_data_index = entry->first_data_index;
+    urg->last_data_index = entry->last_data_index;
+    urg->front_data_index = entry->front_data_index;
+    urg->scan_usec = entry->scan_usec;
+
+    // \~japanese タイムアウト時間は receive_parameter() と同じく計測周期の 16 倍程度にする
+    // \~english Timeout is set about 16 times the scan period, as in receive_parameter()
+    urg->timeout = urg->scan_usec >> (10 - 4);
+
+    urg_set_scanning_parameter(urg,
+                               urg->first_data_index - urg->front_data_index,
+                               urg->last_data_index - urg->front_data_index,
+                               1);
+}
+
+
+// \~japanese urg_t の PP のパラメータを記録する
+// \~english Records the PP parameters of urg_t
+static void store_cached_parameter(const urg_t *urg, urg_cache_entry_t *entry)
+{
+    entry->min_distance = urg->min_distance;
+    entry->max_distance = urg->max_distance;
+    entry->area_resolution = urg->area_resolution;
+    entry->first_data_index = urg->first_data_index;
+    entry->last_data_index = urg->last_data_index;
+    entry->front_data_index = urg->front_data_index;
+    entry->scan_usec = urg->scan_usec;
+}
+
+
 //! \~japanese SCIP ������̃f�R�[�h  \~english  Decodes the SCIP message
 long urg_scip_decode(const char data[], int size)
 {
@@ -501,238 +750,1083 @@ static urg_measurement_type_t parse_distance_echoback(urg_t *urg,
 }
 
 
-static int receive_length_data(urg_t *urg, long length[],
-                               unsigned short intensity[],
-                               urg_measurement_type_t type, char buffer[])
+//! \~japanese 距離データの格納先の型  \~english Type of the distance data destination
+typedef enum {
+    LENGTH_LONG,                //!< long
+    LENGTH_UINT32,              //!< uint32_t
+    LENGTH_UINT16,              //!< \~japanese uint16_t (65535 で飽和)  \~english uint16_t (saturated at 65535)
+    LENGTH_PLANES,              //!< urg_multiecho_planes_t
+} length_type_t;
+
+
+enum {
+    PENDING_STEPS = 64,         //!< \~japanese 格納を保留できる step 数。1 行分より多い  \~english Number of steps that can be held back, more than one line
+};
+
+
+//! \~japanese 距離データのデコード状態  \~english Decoding state of the distance data
+typedef struct length_decoder
 {
-    int n;
-    int step_filled = 0;
-    int line_filled = 0;
-    int multiecho_index = 0;
+    void *length;
+    length_type_t length_type;
+    unsigned short *intensity;
+    int data_size;
+    int is_multiecho;
+    int step_filled;
+    int multiecho_index;
+
+    // \~japanese デコードする範囲と、step_filled を含む領域内外の区間の状態
+    // \~english Ranges to decode, and the run inside or outside of them that contains step_filled
+    const urg_step_region_t *regions;
+    int region_count;
+    int region_offset;
+    int region_skip;
+    int run_first;
+    int run_last;
+    int is_run_inside;
+
+    // \~japanese 有効ビットの格納先と、有効とする距離の最小値
+    // \~english Destination of the validity bits, and the minimum valid distance
+    uint32_t *mask;
+    int mask_size;
+    uint32_t min_distance;
+
+    // \~japanese 計測データの種類と文字数に応じたデコード関数
+    // \~english Decoding function for the measurement type and the number of characters
+    const char *(*decode)(urg_t *urg, struct length_decoder *decoder,
+                          const char *p, const char *last_p, uint32_t *sum);
+
+    // \~japanese チェックサムを評価するまで格納を保留している、シングルエコーの pending_first からの値
+    // \~english Single echo values from pending_first, held back until the checksum is validated
+    uint32_t pending[2 * PENDING_STEPS];
+    int pending_first;
+    int pending_stride;
+} length_decoder_t;
+
+
+// \~japanese 負の数も切り捨てる割り算
+// \~english Division rounding negative numbers down as well
+static int floor_div(int value, int divisor)
+{
+    return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
 
-    int each_size =
-        (urg->received_range_data_byte == URG_COMMUNICATION_2_BYTE) ? 2 : 3;
-    int data_size = each_size;
-    int is_intensity = URG_FALSE;
-    int is_multiecho = URG_FALSE;
-    int multiecho_max_size = 1;
 
-    if ((type == URG_DISTANCE_INTENSITY) || (type == URG_MULTIECHO_INTENSITY)) {
-        data_size *= 2;
-        is_intensity = URG_TRUE;
+// \~japanese index からデコードする範囲の内外が同じまま続く step 数を返す
+// \~japanese 範囲内かどうかは decoder->is_run_inside に格納する
+// \~english Returns the number of steps from index that stay inside or outside the ranges to decode
+// \~english Whether they are inside is stored in decoder->is_run_inside
+static int region_run_size(length_decoder_t *decoder, int index)
+{
+    enum { NO_REGION_INDEX = 1 << 30 };
+    int i;
+
+    if ((index >= decoder->run_first) && (index <= decoder->run_last)) {
+        return decoder->run_last - index + 1;
+    }
+
+    // \~japanese index を含む範囲を、重なる範囲をつなげながら延ばす
+    // \~english Extends the range containing index, joining the overlapping ranges
+    decoder->run_first = index;
+    decoder->run_last = index - 1;
+    for (i = 0; i < decoder->region_count; ++i) {
+        const urg_step_region_t *region = &decoder->regions[i];
+        int first = floor_div(region->first_step - decoder->region_offset,
+                              decoder->region_skip);
+        int last = floor_div(region->last_step - decoder->region_offset,
+                             decoder->region_skip);
+        if ((first <= decoder->run_last + 1) && (last > decoder->run_last)) {
+            decoder->run_last = last;
+            i = -1;
+        }
     }
-    if ((type == URG_MULTIECHO) || (type == URG_MULTIECHO_INTENSITY)) {
-        is_multiecho = URG_TRUE;
-        multiecho_max_size = URG_MAX_ECHO;
+    decoder->is_run_inside = (decoder->run_last >= index) ? 1 : 0;
+
+    if (!decoder->is_run_inside) {
+        // \~japanese 次の範囲の手前までが範囲外になる
+        // \~english The steps up to the next range are outside
+        decoder->run_last = NO_REGION_INDEX;
+        for (i = 0; i < decoder->region_count; ++i) {
+            int first = floor_div(decoder->regions[i].first_step
+                                  - decoder->region_offset,
+                                  decoder->region_skip);
+            if ((first > index) && (first - 1 < decoder->run_last)) {
+                decoder->run_last = first - 1;
+            }
+        }
     }
+    return decoder->run_last - index + 1;
+}
 
-    do {
-        char *p = buffer;
-        char *last_p;
 
-        n = connection_readline(&urg->connection,
-                                &buffer[line_filled], BUFFER_SIZE - line_filled,
-                                urg->timeout);
+// \~japanese index の step をデコードするかを返す
+// \~english Returns whether the step at index is decoded
+static int is_region_step(length_decoder_t *decoder, int index)
+{
+    if (!decoder->regions) {
+        return 1;
+    }
+    region_run_size(decoder, index);
+    return decoder->is_run_inside;
+}
 
-        if (n > 0) {
-            // \~japanese �`�F�b�N�T���̕]��
-	    // \~english Validates the checksum
-            if (buffer[line_filled + n - 1] !=
-                scip_checksum(&buffer[line_filled], n - 1)) {
-                ignore_receive_data_with_qt(urg, urg->timeout);
-                return set_errno_and_return(urg, URG_CHECKSUM_ERROR);
+
+// \~japanese index から n 個の距離データを格納先の型で格納する。values は stride 個おきに読む
+// \~english Stores n distances from index in the destination type, reading every stride-th value
+static void store_length_block(length_decoder_t *decoder, int index,
+                               const uint32_t values[], int n, int stride)
+{
+    int i;
+
+    switch (decoder->length_type) {
+    case LENGTH_UINT32:
+        {
+            uint32_t *length = (uint32_t *)decoder->length + index;
+            for (i = 0; i < n; ++i) {
+                length[i] = values[i * stride];
             }
         }
+        break;
 
-        if (n > 0) {
-            line_filled += n - 1;
+    case LENGTH_UINT16:
+        {
+            uint16_t *length = (uint16_t *)decoder->length + index;
+            for (i = 0; i < n; ++i) {
+                uint32_t value = values[i * stride];
+                length[i] = (uint16_t)((value > 0xffff) ? 0xffff : value);
+            }
         }
-        last_p = p + line_filled;
-
-        while ((last_p - p) >= data_size) {
-            int index;
+        break;
 
-            if (*p == '&') {
-                // \~japanese �擪������ '&' �������Ƃ��́A�}���`�G�R�[�̃f�[�^�Ƃ݂Ȃ�
-                // \~english If the start character is a '&' then assume data is multiecho
-                if ((last_p - (p + 1)) < data_size) {
-                    // \~japanese '&' �������āAdata_size ���f�[�^��������Δ�����
-		    // \~english Skips the '&' and if the string size is less than data_size ignore it
-                    break;
-                }
+    default:
+        {
+            long *length = (long *)decoder->length + index;
+            for (i = 0; i < n; ++i) {
+                length[i] = (long)values[i * stride];
+            }
+        }
+        break;
+    }
+}
 
-                --step_filled;
-                ++multiecho_index;
-                ++p;
-                --line_filled;
 
-            } else {
-                // \~japanese ���̃f�[�^
-	        // \~english Next data
-                multiecho_index = 0;
-            }
+// \~japanese index から n 個の距離データの有効ビットを格納する。values は stride 個おきに読む
+// \~english Stores the validity bits of n distances from index, reading every stride-th value
+static void store_validity_block(length_decoder_t *decoder, int index,
+                                 const uint32_t values[], int n, int stride)
+{
+    uint32_t *mask = decoder->mask;
+    uint32_t min_distance = decoder->min_distance;
+    int i;
 
-            index = (step_filled * multiecho_max_size) + multiecho_index;
+    if (index + n > decoder->mask_size) {
+        n = decoder->mask_size - index;
+    }
+    for (i = 0; i < n; ++i) {
+        // \~japanese 比較結果の 0, 1 をそのままビットにする
+        // \~english The 0 or 1 of the comparison is used as the bit
+        int bit = index + i;
+        mask[bit >> 5] |=
+            (uint32_t)(values[i * stride] >= min_distance) << (bit & 31);
+    }
+}
 
-            if (step_filled >
-                (urg->received_last_index - urg->received_first_index)) {
-                // \~japanese �f�[�^�����߂���ꍇ�́A�c��̃f�[�^�𖳎����Ė߂�
-	        // \~english If there is extra data, ignore it
-                ignore_receive_data_with_qt(urg, urg->timeout);
-                return set_errno_and_return(urg, URG_RECEIVE_ERROR);
-            }
 
+// \~japanese index の位置に距離データを 1 つ格納する
+// \~english Stores one distance at index
+static void store_length(length_decoder_t *decoder, int index, uint32_t value)
+{
+    store_length_block(decoder, index, &value, 1, 1);
+}
 
-            if (is_multiecho && (multiecho_index == 0)) {
-                // \~japanese �}���`�G�R�[�̃f�[�^�i�[����_�~�[�f�[�^�Ŗ��߂�
-	        // \~english Stores dummy values in the multiecho data location
-                int i;
-                if (length) {
-                    for (i = 1; i < multiecho_max_size; ++i) {
-                        length[index + i] = 0;
-                    }
-                }
-                if (intensity) {
-                    for (i = 1; i < multiecho_max_size; ++i) {
-                        intensity[index + i] = 0;
-                    }
-                }
-            }
 
-            // \~japanese �����f�[�^�̊i�[
-            // \~english Stores the distance data
-            if (length) {
-                length[index] = urg_scip_decode(p, 3);
+// \~japanese シングルエコーの [p, last_p) のデータを一括デコードし、デコードしきれなかったデータの先頭を返す
+// \~japanese 値は pending に置くだけで、チェックサムの評価後に store_pending_data() で格納する
+// \~japanese sum が NULL でなければ、デコードした文字のバイト和を sum に加える。データが多過ぎるときは NULL を返す
+// \~english Decodes the single echo data in [p, last_p) in blocks and returns the start of the undecoded rest
+// \~english The values are only put in pending, and are stored by store_pending_data() once the checksum is validated
+// \~english Adds the byte sum of the decoded characters to sum unless it is NULL. Returns NULL if there is extra data
+static URG_FORCE_INLINE
+const char *decode_single_echo_data(urg_t *urg, length_decoder_t *decoder,
+                                    const char *p, const char *last_p,
+                                    uint32_t *sum,
+                                    int each_size, int is_intensity)
+{
+    int values_per_step = is_intensity ? 2 : 1;
+    int data_size = each_size * values_per_step;
+    int steps = (int)(last_p - p) / data_size;
+    int max_steps = urg->received_last_index - urg->received_first_index + 1;
+
+    if ((decoder->step_filled + steps > max_steps) ||
+        (decoder->step_filled + steps - decoder->pending_first
+         > PENDING_STEPS)) {
+        // \~japanese データが多過ぎる
+        // \~english There is extra data
+        return NULL;
+    }
+
+    while (steps > 0) {
+        int n = steps;
+        uint32_t *values = &decoder->pending[(decoder->step_filled
+                                              - decoder->pending_first)
+                                             * values_per_step];
+
+        if (decoder->regions) {
+            int run_size = region_run_size(decoder, decoder->step_filled);
+            if (n > run_size) {
+                n = run_size;
             }
-            p += 3;
-
-            // \~japanese ���x�f�[�^�̊i�[
-	    // \~english Stores the intensity data
-            if (is_intensity) {
-                if (intensity) {
-                    intensity[index] = (unsigned short)urg_scip_decode(p, 3);
+            if (!decoder->is_run_inside) {
+                // \~japanese 範囲外の step はデコードせず、チェックサム用の和だけを求める
+                // \~english Steps outside the ranges are not decoded, only summed for the checksum
+                if (sum) {
+                    *sum += byte_sum(p, p + n * data_size);
                 }
-                p += 3;
+                p += n * data_size;
+                decoder->step_filled += n;
+                steps -= n;
+                continue;
             }
-
-            ++step_filled;
-            line_filled -= data_size;
         }
 
-        // \~japanese ���ɏ������镶����ޔ�
-        // \~english Prepares the next line to process
-        memmove(buffer, p, line_filled);
-    } while (n > 0);
+        if (sum) {
+            urg_scip_decode_block_sum(p, n * values_per_step, each_size,
+                                      values, sum);
+        } else {
+            urg_scip_decode_block(p, n * values_per_step, each_size, values);
+        }
 
-    return step_filled;
+        p += n * data_size;
+        decoder->step_filled += n;
+        steps -= n;
+    }
+    return p;
 }
 
 
-//! \~japanese �����f�[�^�̎擾  \~english Gets measurement data
-static int receive_data(urg_t *urg, long data[], unsigned short intensity[],
-                        long *time_stamp)
+// \~japanese 格納を保留している値を格納する
+// \~english Stores the values held back
+static void store_pending_data(length_decoder_t *decoder)
 {
-    urg_measurement_type_t type;
-    char buffer[BUFFER_SIZE];
-    int ret = 0;
-    int n;
-    int extended_timeout = urg->timeout
-        + 2 * (urg->scan_usec * (urg->scanning_skip_scan) / 1000);
-
-    // \~japanese �G�R�[�o�b�N�̎擾
-    // \~english Gets the echoback
-    n = connection_readline(&urg->connection,
-                            buffer, BUFFER_SIZE, extended_timeout);
-    if (n <= 0) {
-        return set_errno_and_return(urg, URG_NO_RESPONSE);
-    }
-    // \~japanese �G�R�[�o�b�N�̉��
-    // \~english Checks the echoback
-    type = parse_distance_echoback(urg, buffer);
+    int stride = decoder->pending_stride;
+    int index = decoder->pending_first;
 
-    // \~japanese �����̎擾
-    // \~english Gets the response message
-    n = connection_readline(&urg->connection,
-                            buffer, BUFFER_SIZE, urg->timeout);
-    if (n != 3) {
-        ignore_receive_data_with_qt(urg, urg->timeout);
-        return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+    if (decoder->is_multiecho) {
+        // \~japanese マルチエコーはデコードと同時に格納している
+        // \~english Multiecho data is stored while decoding
+        return;
     }
 
-    if (buffer[n - 1] != scip_checksum(buffer, n - 1)) {
-        // \~japanese �`�F�b�N�T���̕]��
-        // \~english Validates the checksum
-        ignore_receive_data_with_qt(urg, urg->timeout);
-        return set_errno_and_return(urg, URG_CHECKSUM_ERROR);
-    }
+    while (index < decoder->step_filled) {
+        const uint32_t *values =
+            &decoder->pending[(index - decoder->pending_first) * stride];
+        int n = decoder->step_filled - index;
+        int i;
 
-    if (type == URG_STOP) {
-        // \~japanese QT �����̏ꍇ�ɂ́A�Ō�̉��s��ǂݎ̂āA���퉞���Ƃ��ď�������
-        // \~english If received QT response, ignore the last end-of-line and return as successful
-        n = connection_readline(&urg->connection,
-                                buffer, BUFFER_SIZE, urg->timeout);
-        if (n == 0) {
-            return 0;
-        } else {
-            return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+        if (decoder->regions) {
+            int run_size = region_run_size(decoder, index);
+            if (n > run_size) {
+                n = run_size;
+            }
+            if (!decoder->is_run_inside) {
+                index += n;
+                continue;
+            }
         }
-    }
-
-    if (urg->specified_scan_times != 1) {
-        if (!strncmp(buffer, "00", 2)) {
-            // \~japanese "00" �����̏ꍇ�́A�G�R�[�o�b�N�����Ƃ݂Ȃ��A
-            // \~japanese �Ō�̋�s��ǂݎ̂āA������̃f�[�^��Ԃ�
-	    // \~english If received "00" response, assumes it is the echoback
-	    // \~english Skips up to the next empty line and returns the next data
-            n = connection_readline(&urg->connection,
-                                    buffer, BUFFER_SIZE, urg->timeout);
 
-            if (n != 0) {
-                ignore_receive_data_with_qt(urg, urg->timeout);
-                return set_errno_and_return(urg, URG_INVALID_RESPONSE);
-            } else {
-                return receive_data(urg, data, intensity, time_stamp);
+        if (decoder->length) {
+            store_length_block(decoder, index, values, n, stride);
+        }
+        if (decoder->mask) {
+            store_validity_block(decoder, index, values, n, stride);
+        }
+        if (decoder->intensity && (stride == 2)) {
+            for (i = 0; i < n; ++i) {
+                decoder->intensity[index + i] = (unsigned short)values[2 * i + 1];
             }
         }
+        index += n;
     }
+    decoder->pending_first = decoder->step_filled;
+}
+
+
+// \~japanese マルチエコーの [p, last_p) のデータをデコードし、デコードしきれなかったデータの先頭を返す
+// \~japanese データが多過ぎるときは NULL を返す
+// \~english Decodes the multiecho data in [p, last_p) and returns the start of the undecoded rest
+// \~english Returns NULL if there is extra data
+static URG_FORCE_INLINE
+const char *decode_multiecho_data(urg_t *urg, length_decoder_t *decoder,
+                                  const char *p, const char *last_p,
+                                  uint32_t *sum,
+                                  int each_size, int is_intensity)
+{
+    int is_length = (decoder->length != NULL);
+    unsigned short *intensity = decoder->intensity;
+    int data_size = is_intensity ? 2 * each_size : each_size;
+    int last_step = urg->received_last_index - urg->received_first_index;
+
+    (void)sum;
+
+    while ((last_p - p) >= data_size) {
+        int index;
+
+        if (*p == '&') {
+            // \~japanese 先頭文字が '&' だったときは、マルチエコーのデータとみなす
+            // \~english If the start character is a '&' then assume data is multiecho
+            if ((last_p - (p + 1)) < data_size) {
+                // \~japanese '&' を除いて、data_size 分データが無ければ抜ける
+                // \~english Skips the '&' and if the string size is less than data_size ignore it
+                break;
+            }
+
+            --decoder->step_filled;
+            ++decoder->multiecho_index;
+            ++p;
+
+        } else {
+            // \~japanese 次のデータ
+            // \~english Next data
+            decoder->multiecho_index = 0;
+        }
+
+        index = (decoder->step_filled * URG_MAX_ECHO)
+            + decoder->multiecho_index;
+
+        if (decoder->step_filled > last_step) {
+            // \~japanese データが多過ぎる
+            // \~english There is extra data
+            return NULL;
+        }
+
+        if (!is_region_step(decoder, decoder->step_filled)) {
+            // \~japanese 範囲外の step は格納しない
+            // \~english Steps outside the ranges are not stored
+            p += data_size;
+            ++decoder->step_filled;
+            continue;
+        }
+
+        if (decoder->multiecho_index == 0) {
+            // \~japanese マルチエコーのデータ格納先をダミーデータで埋める
+            // \~english Stores dummy values in the multiecho data location
+            int i;
+            if (is_length) {
+                for (i = 1; i < URG_MAX_ECHO; ++i) {
+                    store_length(decoder, index + i, 0);
+                }
+            }
+            if (intensity) {
+                for (i = 1; i < URG_MAX_ECHO; ++i) {
+                    intensity[index + i] = 0;
+                }
+            }
+        }
+
+        // \~japanese 距離データの格納
+        // \~english Stores the distance data
+        if (is_length || decoder->mask) {
+            uint32_t value = (uint32_t)urg_scip_decode(p, each_size);
+            if (is_length) {
+                store_length(decoder, index, value);
+            }
+            if (decoder->mask && (decoder->multiecho_index == 0)) {
+                store_validity_block(decoder, decoder->step_filled,
+                                     &value, 1, 1);
+            }
+        }
+        p += each_size;
+
+        // \~japanese 強度データの格納
+        // \~english Stores the intensity data
+        if (is_intensity) {
+            if (intensity) {
+                intensity[index] = (unsigned short)urg_scip_decode(p, each_size);
+            }
+            p += each_size;
+        }
+
+        ++decoder->step_filled;
+    }
+    return p;
+}
+
+
+// \~japanese マルチエコーの [p, last_p) のデータを、エコーごとの配列に格納しながらデコードする
+// \~japanese デコードしきれなかったデータの先頭を返し、データが多過ぎるときは NULL を返す
+// \~english Decodes the multiecho data in [p, last_p) into the per-echo arrays
+// \~english Returns the start of the undecoded rest, or NULL if there is extra data
+static URG_FORCE_INLINE
+const char *decode_multiecho_planes_data(urg_t *urg,
+                                         length_decoder_t *decoder,
+                                         const char *p, const char *last_p,
+                                         uint32_t *sum,
+                                         int each_size, int is_intensity)
+{
+    urg_multiecho_planes_t *planes = (urg_multiecho_planes_t *)decoder->length;
+    int data_size = is_intensity ? 2 * each_size : each_size;
+    int last_step = urg->received_last_index - urg->received_first_index;
+
+    (void)sum;
+
+    while ((last_p - p) >= data_size) {
+        int step;
+        int echo;
+
+        if (*p == '&') {
+            if ((last_p - (p + 1)) < data_size) {
+                break;
+            }
+            --decoder->step_filled;
+            ++decoder->multiecho_index;
+            ++p;
+        } else {
+            decoder->multiecho_index = 0;
+        }
+
+        step = decoder->step_filled;
+        echo = decoder->multiecho_index;
+        if ((step > last_step) || (echo >= URG_MAX_ECHO)) {
+            // \~japanese データが多過ぎる
+            // \~english There is extra data
+            return NULL;
+        }
+
+        if (!is_region_step(decoder, step)) {
+            // \~japanese 範囲外の step はエコー数を 0 にする
+            // \~english Steps outside the ranges get an echo count of 0
+            if (planes->echo_count) {
+                planes->echo_count[step] = 0;
+            }
+            p += data_size;
+            ++decoder->step_filled;
+            continue;
+        }
+
+        // \~japanese 存在しないエコーの領域は埋めずに、エコー数だけを更新する
+        // \~english Missing echoes are not filled, only the echo count is updated
+        if (planes->echo_count) {
+            planes->echo_count[step] = (unsigned char)(echo + 1);
+        }
+        if (planes->length[echo] || (decoder->mask && (echo == 0))) {
+            uint32_t value = (uint32_t)urg_scip_decode(p, each_size);
+            if (planes->length[echo]) {
+                planes->length[echo][step] = value;
+            }
+            if (decoder->mask && (echo == 0)) {
+                store_validity_block(decoder, step, &value, 1, 1);
+            }
+        }
+        p += each_size;
+
+        if (is_intensity) {
+            if (planes->intensity[echo]) {
+                planes->intensity[echo][step] =
+                    (unsigned short)urg_scip_decode(p, each_size);
+            }
+            p += each_size;
+        }
+
+        ++decoder->step_filled;
+    }
+    return p;
+}
+
+
+// \~japanese 文字数と強度の有無を定数にしたデコード関数を定義する
+// \~english Defines a decoding function with the number of characters and the intensity flag as constants
+#define DEFINE_LENGTH_DECODER(name, decode, each_size, is_intensity)    \
+    static const char *name(urg_t *urg, length_decoder_t *decoder,      \
+                            const char *p, const char *last_p,          \
+                            uint32_t *sum)                              \
+    {                                                                   \
+        return decode(urg, decoder, p, last_p, sum,                     \
+                      each_size, is_intensity);                         \
+    }
+
+DEFINE_LENGTH_DECODER(decode_distance_2, decode_single_echo_data, 2, 0)
+DEFINE_LENGTH_DECODER(decode_distance_3, decode_single_echo_data, 3, 0)
+DEFINE_LENGTH_DECODER(decode_intensity_2, decode_single_echo_data, 2, 1)
+DEFINE_LENGTH_DECODER(decode_intensity_3, decode_single_echo_data, 3, 1)
+DEFINE_LENGTH_DECODER(decode_multiecho_2, decode_multiecho_data, 2, 0)
+DEFINE_LENGTH_DECODER(decode_multiecho_3, decode_multiecho_data, 3, 0)
+DEFINE_LENGTH_DECODER(decode_multiecho_intensity_2,
+                      decode_multiecho_data, 2, 1)
+DEFINE_LENGTH_DECODER(decode_multiecho_intensity_3,
+                      decode_multiecho_data, 3, 1)
+DEFINE_LENGTH_DECODER(decode_planes_2, decode_multiecho_planes_data, 2, 0)
+DEFINE_LENGTH_DECODER(decode_planes_3, decode_multiecho_planes_data, 3, 0)
+DEFINE_LENGTH_DECODER(decode_planes_intensity_2,
+                      decode_multiecho_planes_data, 2, 1)
+DEFINE_LENGTH_DECODER(decode_planes_intensity_3,
+                      decode_multiecho_planes_data, 3, 1)
+
+
+static void length_decoder_initialize(urg_t *urg, length_decoder_t *decoder,
+                                      void *length, length_type_t length_type,
+                                      unsigned short intensity[],
+                                      urg_measurement_type_t type)
+{
+    int each_size =
+        (urg->received_range_data_byte == URG_COMMUNICATION_2_BYTE) ? 2 : 3;
+    int is_3_byte = (each_size == 3) ? 1 : 0;
+
+    decoder->length = length;
+    decoder->length_type = length_type;
+    decoder->intensity = intensity;
+    decoder->data_size = each_size;
+    decoder->is_multiecho = URG_FALSE;
+    decoder->step_filled = 0;
+    decoder->multiecho_index = 0;
+    decoder->pending_first = 0;
+    decoder->pending_stride = (type == URG_DISTANCE_INTENSITY) ? 2 : 1;
+
+    decoder->regions =
+        (urg->decode_region_count > 0) ? urg->decode_regions : NULL;
+    decoder->region_count = urg->decode_region_count;
+    decoder->region_offset = urg->received_first_index - urg->front_data_index;
+    decoder->region_skip =
+        (urg->received_skip_step > 1) ? urg->received_skip_step : 1;
+    decoder->run_first = 1;
+    decoder->run_last = 0;
+
+    decoder->mask = NULL;
+    decoder->mask_size = 0;
+    decoder->min_distance = (uint32_t)urg->min_distance;
+    if (urg->validity_mask && (urg->validity_mask_size > 0)) {
+        // \~japanese 受信しない範囲も含めて全てのビットを 0 にしておき、有効なデータのビットだけを立てる
+        // \~english All the bits are cleared, those beyond the received range as well, and only those of valid data are set
+        int steps = urg->received_last_index - urg->received_first_index + 1;
+        decoder->mask = urg->validity_mask;
+        decoder->mask_size = (steps < urg->validity_mask_size) ?
+            steps : urg->validity_mask_size;
+        if (decoder->mask_size < 0) {
+            decoder->mask_size = 0;
+        }
+        memset(decoder->mask, 0, ((urg->validity_mask_size + 31) / 32) *
+               sizeof(decoder->mask[0]));
+    }
+
+    // \~japanese デコード関数は応答ごとに一度だけ選択する
+    // \~english The decoding function is selected once per response
+    switch (type) {
+    case URG_DISTANCE_INTENSITY:
+        decoder->data_size *= 2;
+        decoder->decode =
+            is_3_byte ? decode_intensity_3 : decode_intensity_2;
+        break;
+
+    case URG_MULTIECHO:
+        decoder->is_multiecho = URG_TRUE;
+        decoder->decode =
+            is_3_byte ? decode_multiecho_3 : decode_multiecho_2;
+        break;
+
+    case URG_MULTIECHO_INTENSITY:
+        decoder->data_size *= 2;
+        decoder->is_multiecho = URG_TRUE;
+        decoder->decode = is_3_byte ?
+            decode_multiecho_intensity_3 : decode_multiecho_intensity_2;
+        break;
+
+    default:
+        decoder->decode = is_3_byte ? decode_distance_3 : decode_distance_2;
+        break;
+    }
+
+    if (length_type == LENGTH_PLANES) {
+        // \~japanese エコーごとの配列に格納するときは、行ごとにチェックサムを評価する
+        // \~english Lines are validated one by one when storing into the per-echo arrays
+        int is_intensity = (decoder->data_size != each_size);
+
+        decoder->is_multiecho = URG_TRUE;
+        if (is_intensity) {
+            decoder->decode =
+                is_3_byte ? decode_planes_intensity_3 : decode_planes_intensity_2;
+        } else {
+            decoder->decode = is_3_byte ? decode_planes_3 : decode_planes_2;
+        }
+    }
+}
+
+
+// \~japanese [p, last_p) のデータをデコードし、デコードしきれなかったデータの先頭を返す
+// \~japanese シングルエコーで sum が NULL でなければ、デコードした文字のバイト和を sum に加える。データが多過ぎるときは NULL を返す
+// \~english Decodes the data in [p, last_p) and returns the start of the undecoded rest
+// \~english For single echo, adds the byte sum of the decoded characters to sum unless it is NULL. Returns NULL if there is extra data
+static const char *decode_length_data(urg_t *urg, length_decoder_t *decoder,
+                                      const char *p, const char *last_p,
+                                      uint32_t *sum)
+{
+    return decoder->decode(urg, decoder, p, last_p, sum);
+}
+
+
+static int receive_length_data(urg_t *urg,
+                               void *length, length_type_t length_type,
+                               unsigned short intensity[],
+                               urg_measurement_type_t type, char buffer[])
+{
+    length_decoder_t decoder;
+    int n;
+    int line_filled = 0;
+
+    length_decoder_initialize(urg, &decoder, length, length_type,
+                              intensity, type);
+
+    do {
+        const char *p;
+        int carry_size = line_filled;
+        uint32_t sum = 0;
+
+        n = connection_readline(&urg->connection,
+                                &buffer[line_filled], BUFFER_SIZE - line_filled,
+                                urg->timeout);
+
+        if ((n > 0) && decoder.is_multiecho) {
+            // \~japanese チェックサムの評価
+            // \~english Validates the checksum
+            if (buffer[line_filled + n - 1] !=
+                scip_checksum(&buffer[line_filled], n - 1)) {
+                return drop_lines_and_return(urg, n, URG_CHECKSUM_ERROR);
+            }
+        }
+
+        if (n > 0) {
+            line_filled += n - 1;
+        }
+
+        p = decode_length_data(urg, &decoder, buffer, &buffer[line_filled],
+                               &sum);
+        if (!p) {
+            // \~japanese データが多過ぎる場合は、残りのデータを無視して戻る
+            // \~japanese 行がずれてデータが多過ぎるときは、チェックサムのエラーとする
+            // \~english If there is extra data, ignore it
+            // \~english If the extra data comes from a shifted line, it is a checksum error
+            if ((n > 0) && (buffer[line_filled] !=
+                            scip_checksum(&buffer[carry_size], n - 1))) {
+                return drop_lines_and_return(urg, n, URG_CHECKSUM_ERROR);
+            }
+            return drop_lines_and_return(urg, n, URG_RECEIVE_ERROR);
+        }
+
+        if ((n > 0) && !decoder.is_multiecho) {
+            // \~japanese デコードと同時に求めたバイト和で、この行のチェックサムを評価する
+            // \~japanese 前の行から持ち越した文字の和は除き、デコードしなかった残りの和を加える
+            // \~english Validates the checksum of this line with the byte sum taken while decoding
+            // \~english The sum of the characters carried from the previous line is removed, and the sum of the undecoded rest is added
+            sum -= byte_sum(buffer, &buffer[carry_size]);
+            sum += byte_sum(p, &buffer[line_filled]);
+            if (buffer[line_filled] != sum_checksum(sum)) {
+                return drop_lines_and_return(urg, n, URG_CHECKSUM_ERROR);
+            }
+        }
+        store_pending_data(&decoder);
+
+        // \~japanese 次に処理する文字を退避
+        // \~english Prepares the next line to process
+        line_filled -= (int)(p - buffer);
+        memmove(buffer, p, line_filled);
+    } while (n > 0);
+
+    return decoder.step_filled;
+}
+
+
+// \~japanese 受信バッファ内のデータ行 [p, last_p) を、行ごとにチェックサムを評価しながらデコードする
+// \~english Decodes the data lines [p, last_p) in the receive buffer, validating the checksum of each line
+static int decode_frame_length_data(urg_t *urg, length_decoder_t *decoder,
+                                    const char *p, const char *last_p)
+{
+    // \~japanese 行をまたぐデータを連結するための領域
+    // \~english Joins the data split across lines
+    char carry[2 * (1 + 6)];
+    int carry_size = 0;
+
+    while (p < last_p) {
+        const char *line_end = memchr(p, '\n', last_p - p);
+        const char *line = p;
+        const char *data_end;
+        const char *rest;
+        uint32_t sum = 0;
+        int n;
+
+        if (!line_end) {
+            line_end = last_p;
+        }
+        n = (int)(line_end - p);
+        if (n <= 0) {
+            return URG_INVALID_RESPONSE;
+        }
+        data_end = &p[n - 1];
+
+        // \~japanese チェックサムの評価
+        // \~japanese シングルエコーの行は、デコードと同時に求めたバイト和で後から評価する
+        // \~english Validates the checksum
+        // \~english Single echo lines are validated afterwards with the byte sum taken while decoding
+        if (decoder->is_multiecho && (*data_end != scip_checksum(p, n - 1))) {
+            return URG_CHECKSUM_ERROR;
+        }
+
+        if (carry_size > 0) {
+            // \~japanese 前の行の残りと、この行の先頭とを連結してデコードする
+            // \~english Decodes the rest of the previous line joined with the head of this line
+            int copy_size = (int)(data_end - p);
+            int used_size;
+
+            if (copy_size > (int)sizeof(carry) - carry_size) {
+                copy_size = (int)sizeof(carry) - carry_size;
+            }
+            memcpy(&carry[carry_size], p, copy_size);
+            rest = decode_length_data(urg, decoder, carry,
+                                      &carry[carry_size + copy_size], NULL);
+            if (!rest) {
+                return (*data_end != scip_checksum(line, n - 1)) ?
+                    URG_CHECKSUM_ERROR : URG_RECEIVE_ERROR;
+            }
+
+            used_size = (int)(rest - carry);
+            if (used_size < carry_size) {
+                // \~japanese この行だけではデータが揃わない
+                // \~english This line is too short to complete the data
+                if (*data_end != scip_checksum(line, n - 1)) {
+                    return URG_CHECKSUM_ERROR;
+                }
+                store_pending_data(decoder);
+                carry_size += copy_size - used_size;
+                memmove(carry, rest, carry_size);
+                p = line_end + 1;
+                continue;
+            }
+            p += used_size - carry_size;
+            carry_size = 0;
+        }
+
+        rest = decode_length_data(urg, decoder, p, data_end, &sum);
+        if (!rest) {
+            // \~japanese 行がずれてデータが多過ぎるときは、チェックサムのエラーとする
+            // \~english If the extra data comes from a shifted line, it is a checksum error
+            return (*data_end != scip_checksum(line, n - 1)) ?
+                URG_CHECKSUM_ERROR : URG_RECEIVE_ERROR;
+        }
+        if (!decoder->is_multiecho) {
+            sum += byte_sum(line, p) + byte_sum(rest, data_end);
+            if (*data_end != sum_checksum(sum)) {
+                return URG_CHECKSUM_ERROR;
+            }
+        }
+        // \~japanese チェックサムを評価してから、呼び出し側の配列に格納する
+        // \~english The caller's arrays are written only after the checksum is validated
+        store_pending_data(decoder);
+        carry_size = (int)(data_end - rest);
+        memcpy(carry, rest, carry_size);
+
+        p = line_end + 1;
+    }
+    return decoder->step_filled;
+}
+
+
+// \~japanese urg_send_command() の応答の 1 行を格納する。n はチェックサムを含む行の長さ
+// \~english Stores one line of the response of urg_send_command(). n is the line length with the checksum
+static void store_command_line(urg_t *urg, const char *line, int n)
+{
+    if (urg->command_response_lines < 0) {
+        return;
+    }
+
+    if ((n > 1) && (line[n - 1] != scip_checksum(line, n - 1)) &&
+        (line[n - 1] != scip_checksum(line, n - 2))) {
+        urg->command_response_lines = URG_CHECKSUM_ERROR;
+        return;
+    }
+    if (n >= (urg->command_response_size - urg->command_response_filled)) {
+        urg->command_response_lines = URG_RECEIVE_ERROR;
+        return;
+    }
+
+    memcpy(&urg->command_response[urg->command_response_filled], line, n);
+    urg->command_response_filled += n;
+    urg->command_response[urg->command_response_filled++] = '\0';
+    ++urg->command_response_lines;
+}
+
+
+static void finish_command_response(urg_t *urg, int urg_errno)
+{
+    if (urg_errno < 0) {
+        urg->command_response_lines = urg_errno;
+    } else if (urg->command_response_lines == 0) {
+        urg->command_response_lines = URG_INVALID_RESPONSE;
+    }
+    urg->is_command_pending = URG_FALSE;
+}
+
+
+// \~japanese 連続計測中にエコーバックを受信しないまま期限を過ぎたら、urg_send_command() を #URG_NO_RESPONSE で終える
+// \~english Ends urg_send_command() with #URG_NO_RESPONSE when its echoback was not received before the deadline during the continuous measurement
+static void expire_command_response(urg_t *urg)
+{
+    if (urg->is_command_pending && urg->is_sending && (urg->timeout >= 0) &&
+        ((connection_ticks() - urg->command_deadline) >= 0)) {
+        finish_command_response(urg, URG_NO_RESPONSE);
+    }
+}
+
+
+// \~japanese エコーバックが urg_send_command() で送信したコマンドのものか
+// \~english Whether the echoback is the one of the command sent with urg_send_command()
+static int is_command_echoback(const urg_t *urg, const char echoback[])
+{
+    return urg->is_command_pending && !strcmp(echoback, urg->command_echoback);
+}
+
+
+// \~japanese エコーバックに続く応答を、空行まで 1 行ずつ受信して格納する
+// \~english Receives and stores the lines following the echoback, up to the empty line
+static int receive_command_lines(urg_t *urg)
+{
+    char buffer[BUFFER_SIZE];
+    int n;
+
+    do {
+        n = connection_readline(&urg->connection,
+                                buffer, BUFFER_SIZE, urg->timeout);
+        if (n < 0) {
+            finish_command_response(urg, URG_NO_RESPONSE);
+            return URG_NO_RESPONSE;
+        } else if (n > 0) {
+            store_command_line(urg, buffer, n);
+        }
+    } while (n > 0);
+
+    finish_command_response(urg, URG_NO_ERROR);
+    return URG_NO_ERROR;
+}
+
+
+// \~japanese 受信バッファ内の応答のエコーバックより後 [p, last_p) を格納する
+// \~english Stores the response after the echoback, [p, last_p), in the receive buffer
+static void store_command_frame(urg_t *urg, const char *p, const char *last_p)
+{
+    while (p < last_p) {
+        const char *line_end = memchr(p, '\n', last_p - p);
+        if (!line_end) {
+            line_end = last_p;
+        }
+        store_command_line(urg, p, (int)(line_end - p));
+        p = line_end + 1;
+    }
+    finish_command_response(urg, URG_NO_ERROR);
+}
+
+
+// \~japanese 1 行ずつ受信してデコードする
+// \~english Receives and decodes line by line
+static int receive_line_data(urg_t *urg,
+                             void *data, length_type_t length_type,
+                             unsigned short intensity[], long *time_stamp)
+{
+    urg_measurement_type_t type;
+    char buffer[BUFFER_SIZE];
+    int ret = 0;
+    int n;
+    int extended_timeout = urg->timeout
+        + 2 * (urg->scan_usec * (urg->scanning_skip_scan) / 1000);
+
+    // \~japanese �G�R�[�o�b�N�̎擾
+    // \~english Gets the echoback
+    n = connection_readline(&urg->connection,
+                            buffer, BUFFER_SIZE, extended_timeout);
+    if (n <= 0) {
+        return set_errno_and_return(urg, URG_NO_RESPONSE);
+    }
+    // \~japanese �G�R�[�o�b�N�̉��
+    // \~english Checks the echoback
+    type = parse_distance_echoback(urg, buffer);
+    if ((type == URG_UNKNOWN) && is_command_echoback(urg, buffer)) {
+        // \~japanese urg_send_command() の応答を格納し、次の計測データを受信する
+        // \~english Stores the response of urg_send_command() and receives the next measurement data
+        if (receive_command_lines(urg) < 0) {
+            return set_errno_and_return(urg, URG_NO_RESPONSE);
+        }
+        return receive_line_data(urg, data, length_type,
+                                 intensity, time_stamp);
+    }
+    if ((type == URG_UNKNOWN) && is_resync_enabled(urg)) {
+        return drop_lines_and_return(urg, n, URG_INVALID_RESPONSE);
+    }
+
+    // \~japanese �����̎擾
+    // \~english Gets the response message
+    n = connection_readline(&urg->connection,
+                            buffer, BUFFER_SIZE, urg->timeout);
+    if (n != 3) {
+        return drop_lines_and_return(urg, n, URG_INVALID_RESPONSE);
+    }
+
+    if (buffer[n - 1] != scip_checksum(buffer, n - 1)) {
+        // \~japanese �`�F�b�N�T���̕]��
+        // \~english Validates the checksum
+        return drop_lines_and_return(urg, n, URG_CHECKSUM_ERROR);
+    }
+
+    if (type == URG_STOP) {
+        // \~japanese QT �����̏ꍇ�ɂ́A�Ō�̉��s��ǂݎ̂āA���퉞���Ƃ��ď�������
+        // \~english If received QT response, ignore the last end-of-line and return as successful
+        n = connection_readline(&urg->connection,
+                                buffer, BUFFER_SIZE, urg->timeout);
+        if (n == 0) {
+            return 0;
+        } else {
+            return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+        }
+    }
+
+    if (urg->specified_scan_times != 1) {
+        if (!strncmp(buffer, "00", 2)) {
+            // \~japanese "00" �����̏ꍇ�́A�G�R�[�o�b�N�����Ƃ݂Ȃ��A
+            // \~japanese �Ō�̋�s��ǂݎ̂āA������̃f�[�^��Ԃ�
+	    // \~english If received "00" response, assumes it is the echoback
+	    // \~english Skips up to the next empty line and returns the next data
+            n = connection_readline(&urg->connection,
+                                    buffer, BUFFER_SIZE, urg->timeout);
+
+            if (n != 0) {
+                ignore_receive_data_with_qt(urg, urg->timeout);
+                return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+            } else {
+                return receive_line_data(urg, data, length_type,
+                                         intensity, time_stamp);
+            }
+        }
+    }
+
+    if (((urg->specified_scan_times == 1) && (strncmp(buffer, "00", 2))) ||
+        ((urg->specified_scan_times != 1) && (strncmp(buffer, "99", 2)))) {
+        if (urg->error_handler) {
+            type = urg->error_handler(buffer, urg);
+        }
+
+        //if (type == URG_UNKNOWN) {
+            // \~japanese Gx, Hx �̂Ƃ��� 00P ���Ԃ��ꂽ�Ƃ����f�[�^
+            // \~japanese Mx, Nx �̂Ƃ��� 99b ���Ԃ��ꂽ�Ƃ����f�[�^
+            // \~english If received "00P" response for Gx/Hx
+            // \~english If received "99b" response for Mx/Nx
+            ignore_receive_data_with_qt(urg, urg->timeout);
+            return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+        //}
+    }
+
+    // \~japanese �^�C���X�^���v�̎擾
+    // \~english Gets the timestamp
+    n = connection_readline(&urg->connection,
+                            buffer, BUFFER_SIZE, urg->timeout);
+    if (n > 0) {
+        if (time_stamp) {
+            *time_stamp = urg_scip_decode(buffer, 4);
+        }
+    }
+
+    // \~japanese �f�[�^�̎擾
+    // \~english Gets the measurement data
+    switch (type) {
+    case URG_DISTANCE:
+    case URG_MULTIECHO:
+        ret = receive_length_data(urg, data, length_type,
+                                  NULL, type, buffer);
+        break;
+
+    case URG_DISTANCE_INTENSITY:
+    case URG_MULTIECHO_INTENSITY:
+        ret = receive_length_data(urg, data, length_type,
+                                  intensity, type, buffer);
+        break;
+
+    case URG_STOP:
+    case URG_UNKNOWN:
+        ret = 0;
+        break;
+    }
+
+    if ((ret >= 0) || !is_resync_enabled(urg)) {
+        // \~japanese 再同期で読み捨てた応答は drop_lines_and_return() で数えている
+        // \~english A response skipped by the resynchronisation is counted in drop_lines_and_return()
+        update_remain_times(urg);
+    }
+    return ret;
+}
 
-    if (((urg->specified_scan_times == 1) && (strncmp(buffer, "00", 2))) ||
-        ((urg->specified_scan_times != 1) && (strncmp(buffer, "99", 2)))) {
-        if (urg->error_handler) {
-            type = urg->error_handler(buffer, urg);
-        }
 
-        //if (type == URG_UNKNOWN) {
-            // \~japanese Gx, Hx �̂Ƃ��� 00P ���Ԃ��ꂽ�Ƃ����f�[�^
-            // \~japanese Mx, Nx �̂Ƃ��� 99b ���Ԃ��ꂽ�Ƃ����f�[�^
-            // \~english If received "00P" response for Gx/Hx
-            // \~english If received "99b" response for Mx/Nx
-            ignore_receive_data_with_qt(urg, urg->timeout);
-            return set_errno_and_return(urg, URG_INVALID_RESPONSE);
-        //}
+// \~japanese 受信バッファ内の応答を取り除き、受信中のデータを無視してエラーを返す
+// \~english Removes the response from the receive buffer, ignores the pending data and returns the error
+static int drop_frame_and_return(urg_t *urg, int frame_size, int urg_errno)
+{
+    connection_consume(&urg->connection, frame_size);
+    ignore_receive_data_with_qt(urg, urg->timeout);
+    return set_errno_and_return(urg, urg_errno);
+}
+
+
+// \~japanese 壊れた応答を受信バッファから取り除いてエラーを返す
+// \~japanese 再同期するときは計測を止めずに、受信バッファの先頭から最初の空行までを取り除く
+// \~english Removes the damaged response from the receive buffer and returns the error
+// \~english When resynchronising, removes the data up to the first empty line in the receive buffer without stopping the measurement
+static int resync_frame_and_return(urg_t *urg, int frame_size, int urg_errno)
+{
+    char *frame;
+    int size;
+
+    if (!is_resync_enabled(urg)) {
+        return drop_frame_and_return(urg, frame_size, urg_errno);
     }
 
-    // \~japanese �^�C���X�^���v�̎擾
+    // \~japanese 計測開始時に求めたバイト数で受信したときも、次の応答の先頭から受信を続けられるように空行で区切る
+    // \~english Cuts at the empty line, so that the next response is received from its start even if the computed byte count was received
+    size = connection_peek_frame(&urg->connection, &frame, urg->timeout);
+    connection_consume(&urg->connection, (size > 0) ? size : frame_size);
+    ++urg->dropped_frame_count;
+    update_remain_times(urg);
+    return set_errno_and_return(urg, urg_errno);
+}
+
+
+// \~japanese 応答のタイムスタンプ以降 [p, last_p) をデコードし、デコードした step の個数を返す
+// \~english Decodes the response from the timestamp on, [p, last_p), and returns the number of decoded steps
+static int decode_frame_body(urg_t *urg, urg_measurement_type_t type,
+                             const char *p, const char *last_p,
+                             void *data, length_type_t length_type,
+                             unsigned short intensity[], long *time_stamp)
+{
+    length_decoder_t decoder;
+    const char *line_end;
+    int ret = 0;
+
+    // \~japanese タイムスタンプの取得
     // \~english Gets the timestamp
-    n = connection_readline(&urg->connection,
-                            buffer, BUFFER_SIZE, urg->timeout);
-    if (n > 0) {
-        if (time_stamp) {
-            *time_stamp = urg_scip_decode(buffer, 4);
+    line_end = memchr(p, '\n', last_p - p);
+    if (line_end) {
+        if (((line_end - p) > 0) && time_stamp) {
+            *time_stamp = urg_scip_decode(p, 4);
         }
+        p = line_end + 1;
     }
 
-    // \~japanese �f�[�^�̎擾
-    // \~english Gets the measurement data
+    // \~japanese データのデコード
+    // \~english Decodes the measurement data
     switch (type) {
     case URG_DISTANCE:
     case URG_MULTIECHO:
-        ret = receive_length_data(urg, data, NULL, type, buffer);
+        length_decoder_initialize(urg, &decoder, data, length_type,
+                                  NULL, type);
+        ret = decode_frame_length_data(urg, &decoder, p, last_p);
         break;
 
     case URG_DISTANCE_INTENSITY:
     case URG_MULTIECHO_INTENSITY:
-        ret = receive_length_data(urg, data, intensity, type, buffer);
+        length_decoder_initialize(urg, &decoder, data, length_type,
+                                  intensity, type);
+        ret = decode_frame_length_data(urg, &decoder, p, last_p);
         break;
 
     case URG_STOP:
@@ -740,39 +1834,617 @@ static int receive_data(urg_t *urg, long data[], unsigned short intensity[],
         ret = 0;
         break;
     }
+    return ret;
+}
 
-    // \~japanese specified_scan_times == 1 �̂Ƃ��� Gx �n�R�}���h���g���邽��
-    // \~japanese �f�[�^�𖾎��I�ɒ�~���Ȃ��Ă悢
-    // \~english If specified_scan_times == 1 then we are using a Gx type command
-    // \~english it is not necessary to explicity stop measurement
-    if ((urg->specified_scan_times > 1) && (urg->scanning_remain_times > 0)) {
-        if (--urg->scanning_remain_times <= 0) {
-            // \~japanese �f�[�^�̒�~�݂̂��s��
-	    // \~english Stops measurement
-            urg_stop_measurement(urg);
+
+// \~japanese エコーバックとステータスの 2 行 [header, header + size) が、計測データを含む応答のものか
+// \~english Whether the echoback and status lines [header, header + size) start a response with measurement data
+static int is_data_header(const urg_t *urg, const char *header, int size)
+{
+    const char *status = memchr(header, '\n', size);
+
+    if (!status || !strncmp(header, "QT\n", 3)) {
+        return URG_FALSE;
+    }
+    ++status;
+    if ((&header[size] - status) < 3) {
+        return URG_FALSE;
+    }
+    return (urg->specified_scan_times == 1) ?
+        !strncmp(status, "00", 2) : !strncmp(status, "99", 2);
+}
+
+
+// \~japanese 受信バッファ内の応答全体をデコードする
+// \~english Decodes the whole response in the receive buffer
+static int receive_frame_data(urg_t *urg,
+                              void *data, length_type_t length_type,
+                              unsigned short intensity[], long *time_stamp)
+{
+    urg_measurement_type_t type;
+    char buffer[BUFFER_SIZE];
+    char *frame;
+    const char *p;
+    const char *last_p = NULL;
+    const char *line_end;
+    int is_exact = (urg->receive_mode == URG_RECEIVE_EXACT_FRAME) &&
+        (urg->expected_frame_size > 0);
+    int received_size = 0;
+    int frame_size;
+    int is_data;
+    int ret = 0;
+    int n;
+    int extended_timeout = urg->timeout
+        + 2 * (urg->scan_usec * (urg->scanning_skip_scan) / 1000);
+    int frame_timeout = extended_timeout;
+
+    if (is_exact) {
+        // \~japanese ステータスが計測データを示すときだけ、計測開始時に求めたバイト数をまとめて受信する
+        // \~japanese エラーなどの短い応答では、求めたバイト数を待たずに空行までを応答とする
+        // \~english Receives the number of bytes computed when the measurement started only if the status tells measurement data
+        // \~english A short response such as an error is taken up to its empty line, without waiting for the computed bytes
+        n = connection_peek_lines(&urg->connection, &frame, 2,
+                                  extended_timeout);
+        frame_timeout = (n > 0) ? urg->timeout : 0;
+        if ((n > 0) && is_data_header(urg, frame, n)) {
+            received_size = connection_peek(&urg->connection, &frame,
+                                            urg->expected_frame_size,
+                                            urg->timeout);
+            frame_timeout = 0;
+        }
+    }
+    if (received_size > 0) {
+        // \~japanese 応答の終端はステータスの解析後に決める
+        // \~english The end of the response is decided after checking the status
+        frame_size = 0;
+        last_p = &frame[received_size];
+    } else if (received_size == URG_CONNECTION_OVERFLOW) {
+        frame_size = URG_CONNECTION_OVERFLOW;
+    } else {
+        // \~japanese 指定バイト数が揃わないときは、受信済みの空行までを応答とする
+        // \~english If the bytes did not arrive, takes the data up to a received empty line
+        frame_size = connection_peek_frame(&urg->connection, &frame,
+                                           frame_timeout);
+        if (frame_size > 0) {
+            received_size = frame_size;
+            last_p = &frame[frame_size - 1];
+        }
+    }
+    if (frame_size == URG_CONNECTION_OVERFLOW) {
+        ignore_receive_data_with_qt(urg, urg->timeout);
+        return set_errno_and_return(urg, URG_RECEIVE_ERROR);
+    } else if (frame_size < 0) {
+        return set_errno_and_return(urg, URG_NO_RESPONSE);
+    }
+    p = frame;
+
+    // \~japanese エコーバックの解析
+    // \~english Checks the echoback
+    line_end = memchr(p, '\n', last_p - p);
+    n = line_end ? (int)(line_end - p) : 0;
+    if ((n <= 0) || (n >= BUFFER_SIZE)) {
+        return resync_frame_and_return(urg, received_size,
+                                       URG_INVALID_RESPONSE);
+    }
+    memcpy(buffer, p, n);
+    buffer[n] = '\0';
+    type = parse_distance_echoback(urg, buffer);
+    if ((type == URG_UNKNOWN) && is_command_echoback(urg, buffer)) {
+        // \~japanese urg_send_command() の応答を格納し、次の計測データを受信する
+        // \~japanese 計測開始時に求めたバイト数で受信したときは、空行までを応答とする
+        // \~english Stores the response of urg_send_command() and receives the next measurement data
+        // \~english If the computed byte count was received, the response is taken up to the empty line
+        if (frame_size <= 0) {
+            frame_size = connection_peek_frame(&urg->connection, &frame,
+                                               urg->timeout);
+            if (frame_size < 0) {
+                finish_command_response(urg, URG_NO_RESPONSE);
+                return set_errno_and_return(urg, URG_NO_RESPONSE);
+            }
+        }
+        store_command_frame(urg, &frame[n + 1], &frame[frame_size - 1]);
+        connection_consume(&urg->connection, frame_size);
+        return receive_frame_data(urg, data, length_type,
+                                  intensity, time_stamp);
+    }
+    if ((type == URG_UNKNOWN) && is_resync_enabled(urg)) {
+        return resync_frame_and_return(urg, received_size,
+                                       URG_INVALID_RESPONSE);
+    }
+    p = line_end + 1;
+
+    // \~japanese 応答の解析
+    // \~english Checks the response message
+    line_end = memchr(p, '\n', last_p - p);
+    if (!line_end) {
+        line_end = last_p;
+    }
+    n = (int)(line_end - p);
+    if (n != 3) {
+        return resync_frame_and_return(urg, received_size,
+                                       URG_INVALID_RESPONSE);
+    }
+    if (p[n - 1] != scip_checksum(p, n - 1)) {
+        return resync_frame_and_return(urg, received_size,
+                                       URG_CHECKSUM_ERROR);
+    }
+    memcpy(buffer, p, n);
+    buffer[n] = '\0';
+    p = (line_end < last_p) ? line_end + 1 : last_p;
+
+    is_data = (type != URG_STOP) &&
+        (((urg->specified_scan_times == 1) && !strncmp(buffer, "00", 2)) ||
+         ((urg->specified_scan_times != 1) && !strncmp(buffer, "99", 2)));
+    if (is_exact) {
+        if (is_data) {
+            // \~japanese データを含む応答は、求めたバイト数で空行が終端になっていること
+            // \~english A response with data must end with the empty line at the computed size
+            frame_size = urg->expected_frame_size;
+            if ((received_size != frame_size) ||
+                (frame[frame_size - 2] != '\n') ||
+                (frame[frame_size - 1] != '\n')) {
+                return resync_frame_and_return(urg, received_size,
+                                               URG_FRAMING_ERROR);
+            }
+        } else if (frame_size == 0) {
+            // \~japanese データを含まない応答は、ステータスの次の空行で終端する
+            // \~english A response without data ends with the empty line after the status
+            frame_size = (int)(p - frame) + 1;
+            if (frame[frame_size - 1] != '\n') {
+                return resync_frame_and_return(urg, received_size,
+                                               URG_FRAMING_ERROR);
+            }
+        }
+        last_p = &frame[frame_size - 1];
+    }
+
+    if (type == URG_STOP) {
+        // \~japanese QT 応答の場合は、正常応答として処理する
+        // \~english If received QT response, return as successful
+        connection_consume(&urg->connection, frame_size);
+        if (p == last_p) {
+            return 0;
+        } else {
+            return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+        }
+    }
+
+    if (urg->specified_scan_times != 1) {
+        if (!strncmp(buffer, "00", 2)) {
+            // \~japanese "00" 応答の場合は、エコーバック応答とみなし、次のデータを返す
+            // \~english If received "00" response, assumes it is the echoback and returns the next data
+            connection_consume(&urg->connection, frame_size);
+            if (p != last_p) {
+                ignore_receive_data_with_qt(urg, urg->timeout);
+                return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+            } else {
+                return receive_frame_data(urg, data, length_type,
+                                          intensity, time_stamp);
+            }
         }
     }
+
+    if (!is_data) {
+        if (urg->error_handler) {
+            type = urg->error_handler(buffer, urg);
+        }
+        return drop_frame_and_return(urg, frame_size, URG_INVALID_RESPONSE);
+    }
+
+    ret = decode_frame_body(urg, type, p, last_p,
+                            data, length_type, intensity, time_stamp);
+    if (ret < 0) {
+        return resync_frame_and_return(urg, frame_size, ret);
+    }
+    connection_consume(&urg->connection, frame_size);
+
+    update_remain_times(urg);
+    return ret;
+}
+
+
+//! \~japanese 距離データの取得  \~english Gets measurement data
+static int receive_data(urg_t *urg, void *data, length_type_t length_type,
+                        unsigned short intensity[], long *time_stamp)
+{
+    if (!urg->is_active) {
+        return set_errno_and_return(urg, URG_NOT_CONNECTED);
+    }
+
+    if ((urg->receive_mode == URG_RECEIVE_FRAME) ||
+        (urg->receive_mode == URG_RECEIVE_EXACT_FRAME)) {
+        return receive_frame_data(urg, data, length_type,
+                                  intensity, time_stamp);
+    } else {
+        return receive_line_data(urg, data, length_type,
+                                 intensity, time_stamp);
+    }
+}
+
+
+// \~japanese 揃った応答 [frame, last_p) のエコーバックとステータスを解析する
+// \~japanese 計測データを含むときは 1 を返し、タイムスタンプ行の先頭を *body に格納する。含まないときは 0 を返す
+// \~english Parses the echoback and the status of the complete response [frame, last_p)
+// \~english Returns 1 with the start of the timestamp line in *body if it has measurement data, or 0 otherwise
+static int parse_frame_header(urg_t *urg, const char *frame, const char *last_p,
+                              urg_measurement_type_t *type, const char **body)
+{
+    char buffer[BUFFER_SIZE];
+    const char *p = frame;
+    const char *line_end;
+    int is_continuous;
+    int n;
+
+    // \~japanese エコーバックの解析
+    // \~english Checks the echoback
+    line_end = memchr(p, '\n', last_p - p);
+    n = line_end ? (int)(line_end - p) : 0;
+    if ((n <= 0) || (n >= BUFFER_SIZE)) {
+        return URG_INVALID_RESPONSE;
+    }
+    memcpy(buffer, p, n);
+    buffer[n] = '\0';
+    *type = parse_distance_echoback(urg, buffer);
+    if ((*type == URG_STOP) || (*type == URG_UNKNOWN)) {
+        return 0;
+    }
+    is_continuous = ((buffer[0] == 'M') || (buffer[0] == 'N'));
+    p = line_end + 1;
+
+    // \~japanese 応答の解析
+    // \~english Checks the response message
+    line_end = memchr(p, '\n', last_p - p);
+    n = line_end ? (int)(line_end - p) : 0;
+    if (n != 3) {
+        return URG_INVALID_RESPONSE;
+    }
+    if (p[n - 1] != scip_checksum(p, n - 1)) {
+        return URG_CHECKSUM_ERROR;
+    }
+    if (is_continuous && !strncmp(p, "00", 2)) {
+        // \~japanese Mx, Nx の計測開始の応答
+        // \~english Response that starts a Mx, Nx measurement
+        return 0;
+    }
+    if (strncmp(p, is_continuous ? "99" : "00", 2)) {
+        return URG_INVALID_RESPONSE;
+    }
+
+    *body = line_end + 1;
+    return 1;
+}
+
+
+// \~japanese 記録した応答 [frame, last_p) を、urg のセンサパラメータだけを複製したデコード専用の状態 context でデコードする
+// \~japanese エコーバックの受信範囲は context に格納され、urg は変更しない
+// \~english Decodes the stored response [frame, last_p) with context, a decoding-only state holding only the sensor parameters of urg
+// \~english The step range of the echoback is stored in context, and urg is not modified
+static int decode_stored_frame(urg_t *context, const urg_t *urg,
+                               const char *frame, const char *last_p,
+                               urg_measurement_type_t *type,
+                               void *data, length_type_t length_type,
+                               unsigned short intensity[], long *time_stamp)
+{
+    const char *body;
+    int ret;
+
+    // \~japanese デコードする範囲と有効ビットは、計測中の urg のものを適用しない
+    // \~english The decode regions and the validity mask of the measuring urg are not applied
+    memset(context, 0, sizeof(*context));
+    context->front_data_index = urg->front_data_index;
+    context->min_distance = urg->min_distance;
+
+    ret = parse_frame_header(context, frame, last_p, type, &body);
+    if (ret > 0) {
+        ret = decode_frame_body(context, *type, body, last_p,
+                                data, length_type, intensity, time_stamp);
+    }
+    return ret;
+}
+
+
+// \~japanese 揃った応答 [frame, last_p) を解析し、デコードした step の個数を返す
+// \~japanese 計測データを含まない応答のときは 0 を返す
+// \~english Parses the complete response [frame, last_p) and returns the number of decoded steps
+// \~english Returns 0 for a response without measurement data
+static int parse_frame(urg_parser_t *parser,
+                       const char *frame, const char *last_p)
+{
+    urg_t context;
+    urg_measurement_type_t type = URG_UNKNOWN;
+    void *data = parser->data;
+    length_type_t length_type = LENGTH_LONG;
+    unsigned short *intensity = parser->intensity;
+    int ret;
+
+    if (parser->data_uint32) {
+        data = parser->data_uint32;
+        length_type = LENGTH_UINT32;
+    } else if (parser->data_uint16) {
+        data = parser->data_uint16;
+        length_type = LENGTH_UINT16;
+    } else if (parser->planes) {
+        data = parser->planes;
+        length_type = LENGTH_PLANES;
+    }
+
+    ret = decode_stored_frame(&context, parser->urg, frame, last_p, &type,
+                              data, length_type, intensity,
+                              &parser->time_stamp);
+    if ((ret != 0) && (type != URG_UNKNOWN)) {
+        parser->type = type;
+        parser->first_index = context.received_first_index;
+        parser->last_index = context.received_last_index;
+        parser->skip_step = context.received_skip_step;
+    }
     return ret;
 }
 
 
+// \~japanese [p, last_p) の全ての行のチェックサムを評価する
+// \~english Validates the checksum of every line in [p, last_p)
+static int validate_frame_lines(const char *p, const char *last_p)
+{
+    while (p < last_p) {
+        const char *line_end = memchr(p, '\n', last_p - p);
+        int n;
+
+        if (!line_end) {
+            line_end = last_p;
+        }
+        n = (int)(line_end - p);
+        if (n <= 0) {
+            return URG_INVALID_RESPONSE;
+        }
+        if (p[n - 1] != scip_checksum(p, n - 1)) {
+            return URG_CHECKSUM_ERROR;
+        }
+        p = line_end + 1;
+    }
+    return 0;
+}
+
+
+// \~japanese 計測データの応答をデコードせずに frame に複製し、そのバイト数を返す
+// \~english Copies the response with measurement data to frame without decoding it, and returns its size
+static int receive_raw_frame(urg_t *urg, char frame[], int max_size,
+                             urg_measurement_type_t *type, long *time_stamp)
+{
+    urg_measurement_type_t frame_type = URG_UNKNOWN;
+    const char *body = NULL;
+    char *received;
+    int frame_size;
+    int ret;
+    int extended_timeout = urg->timeout
+        + 2 * (urg->scan_usec * (urg->scanning_skip_scan) / 1000);
+
+    frame_size = connection_peek_frame(&urg->connection, &received,
+                                       extended_timeout);
+    if (frame_size == URG_CONNECTION_OVERFLOW) {
+        ignore_receive_data_with_qt(urg, urg->timeout);
+        return set_errno_and_return(urg, URG_RECEIVE_ERROR);
+    } else if (frame_size <= 0) {
+        return set_errno_and_return(urg, URG_NO_RESPONSE);
+    }
+
+    ret = parse_frame_header(urg, received, &received[frame_size - 1],
+                             &frame_type, &body);
+    if (ret > 0) {
+        ret = validate_frame_lines(body, &received[frame_size - 1]);
+    } else if (ret == 0) {
+        connection_consume(&urg->connection, frame_size);
+        if (frame_type == URG_STOP) {
+            // \~japanese QT 応答の場合は、正常応答として処理する
+            // \~english If received QT response, return as successful
+            return 0;
+        } else if (frame_type != URG_UNKNOWN) {
+            // \~japanese 計測開始の応答の場合は、次のデータを返す
+            // \~english If received the response that starts the measurement, returns the next data
+            return receive_raw_frame(urg, frame, max_size, type, time_stamp);
+        }
+        ignore_receive_data_with_qt(urg, urg->timeout);
+        return set_errno_and_return(urg, URG_INVALID_RESPONSE);
+    }
+    if (ret < 0) {
+        return resync_frame_and_return(urg, frame_size, ret);
+    }
+
+    if (type) {
+        *type = frame_type;
+    }
+    if (time_stamp && (body[0] != '\n')) {
+        *time_stamp = urg_scip_decode(body, 4);
+    }
+    if (frame_size > max_size) {
+        // \~japanese 応答は受信バッファに残し、大きな frame で再度受け取れるようにする
+        // \~english The response is left in the receive buffer, so that it can be received again with a larger frame
+        return frame_size;
+    }
+
+    memcpy(frame, received, frame_size);
+    connection_consume(&urg->connection, frame_size);
+    update_remain_times(urg);
+
+    return frame_size;
+}
+
+
+void urg_parser_initialize(urg_parser_t *parser, const urg_t *urg,
+                           char buffer[], int buffer_size,
+                           long data[], unsigned short intensity[])
+{
+    urg_scip_decoder_initialize();
+
+    parser->urg = urg;
+    parser->buffer = buffer;
+    parser->buffer_size = buffer_size;
+    parser->filled = 0;
+    parser->is_overflow = URG_FALSE;
+    parser->last_ch = '\0';
+    parser->data = data;
+    parser->data_uint32 = NULL;
+    parser->data_uint16 = NULL;
+    parser->planes = NULL;
+    parser->intensity = intensity;
+    parser->type = URG_UNKNOWN;
+    parser->time_stamp = 0;
+    parser->first_index = 0;
+    parser->last_index = 0;
+    parser->skip_step = 0;
+    parser->scan_handler = NULL;
+    parser->user_data = NULL;
+}
+
+
+void urg_parser_initialize_uint32(urg_parser_t *parser, const urg_t *urg,
+                                  char buffer[], int buffer_size,
+                                  uint32_t data[], unsigned short intensity[])
+{
+    urg_parser_initialize(parser, urg, buffer, buffer_size, NULL, intensity);
+    parser->data_uint32 = data;
+}
+
+
+void urg_parser_initialize_uint16(urg_parser_t *parser, const urg_t *urg,
+                                  char buffer[], int buffer_size,
+                                  uint16_t data[])
+{
+    urg_parser_initialize(parser, urg, buffer, buffer_size, NULL, NULL);
+    parser->data_uint16 = data;
+}
+
+
+void urg_parser_initialize_planes(urg_parser_t *parser, const urg_t *urg,
+                                  char buffer[], int buffer_size,
+                                  urg_multiecho_planes_t *planes)
+{
+    urg_parser_initialize(parser, urg, buffer, buffer_size, NULL, NULL);
+    parser->planes = planes;
+}
+
+
+int urg_parser_feed(urg_parser_t *parser, const char data[], int size)
+{
+    const char *p = data;
+    const char *last_p = data + size;
+    int handled_times = 0;
+
+    while (p < last_p) {
+        const char *frame_end = NULL;
+        const char *lf;
+        int n;
+
+        if ((parser->filled == 0) && !parser->is_overflow) {
+            // \~japanese 応答の間の空行は読み捨てる
+            // \~english Skips empty lines between responses
+            while ((p < last_p) && (*p == '\n')) {
+                ++p;
+            }
+            if (p == last_p) {
+                break;
+            }
+        }
+
+        // \~japanese 応答の終端 (LF LF) を探す。前回の最後の文字も考慮する
+        // \~english Looks for the end of the response (LF LF), including the last character of the previous call
+        lf = p;
+        while ((lf = memchr(lf, '\n', last_p - lf)) != NULL) {
+            char previous_ch = (lf > p) ? lf[-1] : parser->last_ch;
+            ++lf;
+            if (previous_ch == '\n') {
+                frame_end = lf;
+                break;
+            }
+        }
+
+        // \~japanese 応答を buffer に溜める。収まらないときは終端まで読み捨てる
+        // \~english Stores the response in buffer, or skips it up to its end if it does not fit
+        n = (int)((frame_end ? frame_end : last_p) - p);
+        if (!parser->is_overflow) {
+            if (parser->filled + n > parser->buffer_size) {
+                parser->is_overflow = URG_TRUE;
+            } else {
+                memcpy(&parser->buffer[parser->filled], p, n);
+                parser->filled += n;
+            }
+        }
+        p += n;
+        parser->last_ch = p[-1];
+        if (!frame_end) {
+            break;
+        }
+
+        // \~japanese 揃った応答を解析する
+        // \~english Parses the complete response
+        if (parser->is_overflow) {
+            n = URG_RECEIVE_ERROR;
+        } else {
+            n = parse_frame(parser, parser->buffer,
+                            &parser->buffer[parser->filled - 1]);
+        }
+        parser->filled = 0;
+        parser->is_overflow = URG_FALSE;
+        parser->last_ch = '\0';
+
+        if (n != 0) {
+            if (parser->scan_handler) {
+                parser->scan_handler(parser, n, parser->user_data);
+            }
+            ++handled_times;
+        }
+    }
+    return handled_times;
+}
+
+
 int urg_open(urg_t *urg, urg_connection_type_t connection_type,
              const char *device_or_address, long baudrate_or_port)
 {
+    return urg_open_with_option(urg, connection_type, device_or_address,
+                                baudrate_or_port, NULL);
+}
+
+
+// \~japanese センサに接続する。cache が NULL でなければ、接続情報のキャッシュを使い、更新する
+// \~english Connects to the sensor. If cache is not NULL, the cache of connection information is used and updated
+static int open_sensor(urg_t *urg, urg_connection_type_t connection_type,
+                       const char *device_or_address, long baudrate_or_port,
+                       const urg_connection_option_t *option,
+                       urg_cache_t *cache)
+{
+    urg_cache_entry_t *entry = NULL;
+    char serial_id[URG_CACHE_SERIAL_ID_SIZE];
     int ret;
     long baudrate = baudrate_or_port;
 
+    urg_scip_decoder_initialize();
+
     urg->is_active = URG_FALSE;
     urg->is_sending = URG_TRUE;
     urg->last_errno = URG_NOT_CONNECTED;
     urg->timeout = MAX_TIMEOUT;
     urg->scanning_skip_scan = 0;
+    urg->receive_mode = URG_RECEIVE_LINE;
+    urg->expected_frame_size = 0;
     urg->error_handler = NULL;
+    urg->decode_regions = NULL;
+    urg->decode_region_count = 0;
+    urg->validity_mask = NULL;
+    urg->validity_mask_size = 0;
+    urg->is_resync_mode = URG_FALSE;
+    urg->dropped_frame_count = 0;
+    urg->baudrate_settle_msec = 0;
+    urg->command_response = NULL;
+    urg->command_response_lines = URG_INVALID_PARAMETER;
+    urg->is_command_pending = URG_FALSE;
+    urg->command_deadline = 0;
 
     // \~japanese �f�o�C�X�ւ̐ڑ�
     // \~english Connects to the device
-    ret = connection_open(&urg->connection, connection_type,
-                          device_or_address, baudrate_or_port);
+    ret = connection_open_with_option(&urg->connection, connection_type,
+                                      device_or_address, baudrate_or_port,
+                                      option);
 
     if (ret < 0) {
         switch (connection_type) {
@@ -791,15 +2463,43 @@ int urg_open(urg_t *urg, urg_connection_type_t connection_type,
         return urg->last_errno;
     }
 
+    if (cache) {
+        // \~japanese 値が無効な接続情報は無いものとして、ボーレートの探索と PP の受信をやり直す
+        // \~english An entry with invalid values is treated as missing, and the baudrate probe and PP are redone
+        entry = urg_cache_find(cache, device_or_address);
+        if (entry && !urg_cache_is_valid(entry)) {
+            entry = NULL;
+        }
+    }
+
     // \~japanese  �w�肵���{�[���[�g�� URG �ƒʐM�ł���悤�ɒ���
     // \~english Make adjustments so to connect with URG using the specified baudrate
     if (connection_type == URG_ETHERNET) {
         // \~japanese  Ethernet �̂Ƃ��͉��̒ʐM���x���w�肵�Ă���
         // \~english In case of Ethernet, sets a fake baudrate
         baudrate = 115200;
-    }
 
-    ret = connect_urg_device(urg, baudrate);
+        // \~japanese  ボーレートを探索せずに接続し、できなかったときだけ探索する
+        // \~english Connects without probing the baudrate, and probes only if that fails
+        ret = connect_urg_directly(urg);
+        if (ret != URG_NO_ERROR) {
+            ret = connect_urg_device(urg, baudrate);
+        }
+    } else {
+        ret = URG_NOT_DETECT_BAUDRATE_ERROR;
+        if (entry && (entry->baudrate > 0)) {
+            // \~japanese  前回接続できたボーレートで、探索せずに接続する
+            // \~english Connects with the last working baudrate, without probing
+            connection_set_baudrate(&urg->connection, entry->baudrate);
+            ret = connect_urg_directly(urg);
+            if (ret == URG_NO_ERROR) {
+                ret = change_sensor_baudrate(urg, entry->baudrate, baudrate);
+            }
+        }
+        if (ret != URG_NO_ERROR) {
+            ret = connect_urg_device(urg, baudrate);
+        }
+    }
     if (ret != URG_NO_ERROR) {
         return set_errno_and_return(urg, ret);
     }
@@ -815,7 +2515,29 @@ int urg_open(urg_t *urg, urg_connection_type_t connection_type,
 
     // \~japanese  �p�����[�^�����擾
     // \~english Gets the sensor parameters
-    ret = receive_parameter(urg);
+    if (!cache) {
+        ret = receive_parameter(urg);
+    } else {
+        // \~japanese  シリアル番号が記録と一致するときは、記録したパラメータを使う
+        // \~english If the serial id matches the recorded one, the recorded parameters are used
+        ret = receive_serial_id(urg, serial_id, URG_CACHE_SERIAL_ID_SIZE);
+        if (ret == URG_NO_ERROR) {
+            if (entry && !strcmp(entry->serial_id, serial_id)) {
+                load_cached_parameter(urg, entry);
+            } else {
+                ret = receive_parameter(urg);
+            }
+        }
+        if (ret == URG_NO_ERROR) {
+            entry = urg_cache_entry(cache, device_or_address);
+            if (entry) {
+                strcpy(entry->serial_id, serial_id);
+                entry->baudrate =
+                    (connection_type == URG_SERIAL) ? baudrate : 0;
+                store_cached_parameter(urg, entry);
+            }
+        }
+    }
     if (ret == URG_NO_ERROR) {
         urg->is_active = URG_TRUE;
     }
@@ -823,6 +2545,25 @@ int urg_open(urg_t *urg, urg_connection_type_t connection_type,
 }
 
 
+int urg_open_with_option(urg_t *urg, urg_connection_type_t connection_type,
+                         const char *device_or_address, long baudrate_or_port,
+                         const urg_connection_option_t *option)
+{
+    return open_sensor(urg, connection_type, device_or_address,
+                       baudrate_or_port, option, NULL);
+}
+
+
+int urg_open_with_cache(urg_t *urg, urg_connection_type_t connection_type,
+                        const char *device_or_address, long baudrate_or_port,
+                        const urg_connection_option_t *option,
+                        urg_cache_t *cache)
+{
+    return open_sensor(urg, connection_type, device_or_address,
+                       baudrate_or_port, option, cache);
+}
+
+
 void urg_close(urg_t *urg)
 {
     if (urg->is_active) {
@@ -839,6 +2580,35 @@ void urg_set_timeout_msec(urg_t *urg, int msec)
 }
 
 
+int urg_set_receive_mode(urg_t *urg, urg_receive_mode_t mode)
+{
+    if ((mode != URG_RECEIVE_LINE) && (mode != URG_RECEIVE_FRAME) &&
+        (mode != URG_RECEIVE_EXACT_FRAME)) {
+        return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+    }
+    urg->receive_mode = mode;
+    return 0;
+}
+
+
+void urg_set_resync_mode(urg_t *urg, int is_enabled)
+{
+    urg->is_resync_mode = is_enabled;
+}
+
+
+long urg_dropped_frame_count(const urg_t *urg)
+{
+    return urg->dropped_frame_count;
+}
+
+
+int urg_baudrate_settle_msec(const urg_t *urg)
+{
+    return urg->baudrate_settle_msec;
+}
+
+
 int urg_start_time_stamp_mode(urg_t *urg)
 {
     const int expected[] = { 0, EXPECTED_END };
@@ -961,6 +2731,47 @@ static int send_distance_command(urg_t *urg, int scan_times, int skip_scan,
 }
 
 
+// \~japanese 計測データの応答のバイト数を返す。マルチエコーのときはバイト数が決まらないため 0 を返す
+// \~japanese #URG_RECEIVE_EXACT_FRAME でのマルチエコーの計測は urg_start_measurement() が受け付けない
+// \~english Returns the byte length of the measurement response, or 0 for multiecho whose length is not fixed
+// \~english urg_start_measurement() rejects multiecho measurements with #URG_RECEIVE_EXACT_FRAME
+static int expected_frame_size(const urg_t *urg, urg_measurement_type_t type)
+{
+    int skip_step = (urg->scanning_skip_step > 1) ? urg->scanning_skip_step : 1;
+    int step_count =
+        (urg->scanning_last_step - urg->scanning_first_step) / skip_step + 1;
+    int data_size = 3;
+    int echoback_size;
+
+    switch (type) {
+    case URG_DISTANCE:
+        if (urg->range_data_byte == URG_COMMUNICATION_2_BYTE) {
+            data_size = 2;
+        }
+        break;
+
+    case URG_DISTANCE_INTENSITY:
+        data_size *= 2;
+        break;
+
+    default:
+        return 0;
+    }
+    data_size *= step_count;
+
+    // \~japanese Gx は "GD" + 開始 + 終了 + まとめる数、Mx はさらに間引き数と残り回数が続く
+    // \~english Gx echoes "GD" + first + last + grouping, Mx adds the skip count and the remaining times
+    echoback_size = (urg->scanning_remain_times == 1) ? 12 : 15;
+
+    // \~japanese エコーバック、ステータス、タイムスタンプ、64 バイトごとに
+    // \~japanese チェックサムと LF が付くデータ、最後の空行
+    // \~english Echoback, status, timestamp, data with a checksum and LF per
+    // \~english 64 bytes, and the final empty line
+    return (echoback_size + 1) + (3 + 1) + (4 + 1 + 1)
+        + data_size + 2 * ((data_size + 63) / 64) + 1;
+}
+
+
 int urg_start_measurement(urg_t *urg, urg_measurement_type_t type,
                           int scan_times, int skip_scan)
 {
@@ -976,6 +2787,13 @@ int urg_start_measurement(urg_t *urg, urg_measurement_type_t type,
         return set_errno_and_return(urg, URG_INVALID_PARAMETER);
     }
 
+    // \~japanese マルチエコーの応答はバイト数が決まらないため、求めたバイト数では受信できない
+    // \~english Multiecho responses have no fixed byte length, so they cannot be received by a computed length
+    if ((urg->receive_mode == URG_RECEIVE_EXACT_FRAME) &&
+        ((type == URG_MULTIECHO) || (type == URG_MULTIECHO_INTENSITY))) {
+        return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+    }
+
     // \~japanese  !!! Mx �n, Nx �n�̌v�����̂Ƃ��́AQT �𔭍s���Ă���
     // \~japanese  !!! �v���J�n�R�}���h�𑗐M����悤�ɂ���
     // \~japanese  !!! �������AMD �v������ MD �𔭍s����悤�ɁA�����R�}���h�̏ꍇ��
@@ -1019,16 +2837,15 @@ int urg_start_measurement(urg_t *urg, urg_measurement_type_t type,
         break;
     }
 
+    urg->expected_frame_size = (ret == 0) ? expected_frame_size(urg, type) : 0;
+
     return ret;
 }
 
 
 int urg_get_distance(urg_t *urg, long data[], long *time_stamp)
 {
-    if (!urg->is_active) {
-        return set_errno_and_return(urg, URG_NOT_CONNECTED);
-    }
-    return receive_data(urg, data, NULL, time_stamp);
+    return receive_data(urg, data, LENGTH_LONG, NULL, time_stamp);
 }
 
 
@@ -1036,21 +2853,13 @@ int urg_get_distance_intensity(urg_t *urg,
                                long data[], unsigned short intensity[],
                                long *time_stamp)
 {
-    if (!urg->is_active) {
-        return set_errno_and_return(urg, URG_NOT_CONNECTED);
-    }
-
-    return receive_data(urg, data, intensity, time_stamp);
+    return receive_data(urg, data, LENGTH_LONG, intensity, time_stamp);
 }
 
 
 int urg_get_multiecho(urg_t *urg, long data_multi[], long *time_stamp)
 {
-    if (!urg->is_active) {
-        return set_errno_and_return(urg, URG_NOT_CONNECTED);
-    }
-
-    return receive_data(urg, data_multi, NULL, time_stamp);
+    return receive_data(urg, data_multi, LENGTH_LONG, NULL, time_stamp);
 }
 
 
@@ -1058,12 +2867,127 @@ int urg_get_multiecho_intensity(urg_t *urg,
                                 long data_multi[],
                                 unsigned short intensity_multi[],
                                 long *time_stamp)
+{
+    return receive_data(urg, data_multi, LENGTH_LONG,
+                        intensity_multi, time_stamp);
+}
+
+
+int urg_get_distance_uint32(urg_t *urg, uint32_t data[], long *time_stamp)
+{
+    return receive_data(urg, data, LENGTH_UINT32, NULL, time_stamp);
+}
+
+
+int urg_get_distance_intensity_uint32(urg_t *urg, uint32_t data[],
+                                      unsigned short intensity[],
+                                      long *time_stamp)
+{
+    return receive_data(urg, data, LENGTH_UINT32, intensity, time_stamp);
+}
+
+
+int urg_get_multiecho_uint32(urg_t *urg, uint32_t data_multi[],
+                             long *time_stamp)
+{
+    return receive_data(urg, data_multi, LENGTH_UINT32, NULL, time_stamp);
+}
+
+
+int urg_get_multiecho_intensity_uint32(urg_t *urg, uint32_t data_multi[],
+                                       unsigned short intensity_multi[],
+                                       long *time_stamp)
+{
+    return receive_data(urg, data_multi, LENGTH_UINT32,
+                        intensity_multi, time_stamp);
+}
+
+
+int urg_get_distance_uint16(urg_t *urg, uint16_t data[], long *time_stamp)
+{
+    return receive_data(urg, data, LENGTH_UINT16, NULL, time_stamp);
+}
+
+
+int urg_get_raw_frame(urg_t *urg, char frame[], int max_size,
+                      urg_measurement_type_t *type, long *time_stamp)
 {
     if (!urg->is_active) {
         return set_errno_and_return(urg, URG_NOT_CONNECTED);
     }
+    return receive_raw_frame(urg, frame, max_size, type, time_stamp);
+}
+
+
+// \~japanese 記録した応答 frame をデコードする。urg はセンサパラメータを読むだけで変更しない
+// \~english Decodes the stored response frame. urg is only read for the sensor parameters and is not modified
+static int decode_raw_frame(const urg_t *urg,
+                            const char frame[], int frame_size,
+                            void *data, length_type_t length_type,
+                            unsigned short intensity[], long *time_stamp)
+{
+    // \~japanese エコーバックの受信範囲を書き込むための、デコード専用の状態
+    // \~english Decoding-only state which receives the step range of the echoback
+    urg_t context;
+    urg_measurement_type_t type;
+
+    if ((frame_size < 2) || (frame[frame_size - 1] != '\n')) {
+        return URG_INVALID_RESPONSE;
+    }
+    return decode_stored_frame(&context, urg, frame, &frame[frame_size - 1],
+                               &type, data, length_type, intensity,
+                               time_stamp);
+}
+
+
+int urg_decode_raw_frame(const urg_t *urg, const char frame[], int frame_size,
+                         long data[], unsigned short intensity[],
+                         long *time_stamp)
+{
+    return decode_raw_frame(urg, frame, frame_size, data, LENGTH_LONG,
+                            intensity, time_stamp);
+}
+
+
+int urg_decode_raw_frame_uint32(const urg_t *urg,
+                                const char frame[], int frame_size,
+                                uint32_t data[], unsigned short intensity[],
+                                long *time_stamp)
+{
+    return decode_raw_frame(urg, frame, frame_size, data, LENGTH_UINT32,
+                            intensity, time_stamp);
+}
+
+
+int urg_decode_raw_frame_uint16(const urg_t *urg,
+                                const char frame[], int frame_size,
+                                uint16_t data[], long *time_stamp)
+{
+    return decode_raw_frame(urg, frame, frame_size, data, LENGTH_UINT16,
+                            NULL, time_stamp);
+}
+
+
+int urg_decode_raw_frame_planes(const urg_t *urg,
+                                const char frame[], int frame_size,
+                                urg_multiecho_planes_t *planes,
+                                long *time_stamp)
+{
+    if (!planes) {
+        return URG_INVALID_PARAMETER;
+    }
+    return decode_raw_frame(urg, frame, frame_size, planes, LENGTH_PLANES,
+                            NULL, time_stamp);
+}
+
 
-    return receive_data(urg, data_multi, intensity_multi, time_stamp);
+int urg_get_multiecho_planes(urg_t *urg, urg_multiecho_planes_t *planes,
+                             long *time_stamp)
+{
+    if (!planes) {
+        return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+    }
+    return receive_data(urg, planes, LENGTH_PLANES, NULL, time_stamp);
 }
 
 
@@ -1088,7 +3012,7 @@ int urg_stop_measurement(urg_t *urg)
     for (i = 0; i < MAX_READ_TIMES; ++i) {
         // \~japanese QT �̉������Ԃ����܂ŁA�����f�[�^��ǂݎ̂Ă�
         // \~english Skips measuement data until QT response is received
-        ret = receive_data(urg, NULL, NULL, NULL);
+        ret = receive_data(urg, NULL, LENGTH_LONG, NULL, NULL);
         if (ret == URG_NO_ERROR) {
             // \~japanese ���퉞��
 	    // \~english Correct response
@@ -1121,14 +3045,48 @@ int urg_set_scanning_parameter(urg_t *urg, int first_step, int last_step,
 }
 
 
-int urg_set_connection_data_size(urg_t *urg,
-                                 urg_range_data_byte_t data_byte)
+int urg_set_decode_regions(urg_t *urg, const urg_step_region_t regions[],
+                           int region_count)
+{
+    int i;
+
+    if ((region_count < 0) || ((region_count > 0) && !regions)) {
+        return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+    }
+    for (i = 0; i < region_count; ++i) {
+        if (regions[i].first_step > regions[i].last_step) {
+            return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+        }
+    }
+
+    urg->decode_regions = regions;
+    urg->decode_region_count = region_count;
+
+    return set_errno_and_return(urg, URG_NO_ERROR);
+}
+
+
+int urg_set_validity_mask(urg_t *urg, uint32_t mask[], int max_data_size)
+{
+    if ((max_data_size < 0) || ((max_data_size > 0) && !mask)) {
+        return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+    }
+
+    urg->validity_mask = (max_data_size > 0) ? mask : NULL;
+    urg->validity_mask_size = max_data_size;
+
+    return set_errno_and_return(urg, URG_NO_ERROR);
+}
+
+
+int urg_set_communication_data_size(urg_t *urg,
+                                    urg_range_data_byte_t data_byte)
 {
     if (!urg->is_active) {
         return set_errno_and_return(urg, URG_NOT_CONNECTED);
     }
 
-    if ((data_byte != URG_COMMUNICATION_3_BYTE) ||
+    if ((data_byte != URG_COMMUNICATION_3_BYTE) &&
         (data_byte != URG_COMMUNICATION_2_BYTE)) {
         return set_errno_and_return(urg, URG_DATA_SIZE_PARAMETER_ERROR);
     }
@@ -1224,171 +3182,281 @@ int urg_is_stable(urg_t *urg)
 }
 
 
-static char *copy_token(char *dest, char *receive_buffer,
-                        const char *start_str, const char *end_ch, int lines)
+// \~japanese VV, II の応答の項目と、urg_sensor_info_t での格納先
+// \~english Fields of the VV and II responses, and where urg_sensor_info_t stores them
+typedef struct
 {
-    size_t start_str_len = strlen(start_str);
-    size_t end_ch_len = strlen(end_ch);
-    int i;
-    size_t j;
+    const char *tag;
+    const char *end_chars;
+    size_t offset;
+} sensor_info_field_t;
+
+static const sensor_info_field_t vv_fields[] = {
+    { "VEND:", ";", offsetof(urg_sensor_info_t, vendor) },
+    { "PROD:", ";", offsetof(urg_sensor_info_t, product_type) },
+    { "FIRM:", " (;", offsetof(urg_sensor_info_t, firmware_version) },
+    { "PROT:", ";", offsetof(urg_sensor_info_t, protocol_version) },
+    { "SERI:", ";", offsetof(urg_sensor_info_t, serial_id) },
+};
 
-    for (j = 0; j < end_ch_len; ++j) {
-        const char *p = receive_buffer;
+static const sensor_info_field_t ii_fields[] = {
+    { "MODL:", ";", offsetof(urg_sensor_info_t, model) },
+    { "LASR:", ";", offsetof(urg_sensor_info_t, laser_state) },
+    { "SCSP:", ";", offsetof(urg_sensor_info_t, motor_speed) },
+    { "MESM:", ";", offsetof(urg_sensor_info_t, state) },
+    { "SBPS:", ";", offsetof(urg_sensor_info_t, bitrate) },
+    { "TIME:", ";", offsetof(urg_sensor_info_t, time_stamp) },
+    { "STAT:", ";", offsetof(urg_sensor_info_t, status) },
+};
 
-        for (i = 0; i < lines; ++i) {
-            if (!strncmp(p, start_str, start_str_len)) {
 
-                char *last_p = strchr(p + start_str_len, end_ch[j]);
-                if (last_p) {
-                    *last_p = '\0';
-                    memcpy(dest, p + start_str_len,
-                           last_p - (p + start_str_len) + 1);
-                    return dest;
-                }
+// \~japanese 応答の 1 行が fields の項目なら info に格納し、1 を返す
+// \~english Stores one response line into info if it is one of fields, and returns 1
+static int store_sensor_info_line(const char *line,
+                                  const sensor_info_field_t fields[],
+                                  int field_count, urg_sensor_info_t *info)
+{
+    enum { TAG_SIZE = 5 };
+    int i;
+
+    for (i = 0; i < field_count; ++i) {
+        if (!strncmp(line, fields[i].tag, TAG_SIZE)) {
+            const char *value = line + TAG_SIZE;
+            size_t n = strcspn(value, fields[i].end_chars);
+            char *dest = (char *)info + fields[i].offset;
+            if ((value[n] == '\0') || (n >= URG_SENSOR_INFO_SIZE)) {
+                return 0;
             }
-            p += strlen(p) + 1;
+            memcpy(dest, value, n);
+            dest[n] = '\0';
+            return 1;
         }
     }
-    return NULL;
+    return 0;
 }
 
 
-static const char *receive_command_response(urg_t *urg,
-                                            char *buffer, int buffer_size,
-                                            const char* command,
-                                            int response_lines)
+// \~japanese コマンドを 1 回送信し、応答の各行を一度だけ走査して項目を格納する
+// \~english Sends the command once and stores the fields, scanning each response line once
+static int receive_sensor_info(urg_t *urg, const char *command,
+                               const sensor_info_field_t fields[],
+                               int field_count, urg_sensor_info_t *info)
 {
-    const int vv_expected[] = { 0, EXPECTED_END };
+    enum {
+        RECEIVE_BUFFER_SIZE = BUFFER_SIZE * II_RESPONSE_LINES,
+    };
+    char receive_buffer[RECEIVE_BUFFER_SIZE];
+    int expected[] = { 0, EXPECTED_END };
+    const char *p;
     int ret;
+    int i;
+    int j;
 
     if (!urg->is_active) {
-        return NOT_CONNECTED_MESSAGE;
+        return set_errno_and_return(urg, URG_NOT_CONNECTED);
     }
 
-    ret = scip_response(urg, command, vv_expected, urg->timeout,
-                        buffer, buffer_size);
-    if (ret < response_lines) {
-        return RECEIVE_ERROR_MESSAGE;
+    for (j = 0; j < field_count; ++j) {
+        ((char *)info + fields[j].offset)[0] = '\0';
     }
 
-    return NULL;
-}
-
-
-const char *urg_sensor_product_type(urg_t *urg)
-{
-    enum {
-        RECEIVE_BUFFER_SIZE = BUFFER_SIZE * VV_RESPONSE_LINES,
-    };
-    char receive_buffer[RECEIVE_BUFFER_SIZE];
-    const char *ret;
-    char *p;
-
-    ret = receive_command_response(urg, receive_buffer, RECEIVE_BUFFER_SIZE,
-                                   "VV\n", VV_RESPONSE_LINES);
-    if (ret) {
+    ret = scip_response(urg, command, expected, urg->timeout,
+                        receive_buffer, RECEIVE_BUFFER_SIZE);
+    if (ret < 0) {
         return ret;
     }
 
-    p = copy_token(urg->return_buffer,
-                   receive_buffer, "PROD:", ";", VV_RESPONSE_LINES);
-    return (p) ? p : RECEIVE_ERROR_MESSAGE;
+    p = receive_buffer;
+    for (i = 0; i < (ret - 1); ++i) {
+        store_sensor_info_line(p, fields, field_count, info);
+        p += strlen(p) + 1;
+    }
+    return set_errno_and_return(urg, URG_NO_ERROR);
 }
 
 
-const char *urg_sensor_serial_id(urg_t *urg)
+int urg_sensor_info(urg_t *urg, urg_sensor_info_t *info)
 {
-    enum {
-        RECEIVE_BUFFER_SIZE = BUFFER_SIZE * VV_RESPONSE_LINES,
-    };
-    char receive_buffer[RECEIVE_BUFFER_SIZE];
-    const char *ret;
-    char *p;
-
-    ret = receive_command_response(urg, receive_buffer, RECEIVE_BUFFER_SIZE,
-                                   "VV\n", VV_RESPONSE_LINES);
-    if (ret) {
+    int ret = receive_sensor_info(urg, "VV\n", vv_fields,
+                                  sizeof(vv_fields) / sizeof(vv_fields[0]),
+                                  info);
+    if (ret < 0) {
         return ret;
     }
+    return urg_sensor_update_status(urg, info);
+}
 
-    p = copy_token(urg->return_buffer,
-                   receive_buffer, "SERI:", ";", VV_RESPONSE_LINES);
-    return (p) ? p : RECEIVE_ERROR_MESSAGE;
+
+int urg_sensor_update_status(urg_t *urg, urg_sensor_info_t *info)
+{
+    return receive_sensor_info(urg, "II\n", ii_fields,
+                               sizeof(ii_fields) / sizeof(ii_fields[0]), info);
 }
 
 
-const char *urg_sensor_firmware_version(urg_t *urg)
+// \~japanese VV か II を受信し、offset の項目を urg->return_buffer に複製して返す
+// \~english Receives VV or II, and returns the field at offset copied to urg->return_buffer
+static const char *receive_sensor_info_field(urg_t *urg, int is_status,
+                                             size_t offset)
 {
-    enum {
-        RECEIVE_BUFFER_SIZE = BUFFER_SIZE * VV_RESPONSE_LINES,
-    };
-    char receive_buffer[RECEIVE_BUFFER_SIZE];
-    const char *ret;
-    char *p;
+    urg_sensor_info_t info;
+    const char *value = (const char *)&info + offset;
+    int ret;
 
     if (!urg->is_active) {
         return NOT_CONNECTED_MESSAGE;
     }
 
-    ret = receive_command_response(urg, receive_buffer, RECEIVE_BUFFER_SIZE,
-                                   "VV\n", VV_RESPONSE_LINES);
-    if (ret) {
-        return ret;
+    if (is_status) {
+        ret = urg_sensor_update_status(urg, &info);
+    } else {
+        ret = receive_sensor_info(urg, "VV\n", vv_fields,
+                                  sizeof(vv_fields) / sizeof(vv_fields[0]),
+                                  &info);
+    }
+    if ((ret < 0) || (value[0] == '\0')) {
+        return RECEIVE_ERROR_MESSAGE;
     }
 
-    p = copy_token(urg->return_buffer,
-                   receive_buffer, "FIRM:", " (", VV_RESPONSE_LINES);
-    return (p) ? p : RECEIVE_ERROR_MESSAGE;
+    strcpy(urg->return_buffer, value);
+    return urg->return_buffer;
 }
 
 
-const char *urg_sensor_status(urg_t *urg)
+const char *urg_sensor_product_type(urg_t *urg)
 {
-    enum {
-        RECEIVE_BUFFER_SIZE = BUFFER_SIZE * II_RESPONSE_LINES,
-    };
-    char receive_buffer[RECEIVE_BUFFER_SIZE];
-    const char *ret;
-    char *p;
+    return receive_sensor_info_field(urg, URG_FALSE,
+                                     offsetof(urg_sensor_info_t,
+                                              product_type));
+}
 
-    if (!urg->is_active) {
-        return NOT_CONNECTED_MESSAGE;
-    }
 
-    ret = receive_command_response(urg, receive_buffer, RECEIVE_BUFFER_SIZE,
-                                   "II\n", II_RESPONSE_LINES);
-    if (ret) {
-        return ret;
-    }
+const char *urg_sensor_serial_id(urg_t *urg)
+{
+    return receive_sensor_info_field(urg, URG_FALSE,
+                                     offsetof(urg_sensor_info_t, serial_id));
+}
+
+
+const char *urg_sensor_firmware_version(urg_t *urg)
+{
+    return receive_sensor_info_field(urg, URG_FALSE,
+                                     offsetof(urg_sensor_info_t,
+                                              firmware_version));
+}
+
 
-    p = copy_token(urg->return_buffer,
-                   receive_buffer, "STAT:", ";", II_RESPONSE_LINES);
-    return (p) ? p : RECEIVE_ERROR_MESSAGE;
+const char *urg_sensor_status(urg_t *urg)
+{
+    return receive_sensor_info_field(urg, URG_TRUE,
+                                     offsetof(urg_sensor_info_t, status));
 }
 
 
 const char *urg_sensor_state(urg_t *urg)
 {
-    enum {
-        RECEIVE_BUFFER_SIZE = BUFFER_SIZE * II_RESPONSE_LINES,
-    };
-    char receive_buffer[RECEIVE_BUFFER_SIZE];
-    const char *ret;
-    char *p;
+    return receive_sensor_info_field(urg, URG_TRUE,
+                                     offsetof(urg_sensor_info_t, state));
+}
+
+
+int urg_parse_sensor_info(urg_sensor_info_t *info,
+                          const char response[], int lines)
+{
+    const char *p = response;
+    int stored = 0;
+    int i;
+
+    for (i = 0; i < lines; ++i) {
+        if (store_sensor_info_line(p, vv_fields,
+                                   sizeof(vv_fields) / sizeof(vv_fields[0]),
+                                   info) ||
+            store_sensor_info_line(p, ii_fields,
+                                   sizeof(ii_fields) / sizeof(ii_fields[0]),
+                                   info)) {
+            ++stored;
+        }
+        p += strlen(p) + 1;
+    }
+    return stored;
+}
+
+
+int urg_send_command(urg_t *urg, const char *command,
+                     char response[], int max_size)
+{
+    char buffer[URG_MAX_COMMAND_SIZE];
+    int n;
 
     if (!urg->is_active) {
-        return NOT_CONNECTED_MESSAGE;
+        return set_errno_and_return(urg, URG_NOT_CONNECTED);
     }
 
-    ret = receive_command_response(urg, receive_buffer, RECEIVE_BUFFER_SIZE,
-                                   "II\n", II_RESPONSE_LINES);
-    if (ret) {
-        return ret;
+    expire_command_response(urg);
+    n = (int)strlen(command);
+    if (urg->is_command_pending || (n <= 0) ||
+        (n >= URG_MAX_COMMAND_SIZE) || !response || (max_size <= 0)) {
+        return set_errno_and_return(urg, URG_INVALID_PARAMETER);
+    }
+
+    memcpy(urg->command_echoback, command, n + 1);
+    urg->command_response = response;
+    urg->command_response_size = max_size;
+    urg->command_response_filled = 0;
+    urg->command_response_lines = 0;
+    urg->is_command_pending = URG_TRUE;
+
+    // \~japanese 連続計測中は、応答が計測データの間に返るまで COMMAND_RESPONSE_SCANS 回のスキャンを待つ
+    // \~english During the continuous measurement, waits COMMAND_RESPONSE_SCANS scans for the response to arrive between the measurement data
+    urg->command_deadline = connection_ticks() + urg->timeout
+        + COMMAND_RESPONSE_SCANS
+        * (urg->scan_usec * (urg->scanning_skip_scan + 1) / 1000);
+
+    memcpy(buffer, command, n);
+    buffer[n++] = '\n';
+    if (connection_write(&urg->connection, buffer, n) != n) {
+        finish_command_response(urg, URG_SEND_ERROR);
+        return set_errno_and_return(urg, URG_SEND_ERROR);
+    }
+
+    if (!urg->is_sending) {
+        // \~japanese 連続計測中でなければ、ここで応答を受信する
+        // \~english Without a continuous measurement, the response is received here
+        n = urg_command_response(urg);
+        if (n < 0) {
+            return set_errno_and_return(urg, n);
+        }
+    }
+    return set_errno_and_return(urg, URG_NO_ERROR);
+}
+
+
+int urg_command_response(urg_t *urg)
+{
+    enum { MAX_SKIP_LINES = 4096 };
+    char buffer[BUFFER_SIZE];
+    int i;
+
+    expire_command_response(urg);
+    if (urg->is_command_pending && !urg->is_sending) {
+        // \~japanese 連続計測中でなければ、エコーバックまでを読み飛ばして応答を受信する
+        // \~english Without a continuous measurement, skips up to the echoback and receives the response
+        for (i = 0; i < MAX_SKIP_LINES; ++i) {
+            int n = connection_readline(&urg->connection,
+                                        buffer, BUFFER_SIZE, urg->timeout);
+            if (n < 0) {
+                break;
+            } else if (!strcmp(buffer, urg->command_echoback)) {
+                receive_command_lines(urg);
+                break;
+            }
+        }
+        if (urg->is_command_pending) {
+            finish_command_response(urg, URG_NO_RESPONSE);
+        }
     }
 
-    p = copy_token(urg->return_buffer,
-                   receive_buffer, "MESM:", ";", II_RESPONSE_LINES);
-    return (p) ? p : RECEIVE_ERROR_MESSAGE;
+    return urg->is_command_pending ? 0 : urg->command_response_lines;
 }
 
 
@@ -1,74 +1,67 @@
-/*!
-  \file
-  \~japanese
-  \brief VAʐM
-  \~english
-  \brief Serial communications
-  \~
-  \author Satofumi KAMIMURA
-
-  $Id$
-*/
-
-#include "urg_serial.h"
-
-
-enum {
-    False = 0,
-    True,
-};
-
-
-#if defined(URG_WINDOWS_OS)
-#include "urg_serial_windows.c"
-#else
-#include "urg_serial_linux.c"
-#endif
-
-
-// \~japanese sǂ̔
-// \~english Checks wheter is is a EOL character
-static int is_linefeed(const char ch)
-{
-    return ((ch == '\r') || (ch == '\n')) ? 1 : 0;
-}
-
-
-static void serial_ungetc(urg_serial_t *serial, char ch)
-{
-    serial->has_last_ch = True;
-    serial->last_ch = ch;
-}
-
-
-int serial_readline(urg_serial_t *serial, char *data, int max_size, int timeout)
-{
-    /* \~japanese Pǂݏoĕ] */
-    /* \~english Reads and evaluates 1 character at a time */
-    int filled = 0;
-    int is_timeout = 0;
-
-    while (filled < max_size) {
-        char recv_ch;
-        int n = serial_read(serial, &recv_ch, 1, timeout);
-        if (n <= 0) {
-            is_timeout = 1;
-            break;
-        } else if (is_linefeed(recv_ch)) {
-            break;
-        }
-        data[filled++] = recv_ch;
-    }
-    if (filled >= max_size) {
-        --filled;
-        serial_ungetc(serial, data[filled]);
-    }
-    data[filled] = '\0';
-
-    if ((filled == 0) && is_timeout) {
-        return -1;
-    } else {
-        //fprintf(stderr, "%s\n", data);
-        return filled;
-    }
-}
+/*!
+  \file
+  \~japanese
+  \brief シリアル通信
+  \~english
+  \brief Serial communications
+  \~
+  \author Satofumi KAMIMURA
+
+  $Id$
+*/
+
+#include "urg_serial.h"
+#include "urg_connection.h"
+#include <string.h>
+
+
+#if defined(URG_WINDOWS_OS)
+#include "urg_serial_windows.c"
+#else
+#include "urg_serial_linux.c"
+#endif
+
+
+int serial_fill(urg_serial_t *serial, int size, int timeout)
+{
+    long deadline = connection_ticks() + timeout;
+    int wait_msec = timeout;
+    int filled = 0;
+
+    if (size > ring_capacity(&serial->ring)) {
+        size = ring_capacity(&serial->ring);
+    }
+
+    // \~japanese 受信途中のデータが届いても、timeout は呼び出し全体で数える
+    // \~english timeout bounds the whole call, partial arrivals do not restart it
+    while (ring_size(&serial->ring) < size) {
+        int n = serial_buffer_fill(serial, wait_msec);
+        if (n <= 0) {
+            break;
+        }
+        filled += n;
+
+        if (timeout >= 0) {
+            long remaining = deadline - connection_ticks();
+            wait_msec = (remaining > 0) ? (int)remaining : 0;
+        }
+    }
+    return filled;
+}
+
+
+// \~japanese ring_readline() から受信データを読み足す
+// \~english Reads more received data for ring_readline()
+static int serial_ring_fill(void *context, int size, int timeout)
+{
+    return serial_fill((urg_serial_t *)context, size, timeout);
+}
+
+
+int serial_readline(urg_serial_t *serial, char *data, int max_size, int timeout)
+{
+    /* \~japanese 受信済みのデータから改行を探し、１行分をまとめて取り出す */
+    /* \~english Searches the received data for the EOL and extracts the whole line at once */
+    return ring_readline(&serial->ring, data, max_size,
+                         serial_ring_fill, serial, timeout);
+}
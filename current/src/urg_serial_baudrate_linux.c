@@ -0,0 +1,54 @@
+/*!
+  \file
+  \~japanese
+  \brief Linux での任意のボーレートの設定
+  \~english
+  \brief Arbitrary baudrates on Linux
+  \~
+
+  $Id$
+*/
+
+#include "urg_detect_os.h"
+
+#if defined(URG_LINUX_OS)
+/* \~japanese <asm/termbits.h> は <termios.h> と同時に include できないため、このファイルだけで使う
+   \~english <asm/termbits.h> cannot be included together with <termios.h>, so only this file uses it */
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+
+int serial_set_arbitrary_baudrate(int fd, long baudrate)
+{
+#if defined(TCGETS2) && defined(BOTHER)
+    struct termios2 tio;
+
+    /* \~japanese ボーレート 0 は POSIX では切断を意味するため、正で speed_t に収まる値だけを受け付ける
+       \~english Baudrate 0 means hang-up on POSIX, so only positive values which fit in speed_t are accepted */
+    if ((baudrate <= 0) || ((long)(speed_t)baudrate != baudrate)) {
+        return -1;
+    }
+
+    if (ioctl(fd, TCGETS2, &tio) < 0) {
+        return -1;
+    }
+
+    /* \~japanese 入力側のボーレートは出力側と同じにする
+       \~english The input baudrate follows the output baudrate */
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER;
+    tio.c_ispeed = (speed_t)baudrate;
+    tio.c_ospeed = (speed_t)baudrate;
+    if (ioctl(fd, TCSETSW2, &tio) < 0) {
+        return -1;
+    }
+    return 0;
+#else
+    /* \~japanese termios2 の無いアーキテクチャでは Bxxx 定数のボーレートだけを使う
+       \~english Architectures without termios2 only use the baudrates of the Bxxx constants */
+    (void)fd;
+    (void)baudrate;
+    return -1;
+#endif
+}
+#endif
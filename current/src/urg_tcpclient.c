@@ -1,346 +1,474 @@
-/*!
-  \file
-  \~japanese TCP/IP ǂݍ/݁@֐ 
-  \brief
-  \~english
-  \brief TCP/IP read/write functions
-  \~
-  \author Katsumi Kimoto
-
-  $Id$
-*/
-
-// http://www.ne.jp/asahi/hishidama/home/tech/lang/socket.html
-
-#include "urg_detect_os.h"
-#include <string.h>
-#if defined(URG_WINDOWS_OS)
-#else
-#include <unistd.h>
-#include <fcntl.h>
-#include <errno.h>
-#endif
-#include "urg_tcpclient.h"
-
-#include <stdio.h>
-
-enum {
-    Invalid_desc = -1,
-};
-
-// \~japanese sǂ̔
-// \~english Checks wheter is is a EOL character
-static int is_linefeed(const char ch)
-{
-    return ((ch == '\r') || (ch == '\n')) ? 1 : 0;
-}
-
-
-static void tcpclient_buffer_init(urg_tcpclient_t* cli)
-{
-    ring_initialize(&cli->rb, cli->buf, RB_BITSHIFT);
-}
-
-
-// get number of data in buffer.
-static int tcpclient_buffer_data_num(urg_tcpclient_t* cli)
-{
-    return ring_size(&cli->rb);
-}
-
-
-static int tcpclient_buffer_write(urg_tcpclient_t* cli,
-                                  const char* data, int size)
-{
-    return ring_write(&cli->rb, data, size);
-}
-
-
-static int tcpclient_buffer_read(urg_tcpclient_t* cli, char* data, int size)
-{
-    return ring_read(&cli->rb, data, size);
-}
-
-
-static void set_block_mode(urg_tcpclient_t* cli)
-{
-#if defined(URG_WINDOWS_OS)
-    u_long flag = 0;
-    ioctlsocket(cli->sock_desc, FIONBIO, &flag);
-#else
-    int flag = 0;
-    fcntl(cli->sock_desc, F_SETFL, flag);
-#endif
-}
-
-
-int tcpclient_open(urg_tcpclient_t* cli, const char* ip_str, int port_num)
-{
-    enum { Connect_timeout_second = 2 };
-    fd_set rmask, wmask;
-    struct timeval tv = { Connect_timeout_second, 0 };
-#if defined(URG_WINDOWS_OS)
-    u_long flag;
-#else
-    int flag;
-    int sock_optval = -1;
-    int sock_optval_size = sizeof(sock_optval);
-#endif
-    int ret;
-
-    cli->sock_desc = Invalid_desc;
-    cli->pushed_back = -1; // no pushed back char.
-
-#if defined(URG_WINDOWS_OS)
-    {
-        static int is_initialized = 0;
-        WORD wVersionRequested = 0x0202;
-        WSADATA WSAData;
-        int err;
-        if (!is_initialized) {
-            err = WSAStartup(wVersionRequested, &WSAData);
-            if (err != 0) {
-                return -1;
-            }
-            is_initialized = 1;
-        }
-    }
-#endif
-
-    tcpclient_buffer_init(cli);
-
-    cli->sock_addr_size = sizeof (struct sockaddr_in);
-    if ((cli->sock_desc = (int)socket(AF_INET, SOCK_STREAM, 0)) < 0) {
-        return -1;
-    }
-
-    memset((char*)&(cli->server_addr), 0, sizeof(cli->sock_addr_size));
-    cli->server_addr.sin_family = AF_INET;
-    cli->server_addr.sin_port = htons(port_num);
-
-    if (!strcmp(ip_str, "localhost")) {
-        ip_str = "127.0.0.1";
-    }
-
-    /* bind is not required, and port number is dynamic */
-    if ((cli->server_addr.sin_addr.s_addr = inet_addr(ip_str)) == INADDR_NONE) {
-        return -1;
-    }
-
-#if defined(URG_WINDOWS_OS)
-    // \~japanese mubNɕύX
-    // \~english Configures non-blocking mode
-    flag = 1;
-    ioctlsocket(cli->sock_desc, FIONBIO, &flag);
-
-    if (connect(cli->sock_desc, (const struct sockaddr *)&(cli->server_addr),
-                cli->sock_addr_size) == SOCKET_ERROR) {
-        int error_number = WSAGetLastError();
-        if (error_number != WSAEWOULDBLOCK) {
-            tcpclient_close(cli);
-            return -1;
-        }
-
-        FD_ZERO(&rmask);
-        FD_SET((SOCKET)cli->sock_desc, &rmask);
-        wmask = rmask;
-
-        ret = select((int)cli->sock_desc + 1, &rmask, &wmask, NULL, &tv);
-        if (ret == 0) {
-            // \~japanese ^CAEg
-	    // \~english Operation timed out
-            tcpclient_close(cli);
-            return -2;
-        }
-    }
-    // \~japanese ubN[hɂ
-    // \~english Returns to blocking mode
-    set_block_mode(cli);
-
-#else
-    // \~japanese mubNɕύX
-    // \~english Configures non-blocking mode
-    flag = fcntl(cli->sock_desc, F_GETFL, 0);
-    fcntl(cli->sock_desc, F_SETFL, flag | O_NONBLOCK);
-
-    if (connect(cli->sock_desc, (const struct sockaddr *)&(cli->server_addr),
-                cli->sock_addr_size) < 0) {
-        if (errno != EINPROGRESS) {
-            tcpclient_close(cli);
-            return -1;
-        }
-
-        // \~japanese EINPROGRESS:RlNVv͎n܂A܂ĂȂ
-        // \~english EINPROGRESS: a connection request was already received and not completed yet
-        FD_ZERO(&rmask);
-        FD_SET(cli->sock_desc, &rmask);
-        wmask = rmask;
-
-        ret = select(cli->sock_desc + 1, &rmask, &wmask, NULL, &tv);
-        if (ret <= 0) {
-            // \~japanese ^CAEg
-	    // \~english Operation timed out
-            tcpclient_close(cli);
-            return -2;
-        }
-
-        if (getsockopt(cli->sock_desc, SOL_SOCKET, SO_ERROR, (int*)&sock_optval,
-                       (socklen_t*)&sock_optval_size) != 0) {
-            // \~japanese ڑɎs
-	    // \~english Connection failed
-            tcpclient_close(cli);
-            return -3;
-        }
-
-        if (sock_optval != 0) {
-            // \~japanese ڑɎs
-	    // \~english Connection failed
-            tcpclient_close(cli);
-            return -4;
-        }
-        // \~japanese ubN[hɂ
-        // \~english Returns to blocking mode
-        set_block_mode(cli);
-    }
-#endif
-
-    return 0;
-}
-
-
-void tcpclient_close(urg_tcpclient_t* cli)
-{
-    if (cli->sock_desc != Invalid_desc) {
-#if defined(URG_WINDOWS_OS)
-        closesocket(cli->sock_desc);
-        //WSACleanup();
-#else
-        close(cli->sock_desc);
-#endif
-        cli->sock_desc = Invalid_desc;
-    }
-}
-
-
-int tcpclient_read(urg_tcpclient_t* cli,
-                   char* userbuf, int req_size, int timeout)
-{
-    // number of data in buffer.
-    int num_in_buf = tcpclient_buffer_data_num(cli);
-    int sock       = cli->sock_desc;
-    int rem_size   = req_size;  // remaining size to be sent back.
-    int n;
-
-    // copy data in buffer to user buffer and return with requested size.
-    if (num_in_buf > 0) {
-        n = tcpclient_buffer_read(cli, userbuf, req_size);
-        rem_size = req_size - n;  // lacking size.
-        if (rem_size <= 0) {
-            return req_size;
-        }
-
-        num_in_buf = tcpclient_buffer_data_num(cli);
-    }
-
-    // data in buffer was not enough, read from socket to fill buffer,
-    // without blocking, i.e. read from system's buffer.
-    {
-        char tmpbuf[BUFSIZE];
-        // receive with non-blocking mode.
-#if defined(URG_WINDOWS_OS)
-        int no_timeout = 1;
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *)&no_timeout, sizeof(struct timeval));
-        n = recv(sock, tmpbuf, BUFSIZE - num_in_buf, 0);
-#else
-        n = recv(sock, tmpbuf, BUFSIZE - num_in_buf, MSG_DONTWAIT);
-#endif
-        if (n > 0) {
-            tcpclient_buffer_write(cli, tmpbuf, n); // copy socket to my buffer
-        }
-
-        n = tcpclient_buffer_read(cli, &userbuf[req_size-rem_size], rem_size);
-        // n never be greater than rem_size
-        rem_size -= n;
-        if (rem_size <= 0) {
-            return req_size;
-        }
-    }
-
-    //  lastly recv with blocking but with time out to read necessary size.
-    {
-#if defined(URG_WINDOWS_OS)
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO,
-                   (const char *)&timeout, sizeof(struct timeval));
-#else
-        struct timeval tv;
-        tv.tv_sec = timeout / 1000; // millisecond to seccond
-        tv.tv_usec = (timeout % 1000) * 1000; // millisecond to microsecond
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(struct timeval));
-#endif
-        //4th arg 0:no flag
-        n = recv(sock, &userbuf[req_size-rem_size], rem_size, 0);
-        // n never be greater than rem_size
-        if (n > 0) {
-            rem_size -= n;
-        }
-    }
-
-    return (req_size - rem_size); // last return may be less than req_size;
-}
-
-
-int tcpclient_write(urg_tcpclient_t* cli, const char* buf, int size)
-{
-    // blocking if data size is larger than system's buffer.
-    return send(cli->sock_desc, buf, size, 0);  //4th arg 0: no flag
-}
-
-
-int tcpclient_error(urg_tcpclient_t* cli, char* error_message, int max_size)
-{
-    (void)cli;
-    (void)error_message;
-    (void)max_size;
-
-    // not implemented yet.
-
-    return -1;
-}
-
-
-int tcpclient_readline(urg_tcpclient_t* cli,
-                       char* userbuf, int buf_size, int timeout)
-{
-    int n = 0;
-    int i = 0;
-
-    if (cli->pushed_back > 0) {
-        userbuf[i] = cli->pushed_back;
-        i++;
-        cli->pushed_back = -1;
-    }
-    for (; i < buf_size; ++i) {
-        char ch;
-        n = tcpclient_read(cli, &ch, 1, timeout);
-        if (n <= 0) {
-            break; // error
-        }
-        if (is_linefeed(ch)) {
-            break; // success
-        }
-        userbuf[i] = ch;
-    }
-
-    if (i >= buf_size) { // No CR or LF found.
-        --i;
-        cli->pushed_back = userbuf[buf_size - 1] & 0xff;
-        userbuf[buf_size - 1] = '\0';
-    }
-    userbuf[i] = '\0';
-
-    if (i == 0 && n <= 0) { // error
-        return -1;
-    }
-
-    return i; // the number of characters filled into user buffer.
-}
+/*!
+  \file
+  \~japanese TCP/IP 読み込み/書き込み　関数 
+  \brief
+  \~english
+  \brief TCP/IP read/write functions
+  \~
+  \author Katsumi Kimoto
+
+  $Id$
+*/
+
+// http://www.ne.jp/asahi/hishidama/home/tech/lang/socket.html
+
+#include "urg_detect_os.h"
+#include <string.h>
+#if defined(URG_WINDOWS_OS)
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+#endif
+#include "urg_tcpclient.h"
+#include "urg_connection.h"
+
+#include <stdio.h>
+
+enum {
+    Invalid_desc = -1,
+};
+
+static void tcpclient_buffer_init(urg_tcpclient_t* cli)
+{
+    ring_initialize(&cli->rb, cli->buf, RB_BITSHIFT);
+}
+
+
+// get number of data in buffer.
+static int tcpclient_buffer_data_num(urg_tcpclient_t* cli)
+{
+    return ring_size(&cli->rb);
+}
+
+
+static int tcpclient_buffer_read(urg_tcpclient_t* cli, char* data, int size)
+{
+    return ring_read(&cli->rb, data, size);
+}
+
+
+// returns the time left until deadline, -1 (no time out) if timeout < 0.
+static int tcpclient_remaining(long deadline, int timeout)
+{
+    long remaining;
+
+    if (timeout < 0) {
+        return -1;
+    }
+    remaining = deadline - connection_ticks();
+    return (remaining > 0) ? (int)remaining : 0;
+}
+
+
+// waits until socket becomes readable, at most timeout [msec].
+// returns positive if readable, 0 on time out, negative on error.
+static int tcpclient_wait(urg_tcpclient_t* cli, int timeout)
+{
+#if defined(URG_WINDOWS_OS)
+    fd_set rmask;
+    struct timeval tv;
+
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    FD_ZERO(&rmask);
+    FD_SET((SOCKET)cli->sock_desc, &rmask);
+    return select((int)cli->sock_desc + 1, &rmask, NULL, NULL,
+                  (timeout < 0) ? NULL : &tv);
+#else
+    struct pollfd fds;
+    int ret;
+
+    fds.fd = cli->sock_desc;
+    fds.events = POLLIN;
+    fds.revents = 0;
+    do {
+        ret = poll(&fds, 1, timeout);
+    } while ((ret < 0) && (errno == EINTR));
+    return ret;
+#endif
+}
+
+
+// receives from socket directly into the free area of the buffer.
+// called after tcpclient_wait(), so recv() does not block.
+static int tcpclient_buffer_recv(urg_tcpclient_t* cli)
+{
+    ring_span_t spans[2];
+    int n;
+
+    if (ring_reserve(&cli->rb, spans) <= 0) {
+        return 0;
+    }
+
+    n = recv(cli->sock_desc, spans[0].data, spans[0].size, 0);
+    if (n > 0) {
+        ring_commit(&cli->rb, n);
+    }
+    return n;
+}
+
+
+// fills buffer until at least size bytes are stored. timeout bounds the
+// whole call, partial arrivals do not restart it.
+// returns the number of received bytes.
+static int tcpclient_buffer_fill(urg_tcpclient_t* cli, int size, int timeout)
+{
+    long deadline = connection_ticks() + timeout;
+    int wait_msec = timeout;
+    int filled = 0;
+
+    if (size > ring_capacity(&cli->rb)) {
+        size = ring_capacity(&cli->rb);
+    }
+
+    while (tcpclient_buffer_data_num(cli) < size) {
+        int n;
+
+        if (tcpclient_wait(cli, wait_msec) <= 0) {
+            break;
+        }
+        n = tcpclient_buffer_recv(cli);
+        if (n <= 0) {
+            // connection closed, or error.
+            break;
+        }
+        filled += n;
+        wait_msec = tcpclient_remaining(deadline, timeout);
+    }
+    return filled;
+}
+
+
+// fill context of tcpclient_readline(), timeout bounds the whole line.
+typedef struct
+{
+    urg_tcpclient_t* cli;
+    long deadline;
+} tcpclient_readline_t;
+
+
+static int tcpclient_readline_fill(void* context, int size, int timeout)
+{
+    tcpclient_readline_t* line = (tcpclient_readline_t*)context;
+    return tcpclient_buffer_fill(line->cli, size,
+                                 tcpclient_remaining(line->deadline, timeout));
+}
+
+
+static void set_block_mode(urg_tcpclient_t* cli)
+{
+#if defined(URG_WINDOWS_OS)
+    u_long flag = 0;
+    ioctlsocket(cli->sock_desc, FIONBIO, &flag);
+#else
+    int flag = 0;
+    fcntl(cli->sock_desc, F_SETFL, flag);
+#endif
+}
+
+
+static int set_int_option(urg_tcpclient_t* cli, int level, int name, int value)
+{
+    return setsockopt(cli->sock_desc, level, name,
+                      (const char *)&value, sizeof(value));
+}
+
+
+// applies socket options. called before connect(), so that SO_RCVBUF
+// is taken into account for the TCP window.
+static int tcpclient_set_option(urg_tcpclient_t* cli,
+                                const urg_tcpclient_option_t* option)
+{
+    if (option->no_delay &&
+        (set_int_option(cli, IPPROTO_TCP, TCP_NODELAY, 1) < 0)) {
+        return -1;
+    }
+
+    if ((option->receive_buffer_size > 0) &&
+        (set_int_option(cli, SOL_SOCKET, SO_RCVBUF,
+                        option->receive_buffer_size) < 0)) {
+        return -1;
+    }
+
+    if (option->keepalive_idle > 0) {
+        if (set_int_option(cli, SOL_SOCKET, SO_KEEPALIVE, 1) < 0) {
+            return -1;
+        }
+#if defined(TCP_KEEPIDLE)
+        if (set_int_option(cli, IPPROTO_TCP, TCP_KEEPIDLE,
+                           option->keepalive_idle) < 0) {
+            return -1;
+        }
+#elif defined(TCP_KEEPALIVE)
+        // Mac OS X names the idle time TCP_KEEPALIVE.
+        if (set_int_option(cli, IPPROTO_TCP, TCP_KEEPALIVE,
+                           option->keepalive_idle) < 0) {
+            return -1;
+        }
+#endif
+#if defined(TCP_KEEPINTVL)
+        if ((option->keepalive_interval > 0) &&
+            (set_int_option(cli, IPPROTO_TCP, TCP_KEEPINTVL,
+                            option->keepalive_interval) < 0)) {
+            return -1;
+        }
+#endif
+#if defined(TCP_KEEPCNT)
+        if ((option->keepalive_count > 0) &&
+            (set_int_option(cli, IPPROTO_TCP, TCP_KEEPCNT,
+                            option->keepalive_count) < 0)) {
+            return -1;
+        }
+#endif
+    }
+
+#if defined(SO_BUSY_POLL)
+    if ((option->busy_poll > 0) &&
+        (set_int_option(cli, SOL_SOCKET, SO_BUSY_POLL,
+                        option->busy_poll) < 0)) {
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+
+void tcpclient_option_initialize(urg_tcpclient_option_t* option)
+{
+    option->no_delay = 0;
+    option->receive_buffer_size = 0;
+    option->keepalive_idle = 0;
+    option->keepalive_interval = 0;
+    option->keepalive_count = 0;
+    option->busy_poll = 0;
+}
+
+
+int tcpclient_open(urg_tcpclient_t* cli, const char* ip_str, int port_num)
+{
+    return tcpclient_open_with_option(cli, ip_str, port_num, NULL);
+}
+
+
+int tcpclient_open_with_option(urg_tcpclient_t* cli,
+                               const char* ip_str, int port_num,
+                               const urg_tcpclient_option_t* option)
+{
+    enum { Connect_timeout_second = 2 };
+    fd_set rmask, wmask;
+    struct timeval tv = { Connect_timeout_second, 0 };
+#if defined(URG_WINDOWS_OS)
+    u_long flag;
+#else
+    int flag;
+    int sock_optval = -1;
+    int sock_optval_size = sizeof(sock_optval);
+#endif
+    int ret;
+
+    cli->sock_desc = Invalid_desc;
+
+#if defined(URG_WINDOWS_OS)
+    {
+        static int is_initialized = 0;
+        WORD wVersionRequested = 0x0202;
+        WSADATA WSAData;
+        int err;
+        if (!is_initialized) {
+            err = WSAStartup(wVersionRequested, &WSAData);
+            if (err != 0) {
+                return -1;
+            }
+            is_initialized = 1;
+        }
+    }
+#endif
+
+    tcpclient_buffer_init(cli);
+
+    cli->sock_addr_size = sizeof (struct sockaddr_in);
+    if ((cli->sock_desc = (int)socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        return -1;
+    }
+
+    if (option && (tcpclient_set_option(cli, option) < 0)) {
+        tcpclient_close(cli);
+        return -1;
+    }
+
+    memset((char*)&(cli->server_addr), 0, sizeof(cli->sock_addr_size));
+    cli->server_addr.sin_family = AF_INET;
+    cli->server_addr.sin_port = htons(port_num);
+
+    if (!strcmp(ip_str, "localhost")) {
+        ip_str = "127.0.0.1";
+    }
+
+    /* bind is not required, and port number is dynamic */
+    if ((cli->server_addr.sin_addr.s_addr = inet_addr(ip_str)) == INADDR_NONE) {
+        return -1;
+    }
+
+#if defined(URG_WINDOWS_OS)
+    // \~japanese ノンブロックに変更
+    // \~english Configures non-blocking mode
+    flag = 1;
+    ioctlsocket(cli->sock_desc, FIONBIO, &flag);
+
+    if (connect(cli->sock_desc, (const struct sockaddr *)&(cli->server_addr),
+                cli->sock_addr_size) == SOCKET_ERROR) {
+        int error_number = WSAGetLastError();
+        if (error_number != WSAEWOULDBLOCK) {
+            tcpclient_close(cli);
+            return -1;
+        }
+
+        FD_ZERO(&rmask);
+        FD_SET((SOCKET)cli->sock_desc, &rmask);
+        wmask = rmask;
+
+        ret = select((int)cli->sock_desc + 1, &rmask, &wmask, NULL, &tv);
+        if (ret == 0) {
+            // \~japanese タイムアウト
+	    // \~english Operation timed out
+            tcpclient_close(cli);
+            return -2;
+        }
+    }
+    // \~japanese ブロックモードにする
+    // \~english Returns to blocking mode
+    set_block_mode(cli);
+
+#else
+    // \~japanese ノンブロックに変更
+    // \~english Configures non-blocking mode
+    flag = fcntl(cli->sock_desc, F_GETFL, 0);
+    fcntl(cli->sock_desc, F_SETFL, flag | O_NONBLOCK);
+
+    if (connect(cli->sock_desc, (const struct sockaddr *)&(cli->server_addr),
+                cli->sock_addr_size) < 0) {
+        if (errno != EINPROGRESS) {
+            tcpclient_close(cli);
+            return -1;
+        }
+
+        // \~japanese EINPROGRESS:コネクション要求は始まったが、まだ完了していない
+        // \~english EINPROGRESS: a connection request was already received and not completed yet
+        FD_ZERO(&rmask);
+        FD_SET(cli->sock_desc, &rmask);
+        wmask = rmask;
+
+        ret = select(cli->sock_desc + 1, &rmask, &wmask, NULL, &tv);
+        if (ret <= 0) {
+            // \~japanese タイムアウト処理
+	    // \~english Operation timed out
+            tcpclient_close(cli);
+            return -2;
+        }
+
+        if (getsockopt(cli->sock_desc, SOL_SOCKET, SO_ERROR, (int*)&sock_optval,
+                       (socklen_t*)&sock_optval_size) != 0) {
+            // \~japanese 接続に失敗
+	    // \~english Connection failed
+            tcpclient_close(cli);
+            return -3;
+        }
+
+        if (sock_optval != 0) {
+            // \~japanese 接続に失敗
+	    // \~english Connection failed
+            tcpclient_close(cli);
+            return -4;
+        }
+        // \~japanese ブロックモードにする
+        // \~english Returns to blocking mode
+        set_block_mode(cli);
+    }
+#endif
+
+    return 0;
+}
+
+
+void tcpclient_close(urg_tcpclient_t* cli)
+{
+    if (cli->sock_desc != Invalid_desc) {
+#if defined(URG_WINDOWS_OS)
+        closesocket(cli->sock_desc);
+        //WSACleanup();
+#else
+        close(cli->sock_desc);
+#endif
+        cli->sock_desc = Invalid_desc;
+    }
+}
+
+
+void tcpclient_set_buffer(urg_tcpclient_t* cli,
+                          char* buffer, int shift_length)
+{
+    ring_initialize(&cli->rb, buffer, shift_length);
+}
+
+
+int tcpclient_read(urg_tcpclient_t* cli,
+                   char* userbuf, int req_size, int timeout)
+{
+    long deadline = connection_ticks() + timeout;
+
+    // copy data in buffer to user buffer first.
+    int filled = tcpclient_buffer_read(cli, userbuf, req_size);
+
+    // then receive the lacking size until the deadline.
+    while (filled < req_size) {
+        int wait_msec = tcpclient_remaining(deadline, timeout);
+        if (tcpclient_buffer_fill(cli, req_size - filled, wait_msec) <= 0) {
+            break;
+        }
+        filled += tcpclient_buffer_read(cli, &userbuf[filled],
+                                        req_size - filled);
+    }
+
+    return filled; // may be less than req_size on time out.
+}
+
+
+int tcpclient_write(urg_tcpclient_t* cli, const char* buf, int size)
+{
+    // blocking if data size is larger than system's buffer.
+    return send(cli->sock_desc, buf, size, 0);  //4th arg 0: no flag
+}
+
+
+int tcpclient_error(urg_tcpclient_t* cli, char* error_message, int max_size)
+{
+    (void)cli;
+    (void)error_message;
+    (void)max_size;
+
+    // not implemented yet.
+
+    return -1;
+}
+
+
+int tcpclient_fill(urg_tcpclient_t* cli, int size, int timeout)
+{
+    return tcpclient_buffer_fill(cli, size, timeout);
+}
+
+
+int tcpclient_readline(urg_tcpclient_t* cli,
+                       char* userbuf, int buf_size, int timeout)
+{
+    tcpclient_readline_t context;
+
+    context.cli = cli;
+    context.deadline = connection_ticks() + timeout;
+    return ring_readline(&cli->rb, userbuf, buf_size,
+                         tcpclient_readline_fill, &context, timeout);
+}
@@ -3,8 +3,8 @@
   \brief Plotter (SDL)
 
   \~japanese
-  \todo glDrawElements() g悤ɏC
-  \todo MAX_POINTS  1081 ̐ZT̏ŏ
+  \todo glDrawElements() を使うように修正する
+  \todo MAX_POINTS の 1081 の数をセンサからの情報で初期化する
   \~english
   \todo Fix the code to use glDrawElements()
   \todo Use the sensor information instead of MAX_POINTS
@@ -173,7 +173,7 @@ bool plotter_initialize(int data_size)
         return false;
     }
 
-    // \~japanese ʂ̍쐬
+    // \~japanese 画面の作成
     // \~english Prepares the display screeen
     opengl_initialize();
     screen_ = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, 0, SDL_OPENGL);
@@ -182,7 +182,7 @@ bool plotter_initialize(int data_size)
     }
     opengl_setup();
 
-    // \~japanese `ݒ
+    // \~japanese 描画設定
     // \~english Prepares for drawing
     glPointSize(2.0);
 #if defined(USE_GL_2)
@@ -190,7 +190,7 @@ bool plotter_initialize(int data_size)
 #endif
     enter2D();
 
-    // \~japanese f[^̊m
+    // \~japanese データの確保
     // \~english Reserves data
 
     return true;
@@ -212,7 +212,7 @@ void plotter_clear(void)
 
 void plotter_swap(void)
 {
-    // \~japanese \ꊷƂɁA܂`悵ĂȂe`悷
+    // \~japanese 表示を入れ換えるときに、まだ描画していない内容を描画する
     // \~english Before swapping buffers, finish any pending drawing
     draw_points();
 
@@ -222,7 +222,7 @@ void plotter_swap(void)
 
 void plotter_set_color(unsigned char r, unsigned g, unsigned b)
 {
-    // \~japanese FύXƂɁA܂Ƃ߂ĕ`s
+    // \~japanese 色を変更するときに、まとめて描画を行う
     // \~english Before changing color, finish any pending drawing
     draw_points();
 
@@ -278,7 +278,7 @@ bool plotter_is_quit(void)
         }
     }
 
-    // \~japanese `̊g嗦ύX
+    // \~japanese 描画の拡大率を変更する
     // \~english Changes the zooming rate
     while (magnify < 0) {
         draw_magnify_ *= 0.90;
@@ -137,7 +137,7 @@ static void plot_data(urg_t *urg,
 {
     plotter_clear();
 
-    // \~japanese 
+    // \~japanese 距離
     plotter_set_color(0x00, 0xff, 0xff);
     plot_data_point(urg, data, NULL, data_n, is_multiecho, 0);
 
@@ -150,7 +150,7 @@ static void plot_data(urg_t *urg,
     }
 
     if (intensity) {
-        // \~japanese  x
+        // \~japanese  強度
         plotter_set_color(0xff, 0xff, 0x00);
         plot_data_point(urg, NULL, intensity, data_n, is_multiecho, 0);
 
@@ -178,11 +178,11 @@ int main(int argc, char *argv[])
     int data_size;
 
 
-    // \~japanese  ̉
+    // \~japanese  引数の解析
     // \~english Analyzes the arguments
     parse_args(&mode, argc, argv);
 
-    // \~japanese  URG ɐڑ
+    // \~japanese  URG に接続
     // \~english Connects to the URG
     if (urg_open(&urg, mode.connection_type,
                  mode.device, mode.baudrate_or_port)) {
@@ -190,7 +190,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // \~japanese  f[^擾̏
+    // \~japanese  データ取得の準備
     // \~english Prepares for measuremment data reading
     data_size = urg_max_data_size(&urg);
     if (mode.is_multiecho) {
@@ -201,13 +201,13 @@ int main(int argc, char *argv[])
         intensity = malloc(data_size * sizeof(intensity[0]));
     }
 
-    // \~japanese  ʂ̍쐬
+    // \~japanese  画面の作成
     // \~english Perpares the plot screen
     if (!plotter_initialize(data_size * ((mode.is_intensity) ? 2 : 1))) {
         return 1;
     }
 
-    // \~japanese  f[^̎擾ƕ`
+    // \~japanese  データの取得と描画
     // \~english Gets and displays measurement data
     urg_start_measurement(&urg, mode.measurement_type, URG_SCAN_INFINITY, 0);
     while (1) {
@@ -249,7 +249,7 @@ int main(int argc, char *argv[])
         }
     }
 
-    // \~japanese  \[X̉
+    // \~japanese  リソースの解放
     // \~english Release resources
     plotter_terminate();
     free(intensity);
@@ -6,15 +6,18 @@ CALL vsvars32.bat
 
 REM Compile URG library
 
+cl.exe -c -MD -I../include/c ../src/urg_scip_decoder.c
 cl.exe -c -MD -I../include/c ../src/urg_sensor.c
 cl.exe -c -MD -I../include/c ../src/urg_utils.c
 cl.exe -c -MD -I../include/c ../src/urg_connection.c
+cl.exe -c -MD -I../include/c ../src/urg_memory.c
 cl.exe -c -MD -I../include/c ../src/urg_serial.c
 cl.exe -c -MD -I../include/c ../src/urg_serial_utils.c
 cl.exe -c -MD -I../include/c ../src/urg_tcpclient.c
 cl.exe -c -MD -I../include/c ../src/urg_ring_buffer.c
 cl.exe -c -MD -I../include/c ../src/urg_debug.c
-lib.exe /OUT:urg.lib urg_sensor.obj urg_utils.obj urg_connection.obj urg_serial.obj urg_serial_utils.obj urg_tcpclient.obj urg_ring_buffer.obj urg_debug.obj
+cl.exe -c -MD -I../include/c ../src/urg_cache.c
+lib.exe /OUT:urg.lib urg_sensor.obj urg_utils.obj urg_connection.obj urg_serial.obj urg_serial_utils.obj urg_tcpclient.obj urg_ring_buffer.obj urg_debug.obj urg_memory.obj urg_scip_decoder.obj urg_cache.obj
 cl.exe /EHsc -c -MD -I../include/cpp ../src/ticks.cpp
 cl.exe /EHsc -c -MD -I../include/cpp -I../include/c ../src/Urg_driver.cpp
 lib.exe /OUT:urg_cpp.lib ticks.obj Urg_driver.obj urg.lib
@@ -34,6 +37,8 @@ cl.exe /MD -I../include/c ../samples/c/get_multiecho_intensity.c open_urg_sensor
 
 cl.exe /MD -I../include/c ../samples/c/find_port.c open_urg_sensor.obj ws2_32.lib setupapi.lib urg.lib
 
+cl.exe /MD -I../include/c ../samples/c/replay_recorded.c ws2_32.lib setupapi.lib urg.lib
+
 cl.exe /MD -I../include/c ../samples/c/get_distance.c open_urg_sensor.obj ws2_32.lib setupapi.lib urg.lib
 
 cl.exe /MD -I../include/c ../samples/c/get_distance_intensity.c open_urg_sensor.obj ws2_32.lib setupapi.lib urg.lib